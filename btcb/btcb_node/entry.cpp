@@ -6,9 +6,38 @@
 
 #include <argon2.h>
 
+#include <blake2/blake2.h>
+
 #include <boost/lexical_cast.hpp>
 #include <boost/program_options.hpp>
 
+namespace
+{
+// The previous account encoder, which went through a 512 bit multiprecision number, kept for comparison by debug_profile_accounts
+std::string encode_account_multiprecision (btcb::account const & account_a)
+{
+	std::string result;
+	result.reserve (btcb::account_text_size);
+	uint64_t check (0);
+	blake2b_state hash;
+	blake2b_init (&hash, 5);
+	blake2b_update (&hash, account_a.bytes.data (), account_a.bytes.size ());
+	blake2b_final (&hash, reinterpret_cast<uint8_t *> (&check), 5);
+	btcb::uint512_t number_l (account_a.number ());
+	number_l <<= 40;
+	number_l |= btcb::uint512_t (check);
+	for (auto i (0); i < 60; ++i)
+	{
+		uint8_t r (number_l & static_cast<uint8_t> (0x1f));
+		number_l >>= 5;
+		result.push_back ("13456789abcdefghijkmnopqrstuwxyz"[r]);
+	}
+	result.append ("_bcb");
+	std::reverse (result.begin (), result.end ());
+	return result;
+}
+}
+
 int main (int argc, char * const * argv)
 {
 	btcb::set_umask ();
@@ -34,12 +63,13 @@ int main (int argc, char * const * argv)
 		("debug_opencl", "OpenCL work generation")
 		("debug_profile_verify", "Profile work verification")
 		("debug_profile_kdf", "Profile kdf function")
+		("debug_profile_accounts", "Profile account encoding and decoding")
 		("debug_verify_profile", "Profile signature verification")
 		("debug_verify_profile_batch", "Profile batch signature verification")
 		("debug_profile_bootstrap", "Profile bootstrap style blocks processing (at least 10GB of free storage space required)")
 		("debug_profile_sign", "Profile signature generation")
 		("debug_profile_process", "Profile active blocks processing (only for btcb_test_network)")
-		("debug_profile_votes", "Profile votes processing (only for btcb_test_network)")
+		("debug_profile_votes", "Profile votes processing on one thread and on the default vote processor threads (only for btcb_test_network)")
 		("debug_validate_blocks", "Check all blocks for correct hash, signature, work value")
 		("platform", boost::program_options::value<std::string> (), "Defines the <platform> for OpenCL commands")
 		("device", boost::program_options::value<std::string> (), "Defines <device> for OpenCL command")
@@ -201,10 +231,69 @@ int main (int argc, char * const * argv)
 				std::cerr << boost::str (boost::format ("Derivation time: %1%us\n") % std::chrono::duration_cast<std::chrono::microseconds> (end1 - begin1).count ());
 			}
 		}
+		else if (vm.count ("debug_profile_accounts"))
+		{
+			size_t const count (1000000);
+			std::vector<btcb::account> accounts (count);
+			btcb::random_pool.GenerateBlock (accounts.data ()->bytes.data (), accounts.size () * sizeof (btcb::account));
+			std::vector<std::string> texts (count);
+			auto begin1 (std::chrono::high_resolution_clock::now ());
+			for (size_t i (0); i < count; ++i)
+			{
+				texts[i] = encode_account_multiprecision (accounts[i]);
+			}
+			auto end1 (std::chrono::high_resolution_clock::now ());
+			for (size_t i (0); i < count; ++i)
+			{
+				texts[i] = accounts[i].to_account ();
+			}
+			auto end2 (std::chrono::high_resolution_clock::now ());
+			std::string buffer (count * btcb::account_text_size, '\0');
+			btcb::encode_accounts (accounts.data (), count, &buffer[0]);
+			auto end3 (std::chrono::high_resolution_clock::now ());
+			auto errors (0);
+			for (size_t i (0); i < count; ++i)
+			{
+				btcb::account decoded;
+				errors += decoded.decode_account (texts[i]) || decoded != accounts[i] || texts[i] != encode_account_multiprecision (accounts[i]) || buffer.compare (i * btcb::account_text_size, btcb::account_text_size, texts[i]) != 0;
+			}
+			auto begin4 (std::chrono::high_resolution_clock::now ());
+			for (size_t i (0); i < count; ++i)
+			{
+				btcb::account decoded;
+				decoded.decode_account (texts[i]);
+			}
+			auto end4 (std::chrono::high_resolution_clock::now ());
+			std::cerr << boost::str (boost::format ("%1% accounts, %2% mismatches\n") % count % errors);
+			std::cerr << boost::str (boost::format ("Multiprecision encode: %1%us\n") % std::chrono::duration_cast<std::chrono::microseconds> (end1 - begin1).count ());
+			std::cerr << boost::str (boost::format ("to_account: %1%us\n") % std::chrono::duration_cast<std::chrono::microseconds> (end2 - end1).count ());
+			std::cerr << boost::str (boost::format ("encode_accounts: %1%us\n") % std::chrono::duration_cast<std::chrono::microseconds> (end3 - end2).count ());
+			std::cerr << boost::str (boost::format ("decode_account: %1%us\n") % std::chrono::duration_cast<std::chrono::microseconds> (end4 - begin4).count ());
+		}
 		else if (vm.count ("debug_profile_generate"))
 		{
 			btcb::work_pool work (std::numeric_limits<unsigned>::max (), nullptr);
 			btcb::change_block block (0, 0, btcb::keypair ().prv, 0, 0);
+			std::cerr << boost::str (boost::format ("Using %1% work kernel\n") % btcb::work_kernel_name (btcb::work_kernel_best ()));
+			for (auto kernel : { btcb::work_kernel::scalar, btcb::work_kernel::avx2 })
+			{
+				if (btcb::work_kernel_supported (kernel))
+				{
+					std::array<uint64_t, btcb::work_lanes> nonces;
+					std::array<uint64_t, btcb::work_lanes> values;
+					nonces.fill (0);
+					size_t const calls (1024 * 1024);
+					auto begin1 (std::chrono::high_resolution_clock::now ());
+					for (size_t i (0); i < calls; ++i)
+					{
+						nonces[0] = i;
+						btcb::work_values (kernel, block.root (), nonces.data (), values.data ());
+					}
+					auto end1 (std::chrono::high_resolution_clock::now ());
+					auto us (std::max<int64_t> (1, std::chrono::duration_cast<std::chrono::microseconds> (end1 - begin1).count ()));
+					std::cerr << boost::str (boost::format ("%1% kernel: %2% hashes/s on one thread\n") % btcb::work_kernel_name (kernel) % (calls * btcb::work_lanes * 1000000 / us));
+				}
+			}
 			std::cerr << "Starting generation profiling\n";
 			while (true)
 			{
@@ -344,20 +433,50 @@ int main (int argc, char * const * argv)
 		}
 		else if (vm.count ("debug_verify_profile_batch"))
 		{
-			btcb::keypair key;
+			// Distinct keys and messages, as in a batch of votes or blocks from the network
 			size_t batch_count (1000);
-			btcb::uint256_union message;
-			btcb::uint512_union signature (btcb::sign_message (key.prv, key.pub, message));
-			std::vector<unsigned char const *> messages (batch_count, message.bytes.data ());
-			std::vector<size_t> lengths (batch_count, sizeof (message));
-			std::vector<unsigned char const *> pub_keys (batch_count, key.pub.bytes.data ());
-			std::vector<unsigned char const *> signatures (batch_count, signature.bytes.data ());
+			std::vector<btcb::keypair> keys (batch_count);
+			std::vector<btcb::uint256_union> message_values (batch_count);
+			std::vector<btcb::uint512_union> signature_values;
+			std::vector<unsigned char const *> messages;
+			std::vector<size_t> lengths (batch_count, sizeof (btcb::uint256_union));
+			std::vector<unsigned char const *> pub_keys;
+			std::vector<unsigned char const *> signatures;
+			signature_values.reserve (batch_count);
+			for (size_t i (0); i < batch_count; ++i)
+			{
+				btcb::random_pool.GenerateBlock (message_values[i].bytes.data (), message_values[i].bytes.size ());
+				signature_values.push_back (btcb::sign_message (keys[i].prv, keys[i].pub, message_values[i]));
+				messages.push_back (message_values[i].bytes.data ());
+				pub_keys.push_back (keys[i].pub.bytes.data ());
+				signatures.push_back (signature_values[i].bytes.data ());
+			}
 			std::vector<int> verifications;
 			verifications.resize (batch_count);
-			auto begin (std::chrono::high_resolution_clock::now ());
-			btcb::validate_message_batch (messages.data (), lengths.data (), pub_keys.data (), signatures.data (), batch_count, verifications.data ());
-			auto end (std::chrono::high_resolution_clock::now ());
-			std::cerr << "Batch signature verifications " << std::chrono::duration_cast<std::chrono::microseconds> (end - begin).count () << std::endl;
+			auto begin1 (std::chrono::high_resolution_clock::now ());
+			for (size_t i (0); i < batch_count; ++i)
+			{
+				btcb::validate_message (keys[i].pub, message_values[i], signature_values[i]);
+			}
+			auto end1 (std::chrono::high_resolution_clock::now ());
+			auto single (std::chrono::duration_cast<std::chrono::microseconds> (end1 - begin1).count ());
+			std::cerr << boost::str (boost::format ("%1% signatures verified one at a time in %2% us (%3% us each)\n") % batch_count % single % (single / batch_count));
+			std::cerr << "Default batch backend: " << btcb::signature_backend_name (btcb::signature_backend_best ()) << std::endl;
+			for (auto backend : { btcb::signature_backend::donna, btcb::signature_backend::donna_ifma })
+			{
+				if (btcb::signature_backend_supported (backend))
+				{
+					auto begin2 (std::chrono::high_resolution_clock::now ());
+					btcb::validate_message_batch (backend, messages.data (), lengths.data (), pub_keys.data (), signatures.data (), batch_count, verifications.data ());
+					auto end2 (std::chrono::high_resolution_clock::now ());
+					auto batch (std::chrono::duration_cast<std::chrono::microseconds> (end2 - begin2).count ());
+					std::cerr << boost::str (boost::format ("%1% signatures verified as a batch with %2% in %3% us (%4% us each)\n") % batch_count % btcb::signature_backend_name (backend) % batch % (batch / batch_count));
+				}
+				else
+				{
+					std::cerr << boost::str (boost::format ("Backend %1% not supported\n") % btcb::signature_backend_name (backend));
+				}
+			}
 		}
 		else if (vm.count ("debug_profile_sign"))
 		{
@@ -461,29 +580,25 @@ int main (int argc, char * const * argv)
 				size_t max_votes (num_elections * num_representatives); // 40,000 * 25 = 1,000,000 votes
 				std::cerr << boost::str (boost::format ("Starting pregenerating %1% votes\n") % max_votes);
 				btcb::system system (24000, 1);
-				btcb::node_init init;
 				btcb::work_pool work (std::numeric_limits<unsigned>::max (), nullptr);
 				btcb::logging logging;
-				auto path (btcb::unique_path ());
-				logging.init (path);
-				auto node (std::make_shared<btcb::node> (init, system.io_ctx, 24001, path, system.alarm, logging, work));
-				btcb::block_hash genesis_latest (node->latest (btcb::test_genesis_key.pub));
+				btcb::node_config config (24001, logging);
+				btcb::block_hash genesis_latest (btcb::genesis ().hash ());
 				btcb::uint128_t genesis_balance (std::numeric_limits<btcb::uint128_t>::max ());
 				// Generating keys
 				std::vector<btcb::keypair> keys (num_representatives);
-				btcb::uint128_t balance ((node->config.online_weight_minimum.number () / num_representatives) + 1);
+				std::vector<std::shared_ptr<btcb::block>> representative_blocks;
+				btcb::uint128_t balance ((config.online_weight_minimum.number () / num_representatives) + 1);
 				for (auto i (0); i != num_representatives; ++i)
 				{
-					auto transaction (node->store.tx_begin_write ());
 					genesis_balance = genesis_balance - balance;
-					btcb::state_block send (btcb::test_genesis_key.pub, genesis_latest, btcb::test_genesis_key.pub, genesis_balance, keys[i].pub, btcb::test_genesis_key.prv, btcb::test_genesis_key.pub, work.generate (genesis_latest));
-					genesis_latest = send.hash ();
-					node->ledger.process (transaction, send);
-					btcb::state_block open (keys[i].pub, 0, keys[i].pub, balance, genesis_latest, keys[i].prv, keys[i].pub, work.generate (keys[i].pub));
-					node->ledger.process (transaction, open);
+					auto send (std::make_shared<btcb::state_block> (btcb::test_genesis_key.pub, genesis_latest, btcb::test_genesis_key.pub, genesis_balance, keys[i].pub, btcb::test_genesis_key.prv, btcb::test_genesis_key.pub, work.generate (genesis_latest)));
+					genesis_latest = send->hash ();
+					representative_blocks.push_back (send);
+					representative_blocks.push_back (std::make_shared<btcb::state_block> (keys[i].pub, 0, keys[i].pub, balance, genesis_latest, keys[i].prv, keys[i].pub, work.generate (keys[i].pub)));
 				}
 				// Generating blocks
-				std::deque<std::shared_ptr<btcb::block>> blocks;
+				std::vector<std::shared_ptr<btcb::block>> blocks;
 				for (auto i (0); i != num_elections; ++i)
 				{
 					genesis_balance = genesis_balance - 1;
@@ -493,7 +608,7 @@ int main (int argc, char * const * argv)
 					blocks.push_back (send);
 				}
 				// Generating votes
-				std::deque<std::shared_ptr<btcb::vote>> votes;
+				std::vector<std::shared_ptr<btcb::vote>> votes;
 				for (auto j (0); j != num_representatives; ++j)
 				{
 					uint64_t sequence (1);
@@ -504,31 +619,49 @@ int main (int argc, char * const * argv)
 						sequence++;
 					}
 				}
-				// Processing block & start elections
-				while (!blocks.empty ())
+				// Compare applying votes on a single thread against the configured number of vote processor threads
+				std::vector<unsigned> thread_counts{ 1 };
+				if (config.vote_processor_threads > 1)
 				{
-					auto block (blocks.front ());
-					node->process_active (block);
-					blocks.pop_front ();
+					thread_counts.push_back (config.vote_processor_threads);
 				}
-				node->block_processor.flush ();
-				// Processing votes
-				std::cerr << boost::str (boost::format ("Starting processing %1% votes\n") % max_votes);
-				auto begin (std::chrono::high_resolution_clock::now ());
-				while (!votes.empty ())
+				for (auto threads : thread_counts)
 				{
-					auto vote (votes.front ());
-					node->vote_processor.vote (vote, node->network.endpoint ());
-					votes.pop_front ();
-				}
-				while (!node->active.roots.empty ())
-				{
-					std::this_thread::sleep_for (std::chrono::milliseconds (100));
+					btcb::node_init init;
+					auto path (btcb::unique_path ());
+					config.logging.init (path);
+					config.vote_processor_threads = threads;
+					auto node (std::make_shared<btcb::node> (init, system.io_ctx, path, system.alarm, config, work));
+					{
+						auto transaction (node->store.tx_begin_write ());
+						for (auto & i : representative_blocks)
+						{
+							node->ledger.process (transaction, *i);
+						}
+					}
+					// Processing block & start elections
+					for (auto & i : blocks)
+					{
+						node->process_active (i);
+					}
+					node->block_processor.flush ();
+					// Processing votes
+					std::cerr << boost::str (boost::format ("Starting processing %1% votes on %2% threads\n") % max_votes % threads);
+					auto begin (std::chrono::high_resolution_clock::now ());
+					for (auto & i : votes)
+					{
+						node->vote_processor.vote (i, node->network.endpoint ());
+					}
+					while (!node->active.roots.empty ())
+					{
+						std::this_thread::sleep_for (std::chrono::milliseconds (100));
+					}
+					auto end (std::chrono::high_resolution_clock::now ());
+					auto time (std::chrono::duration_cast<std::chrono::microseconds> (end - begin).count ());
+					node->stop ();
+					std::cerr << boost::str (boost::format ("%|1$ 12d| us \n%2% votes per second\n") % time % (max_votes * 1000000 / time));
+					std::cerr << boost::str (boost::format ("%1% contended active locks, %2% contended election shard locks\n") % node->stats.count (btcb::stat::type::active, btcb::stat::detail::lock_contended) % node->stats.count (btcb::stat::type::active, btcb::stat::detail::shard_contended));
 				}
-				auto end (std::chrono::high_resolution_clock::now ());
-				auto time (std::chrono::duration_cast<std::chrono::microseconds> (end - begin).count ());
-				node->stop ();
-				std::cerr << boost::str (boost::format ("%|1$ 12d| us \n%2% votes per second\n") % time % (max_votes * 1000000 / time));
 			}
 			else
 			{
@@ -703,7 +836,7 @@ int main (int argc, char * const * argv)
 				block_count_2 = node2.node->store.block_count (transaction_2).sum ();
 				if ((count % 60) == 0)
 				{
-					std::cout << boost::str (boost::format ("%1% (%2%) blocks processed") % block_count_2 % node2.node->store.unchecked_count (transaction_2)) << std::endl;
+					std::cout << boost::str (boost::format ("%1% (%2%) blocks processed") % block_count_2 % node2.node->unchecked.count (transaction_2)) << std::endl;
 				}
 				count++;
 			}
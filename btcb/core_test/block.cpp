@@ -25,6 +25,61 @@ TEST (ed25519, signing)
 	ASSERT_NE (0, valid2);
 }
 
+TEST (ed25519, backends)
+{
+	// More than one group of eight, with a short group at the end
+	size_t const count (19);
+	std::vector<btcb::keypair> keys (count);
+	std::vector<btcb::uint256_union> messages;
+	std::vector<btcb::uint512_union> signatures;
+	for (size_t i (0); i < count; ++i)
+	{
+		messages.push_back (btcb::uint256_union (i));
+		signatures.push_back (btcb::sign_message (keys[i].prv, keys[i].pub, messages[i]));
+	}
+	std::vector<btcb::public_key> pub_keys_l;
+	for (auto & key : keys)
+	{
+		pub_keys_l.push_back (key.pub);
+	}
+	// Wrong S, wrong R, S with its top bits set and a public key that isn't a point
+	signatures[1].bytes[32] ^= 0x1;
+	signatures[9].bytes[0] ^= 0x1;
+	signatures[12].bytes[63] |= 0x80;
+	pub_keys_l[17].bytes.fill (0xff);
+	std::vector<unsigned char const *> messages_l;
+	std::vector<size_t> lengths (count, sizeof (btcb::uint256_union));
+	std::vector<unsigned char const *> pub_keys;
+	std::vector<unsigned char const *> signatures_l;
+	std::vector<int> expected;
+	for (size_t i (0); i < count; ++i)
+	{
+		messages_l.push_back (messages[i].bytes.data ());
+		pub_keys.push_back (pub_keys_l[i].bytes.data ());
+		signatures_l.push_back (signatures[i].bytes.data ());
+		expected.push_back (btcb::validate_message (pub_keys_l[i], messages[i], signatures[i]) ? 0 : 1);
+	}
+	ASSERT_EQ (0, expected[1]);
+	ASSERT_EQ (0, expected[9]);
+	ASSERT_EQ (0, expected[12]);
+	ASSERT_EQ (0, expected[17]);
+	ASSERT_TRUE (btcb::signature_backend_supported (btcb::signature_backend::donna));
+	ASSERT_TRUE (btcb::signature_backend_supported (btcb::signature_backend_best ()));
+	for (auto backend : { btcb::signature_backend::donna, btcb::signature_backend::donna_ifma })
+	{
+		if (btcb::signature_backend_supported (backend))
+		{
+			std::vector<int> verifications (count, -1);
+			ASSERT_FALSE (btcb::validate_message_batch (backend, messages_l.data (), lengths.data (), pub_keys.data (), signatures_l.data (), count, verifications.data ()));
+			ASSERT_EQ (expected, verifications);
+			// Signatures 2 to 8 are all valid
+			std::vector<int> verifications2 (7, -1);
+			ASSERT_TRUE (btcb::validate_message_batch (backend, messages_l.data () + 2, lengths.data () + 2, pub_keys.data () + 2, signatures_l.data () + 2, 7, verifications2.data ()));
+			ASSERT_EQ (std::vector<int> (7, 1), verifications2);
+		}
+	}
+}
+
 TEST (transaction_block, empty)
 {
 	btcb::keypair key1;
@@ -390,25 +445,94 @@ TEST (state_block, hashing)
 	btcb::state_block block (key.pub, 0, key.pub, 0, 0, key.prv, key.pub, 0);
 	auto hash (block.hash ());
 	block.hashables.account.bytes[0] ^= 0x1;
+	block.refresh ();
 	ASSERT_NE (hash, block.hash ());
 	block.hashables.account.bytes[0] ^= 0x1;
+	block.refresh ();
 	ASSERT_EQ (hash, block.hash ());
 	block.hashables.previous.bytes[0] ^= 0x1;
+	block.refresh ();
 	ASSERT_NE (hash, block.hash ());
 	block.hashables.previous.bytes[0] ^= 0x1;
+	block.refresh ();
 	ASSERT_EQ (hash, block.hash ());
 	block.hashables.representative.bytes[0] ^= 0x1;
+	block.refresh ();
 	ASSERT_NE (hash, block.hash ());
 	block.hashables.representative.bytes[0] ^= 0x1;
+	block.refresh ();
 	ASSERT_EQ (hash, block.hash ());
 	block.hashables.balance.bytes[0] ^= 0x1;
+	block.refresh ();
 	ASSERT_NE (hash, block.hash ());
 	block.hashables.balance.bytes[0] ^= 0x1;
+	block.refresh ();
 	ASSERT_EQ (hash, block.hash ());
 	block.hashables.link.bytes[0] ^= 0x1;
+	block.refresh ();
 	ASSERT_NE (hash, block.hash ());
 	block.hashables.link.bytes[0] ^= 0x1;
+	block.refresh ();
+	ASSERT_EQ (hash, block.hash ());
+}
+
+TEST (block, hash_cache)
+{
+	btcb::keypair key;
+	btcb::state_block block (key.pub, 0, key.pub, 0, 0, key.prv, key.pub, 0);
+	auto hash (block.hash ());
+	auto full_hash (block.full_hash ());
 	ASSERT_EQ (hash, block.hash ());
+	ASSERT_EQ (full_hash, block.full_hash ());
+	block.block_work_set (1);
+	ASSERT_EQ (hash, block.hash ());
+	ASSERT_NE (full_hash, block.full_hash ());
+	block.block_work_set (0);
+	ASSERT_EQ (full_hash, block.full_hash ());
+	auto signature (block.block_signature ());
+	signature.bytes[0] ^= 0x1;
+	block.signature_set (signature);
+	ASSERT_NE (full_hash, block.full_hash ());
+	block.hashables.balance = 1;
+	ASSERT_EQ (hash, block.hash ());
+	block.refresh ();
+	ASSERT_NE (hash, block.hash ());
+	// Copies recompute rather than share the cached values
+	btcb::state_block copy (block);
+	copy.hashables.balance = 0;
+	ASSERT_EQ (hash, copy.hash ());
+	ASSERT_NE (hash, block.hash ());
+	std::vector<uint8_t> bytes;
+	{
+		btcb::vectorstream stream (bytes);
+		copy.serialize (stream);
+	}
+	btcb::bufferstream stream (bytes.data (), bytes.size ());
+	ASSERT_FALSE (block.deserialize (stream));
+	ASSERT_EQ (hash, block.hash ());
+	ASSERT_EQ (copy.full_hash (), block.full_hash ());
+}
+
+TEST (block, block_size)
+{
+	btcb::keypair key;
+	std::vector<std::shared_ptr<btcb::block>> blocks;
+	blocks.push_back (std::make_shared<btcb::send_block> (0, 1, 2, key.prv, key.pub, 3));
+	blocks.push_back (std::make_shared<btcb::receive_block> (0, 1, key.prv, key.pub, 3));
+	blocks.push_back (std::make_shared<btcb::open_block> (0, 1, 2, key.prv, key.pub, 3));
+	blocks.push_back (std::make_shared<btcb::change_block> (0, 1, key.prv, key.pub, 3));
+	blocks.push_back (std::make_shared<btcb::state_block> (key.pub, 0, key.pub, 0, 0, key.prv, key.pub, 0));
+	for (auto & block : blocks)
+	{
+		std::vector<uint8_t> bytes;
+		{
+			btcb::vectorstream stream (bytes);
+			btcb::serialize_block (stream, *block);
+		}
+		ASSERT_EQ (bytes.size (), 1 + btcb::block_size (block->type ()));
+	}
+	ASSERT_EQ (0, btcb::block_size (btcb::block_type::not_a_block));
+	ASSERT_EQ (0, btcb::block_size (btcb::block_type::invalid));
 }
 
 TEST (block_uniquer, null)
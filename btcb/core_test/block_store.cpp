@@ -4,6 +4,8 @@
 #include <btcb/node/node.hpp>
 #include <btcb/secure/versioning.hpp>
 
+#include <boost/polymorphic_cast.hpp>
+
 #include <fstream>
 
 TEST (block_store, construction)
@@ -69,6 +71,7 @@ TEST (block_store, add_two_items)
 	ASSERT_EQ (nullptr, latest1);
 	btcb::open_block block2 (0, 1, 3, btcb::keypair ().prv, 0, 0);
 	block2.hashables.account = 3;
+	block2.refresh ();
 	btcb::uint256_union hash2 (block2.hash ());
 	block2.signature = btcb::sign_message (key1.prv, key1.pub, hash2);
 	auto latest2 (store.block_get (transaction, hash2));
@@ -454,6 +457,7 @@ TEST (block_store, two_block)
 	ASSERT_TRUE (!init);
 	btcb::open_block block1 (0, 1, 1, btcb::keypair ().prv, 0, 0);
 	block1.hashables.account = 1;
+	block1.refresh ();
 	std::vector<btcb::block_hash> hashes;
 	std::vector<btcb::open_block> blocks;
 	hashes.push_back (block1.hash ());
@@ -1057,6 +1061,62 @@ TEST (block_store, upgrade_v9_v10)
 	ASSERT_EQ (block_info.balance.number (), btcb::genesis_amount - btcb::Gbcb_ratio * 31);
 }
 
+TEST (block_store, upgrade_v12_v13)
+{
+	auto path (btcb::unique_path ());
+	btcb::genesis genesis;
+	btcb::keypair key1;
+	btcb::state_block block1 (btcb::test_genesis_key.pub, genesis.hash (), btcb::test_genesis_key.pub, btcb::genesis_amount - 100, key1.pub, btcb::test_genesis_key.prv, btcb::test_genesis_key.pub, 0);
+	{
+		bool init (false);
+		btcb::mdb_store store (init, path);
+		ASSERT_FALSE (init);
+		auto transaction (store.tx_begin (true));
+		store.version_put (transaction, 12);
+		// Store the blocks the way a v12 ledger does, one table per type with the successor appended
+		MDB_dbi send_blocks, open_blocks, state_blocks_v1;
+		ASSERT_EQ (0, mdb_dbi_open (store.env.tx (transaction), "send", MDB_CREATE, &send_blocks));
+		ASSERT_EQ (0, mdb_dbi_open (store.env.tx (transaction), "open", MDB_CREATE, &open_blocks));
+		ASSERT_EQ (0, mdb_dbi_open (store.env.tx (transaction), "state_v1", MDB_CREATE, &state_blocks_v1));
+		std::vector<uint8_t> open_value;
+		{
+			btcb::vectorstream stream (open_value);
+			genesis.open->serialize (stream);
+			btcb::write (stream, block1.hash ().bytes);
+		}
+		ASSERT_EQ (0, mdb_put (store.env.tx (transaction), open_blocks, btcb::mdb_val (genesis.hash ()), btcb::mdb_val (open_value.size (), open_value.data ()), 0));
+		std::vector<uint8_t> state_value;
+		{
+			btcb::vectorstream stream (state_value);
+			block1.serialize (stream);
+			btcb::write (stream, btcb::block_hash (0).bytes);
+		}
+		ASSERT_EQ (0, mdb_put (store.env.tx (transaction), state_blocks_v1, btcb::mdb_val (block1.hash ()), btcb::mdb_val (state_value.size (), state_value.data ()), 0));
+	}
+	bool init (false);
+	btcb::mdb_store store (init, path);
+	ASSERT_FALSE (init);
+	auto transaction (store.tx_begin ());
+	ASSERT_LT (12, store.version_get (transaction));
+	auto open (store.block_get (transaction, genesis.hash ()));
+	ASSERT_NE (nullptr, open);
+	ASSERT_EQ (*genesis.open, *open);
+	ASSERT_EQ (block1.hash (), store.block_successor (transaction, genesis.hash ()));
+	auto state (store.block_get (transaction, block1.hash ()));
+	ASSERT_NE (nullptr, state);
+	ASSERT_EQ (block1, *state);
+	ASSERT_EQ (btcb::epoch::epoch_1, store.block_version (transaction, block1.hash ()));
+	ASSERT_TRUE (store.block_exists (transaction, btcb::block_type::state, block1.hash ()));
+	ASSERT_FALSE (store.block_exists (transaction, btcb::block_type::open, block1.hash ()));
+	auto count (store.block_count (transaction));
+	ASSERT_EQ (1, count.open);
+	ASSERT_EQ (1, count.state_v1);
+	ASSERT_EQ (2, count.sum ());
+	// The per-type tables are removed once merged
+	MDB_dbi send_blocks;
+	ASSERT_EQ (MDB_NOTFOUND, mdb_dbi_open (store.env.tx (transaction), "send", 0, &send_blocks));
+}
+
 TEST (block_store, state_block)
 {
 	bool error (false);
@@ -1081,4 +1141,229 @@ TEST (block_store, state_block)
 	auto count2 (store.block_count (transaction));
 	ASSERT_EQ (0, count2.state_v0);
 	ASSERT_EQ (0, count2.state_v1);
+	store.block_put (transaction, block1.hash (), block1, 0, btcb::epoch::epoch_1);
+	ASSERT_EQ (btcb::epoch::epoch_1, store.block_version (transaction, block1.hash ()));
+	auto count3 (store.block_count (transaction));
+	ASSERT_EQ (0, count3.state_v0);
+	ASSERT_EQ (1, count3.state_v1);
+}
+
+TEST (block_store, representation_cache)
+{
+	auto path (btcb::unique_path ());
+	btcb::keypair key1;
+	btcb::keypair key2;
+	{
+		bool init (false);
+		btcb::mdb_store store (init, path);
+		ASSERT_FALSE (init);
+		auto transaction (store.tx_begin (true));
+		store.representation_put (transaction, key1.pub, 100);
+		store.representation_put (transaction, key2.pub, 200);
+		store.representation_put (transaction, key2.pub, 0);
+		ASSERT_EQ (100, store.representation_get (transaction, key1.pub));
+		ASSERT_EQ (0, store.representation_get (transaction, key2.pub));
+	}
+	// Weights are reloaded from the database when the store is reopened
+	bool init (false);
+	btcb::mdb_store store (init, path);
+	ASSERT_FALSE (init);
+	auto transaction (store.tx_begin ());
+	ASSERT_EQ (100, store.representation_get (transaction, key1.pub));
+	ASSERT_EQ (0, store.representation_get (transaction, key2.pub));
+}
+
+TEST (block_store, representation_commit)
+{
+	bool init (false);
+	btcb::mdb_store store (init, btcb::unique_path ());
+	ASSERT_FALSE (init);
+	btcb::keypair key1;
+	{
+		auto transaction (store.tx_begin (true));
+		store.representation_put (transaction, key1.pub, 100);
+		ASSERT_EQ (100, store.representation_get (transaction, key1.pub));
+		// Other transactions see the committed weight until the write transaction commits
+		std::thread ([&store, &key1]() {
+			auto transaction (store.tx_begin_read ());
+			ASSERT_EQ (0, store.representation_get (transaction, key1.pub));
+		})
+		.join ();
+	}
+	auto transaction (store.tx_begin_read ());
+	ASSERT_EQ (100, store.representation_get (transaction, key1.pub));
+}
+
+TEST (block_store, representation_commit_overlap)
+{
+	bool init (false);
+	btcb::mdb_store store (init, btcb::unique_path ());
+	ASSERT_FALSE (init);
+	btcb::keypair key1;
+	btcb::keypair key2;
+	{
+		auto transaction (store.tx_begin (true));
+		// Runs once this transaction has committed but before its weights are published, when LMDB already lets the next writer in
+		boost::polymorphic_downcast<btcb::mdb_txn *> (transaction.impl.get ())->commit_actions.push_back ([&store, &key2]() {
+			{
+				auto transaction (store.tx_begin (true));
+				store.representation_put (transaction, key2.pub, 200);
+				ASSERT_EQ (200, store.representation_get (transaction, key2.pub));
+			}
+			auto transaction (store.tx_begin_read ());
+			ASSERT_EQ (200, store.representation_get (transaction, key2.pub));
+		});
+		store.representation_put (transaction, key1.pub, 100);
+	}
+	auto transaction (store.tx_begin_read ());
+	ASSERT_EQ (100, store.representation_get (transaction, key1.pub));
+	ASSERT_EQ (200, store.representation_get (transaction, key2.pub));
+}
+
+TEST (block_store, upgrade_v13_v14)
+{
+	auto path (btcb::unique_path ());
+	btcb::genesis genesis;
+	{
+		bool init (false);
+		btcb::mdb_store store (init, path);
+		ASSERT_FALSE (init);
+		auto transaction (store.tx_begin (true));
+		store.initialize (transaction, genesis);
+		// A v13 ledger has no delegator index
+		store.version_put (transaction, 13);
+		store.delegator_del (transaction, btcb::genesis_account, btcb::genesis_account);
+		ASSERT_EQ (0, store.delegators_count (transaction, btcb::genesis_account));
+	}
+	bool init (false);
+	btcb::mdb_store store (init, path);
+	ASSERT_FALSE (init);
+	auto transaction (store.tx_begin ());
+	ASSERT_LT (13, store.version_get (transaction));
+	auto delegators (store.delegators_get (transaction, btcb::genesis_account, 0, 10));
+	ASSERT_EQ (1, delegators.size ());
+	ASSERT_EQ (btcb::genesis_account, delegators[0]);
+}
+
+TEST (block_store, upgrade_v14_v15)
+{
+	auto path (btcb::unique_path ());
+	btcb::genesis genesis;
+	btcb::send_block send (genesis.hash (), btcb::test_genesis_key.pub, btcb::genesis_amount - 100, btcb::test_genesis_key.prv, btcb::test_genesis_key.pub, 0);
+	{
+		bool init (false);
+		btcb::mdb_store store (init, path);
+		ASSERT_FALSE (init);
+		btcb::stat stats;
+		btcb::ledger ledger (store, stats);
+		auto transaction (store.tx_begin (true));
+		store.initialize (transaction, genesis);
+		ASSERT_EQ (btcb::process_result::progress, ledger.process (transaction, send).code);
+		// A v14 ledger has no height index
+		store.version_put (transaction, 14);
+		store.account_height_del (transaction, btcb::genesis_account, 1);
+		store.account_height_del (transaction, btcb::genesis_account, 2);
+	}
+	bool init (false);
+	btcb::mdb_store store (init, path);
+	ASSERT_FALSE (init);
+	auto transaction (store.tx_begin ());
+	ASSERT_LT (14, store.version_get (transaction));
+	btcb::block_hash hash;
+	ASSERT_FALSE (store.account_height_get (transaction, btcb::genesis_account, 1, hash));
+	ASSERT_EQ (genesis.hash (), hash);
+	ASSERT_FALSE (store.account_height_get (transaction, btcb::genesis_account, 2, hash));
+	ASSERT_EQ (send.hash (), hash);
+	ASSERT_TRUE (store.account_height_get (transaction, btcb::genesis_account, 3, hash));
+}
+
+TEST (block_store, upgrade_v15_v16)
+{
+	auto path (btcb::unique_path ());
+	btcb::genesis genesis;
+	btcb::send_block send (genesis.hash (), btcb::test_genesis_key.pub, btcb::genesis_amount - 100, btcb::test_genesis_key.prv, btcb::test_genesis_key.pub, 0);
+	{
+		bool init (false);
+		btcb::mdb_store store (init, path);
+		ASSERT_FALSE (init);
+		btcb::stat stats;
+		btcb::ledger ledger (store, stats);
+		auto transaction (store.tx_begin (true));
+		store.initialize (transaction, genesis);
+		ASSERT_EQ (btcb::process_result::progress, ledger.process (transaction, send).code);
+		// A v15 ledger stores only the successor after each block
+		store.block_put (transaction, genesis.hash (), *genesis.open, send.hash ());
+		store.block_put (transaction, send.hash (), send);
+		store.version_put (transaction, 15);
+	}
+	bool init (false);
+	btcb::mdb_store store (init, path);
+	ASSERT_FALSE (init);
+	btcb::stat stats;
+	btcb::ledger ledger (store, stats);
+	auto transaction (store.tx_begin (true));
+	ASSERT_LT (15, store.version_get (transaction));
+	btcb::block_sideband sideband;
+	ASSERT_TRUE (store.block_sideband_get (transaction, send.hash (), sideband));
+	// Lookups fall back to walking the chain until the background upgrade reaches the block
+	ASSERT_EQ (btcb::genesis_account, ledger.account (transaction, send.hash ()));
+	ASSERT_EQ (btcb::genesis_amount - 100, ledger.balance (transaction, send.hash ()));
+	ASSERT_EQ (send.hash (), store.block_successor (transaction, genesis.hash ()));
+	// Each call visits at most count_a blocks, resuming inside the account chain
+	ASSERT_FALSE (store.sideband_upgrade (transaction, 1));
+	ASSERT_FALSE (store.block_sideband_get (transaction, genesis.hash (), sideband));
+	ASSERT_EQ (send.hash (), sideband.successor);
+	ASSERT_EQ (1, sideband.height);
+	ASSERT_EQ (std::numeric_limits<btcb::uint128_t>::max (), sideband.balance.number ());
+	ASSERT_TRUE (store.block_sideband_get (transaction, send.hash (), sideband));
+	ASSERT_TRUE (store.sideband_upgrade (transaction, 1));
+	ASSERT_FALSE (store.block_sideband_get (transaction, send.hash (), sideband));
+	ASSERT_TRUE (sideband.successor.is_zero ());
+	ASSERT_EQ (btcb::genesis_account, sideband.account);
+	ASSERT_EQ (2, sideband.height);
+	ASSERT_EQ (btcb::genesis_amount - 100, sideband.balance.number ());
+	ASSERT_EQ (0, sideband.timestamp);
+	ASSERT_EQ (send.hash (), store.block_successor (transaction, genesis.hash ()));
+	ASSERT_TRUE (store.sideband_upgrade (transaction, 1));
+}
+
+TEST (block_store, sideband_upgrade_rollback)
+{
+	auto path (btcb::unique_path ());
+	btcb::genesis genesis;
+	btcb::send_block send (genesis.hash (), btcb::test_genesis_key.pub, btcb::genesis_amount - 100, btcb::test_genesis_key.prv, btcb::test_genesis_key.pub, 0);
+	{
+		bool init (false);
+		btcb::mdb_store store (init, path);
+		ASSERT_FALSE (init);
+		btcb::stat stats;
+		btcb::ledger ledger (store, stats);
+		auto transaction (store.tx_begin (true));
+		store.initialize (transaction, genesis);
+		ASSERT_EQ (btcb::process_result::progress, ledger.process (transaction, send).code);
+		store.block_put (transaction, genesis.hash (), *genesis.open, send.hash ());
+		store.block_put (transaction, send.hash (), send);
+		store.version_put (transaction, 15);
+	}
+	bool init (false);
+	btcb::mdb_store store (init, path);
+	ASSERT_FALSE (init);
+	btcb::stat stats;
+	btcb::ledger ledger (store, stats);
+	{
+		auto transaction (store.tx_begin (true));
+		ASSERT_FALSE (store.sideband_upgrade (transaction, 1));
+	}
+	{
+		// The block the next call resumes from is rolled back in between
+		auto transaction (store.tx_begin (true));
+		ledger.rollback (transaction, send.hash ());
+		ASSERT_FALSE (store.block_exists (transaction, send.hash ()));
+	}
+	auto transaction (store.tx_begin (true));
+	ASSERT_TRUE (store.sideband_upgrade (transaction, 1));
+	btcb::block_sideband sideband;
+	ASSERT_FALSE (store.block_sideband_get (transaction, genesis.hash (), sideband));
+	ASSERT_TRUE (sideband.successor.is_zero ());
+	ASSERT_EQ (1, sideband.height);
 }
@@ -173,3 +173,88 @@ TEST (conflicts, reprioritize)
 	ASSERT_NE (node1.active.roots.end (), existing2);
 	ASSERT_EQ (difficulty2, existing2->difficulty);
 }
+
+TEST (conflicts, backlog)
+{
+	btcb::system system (24000, 1);
+	btcb::node_init init1;
+	btcb::node_config config (24001, system.logging);
+	config.active_elections_size = 2;
+	config.active_backlog_size = 2;
+	auto node1 (std::make_shared<btcb::node> (init1, system.io_ctx, btcb::unique_path (), system.alarm, config, system.work));
+	ASSERT_FALSE (init1.error ());
+	btcb::genesis genesis;
+	std::vector<std::shared_ptr<btcb::state_block>> sends;
+	auto latest (genesis.hash ());
+	for (auto i (0); i < 5; ++i)
+	{
+		btcb::keypair key;
+		auto send (std::make_shared<btcb::state_block> (btcb::genesis_account, latest, btcb::genesis_account, btcb::genesis_amount - (i + 1), key.pub, btcb::test_genesis_key.prv, btcb::test_genesis_key.pub, system.work.generate (latest)));
+		latest = send->hash ();
+		ASSERT_EQ (btcb::process_result::progress, node1->process (*send).code);
+		sends.push_back (send);
+	}
+	ASSERT_FALSE (node1->active.start (sends[0]));
+	ASSERT_FALSE (node1->active.start (sends[1]));
+	ASSERT_TRUE (node1->active.start (sends[2]));
+	ASSERT_TRUE (node1->active.start (sends[3]));
+	ASSERT_EQ (2, node1->active.roots.size ());
+	ASSERT_EQ (2, node1->active.backlog_size ());
+	ASSERT_TRUE (node1->active.active (*sends[2]));
+	ASSERT_EQ (2, node1->stats.count (btcb::stat::type::active, btcb::stat::detail::backlogged));
+	// The backlog is full, the lowest priority block is dropped
+	ASSERT_TRUE (node1->active.start (sends[4]));
+	ASSERT_EQ (2, node1->active.backlog_size ());
+	ASSERT_EQ (1, node1->stats.count (btcb::stat::type::active, btcb::stat::detail::backlog_dropped));
+	auto & index (node1->active.backlog.get<1> ());
+	auto highest (index.begin ()->root);
+	ASSERT_GE (index.begin ()->difficulty, std::prev (index.end ())->difficulty);
+	// Ending an election admits the highest priority block
+	node1->active.erase (*sends[0]);
+	ASSERT_EQ (2, node1->active.roots.size ());
+	ASSERT_EQ (1, node1->active.backlog_size ());
+	ASSERT_EQ (1, node1->stats.count (btcb::stat::type::active, btcb::stat::detail::admitted));
+	ASSERT_NE (node1->active.roots.end (), node1->active.roots.find (highest));
+	node1->stop ();
+}
+
+TEST (conflicts, announce_interval)
+{
+	btcb::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	btcb::genesis genesis;
+	std::vector<std::shared_ptr<btcb::state_block>> sends;
+	auto latest (genesis.hash ());
+	for (auto i (0); i < 3; ++i)
+	{
+		btcb::keypair key;
+		auto send (std::make_shared<btcb::state_block> (btcb::genesis_account, latest, btcb::genesis_account, btcb::genesis_amount - (i + 1), key.pub, btcb::test_genesis_key.prv, btcb::test_genesis_key.pub, system.work.generate (latest)));
+		latest = send->hash ();
+		ASSERT_EQ (btcb::process_result::progress, node1.process (*send).code);
+		sends.push_back (send);
+	}
+	for (auto & send : sends)
+	{
+		ASSERT_FALSE (node1.active.start (send));
+	}
+	std::vector<std::shared_ptr<btcb::election>> elections;
+	std::chrono::milliseconds interval;
+	{
+		std::lock_guard<std::mutex> lock (node1.active.mutex);
+		for (auto & send : sends)
+		{
+			elections.push_back (node1.active.roots.find (send->root ())->election);
+		}
+		interval = node1.active.announce_interval ();
+	}
+	auto start (std::chrono::steady_clock::now ());
+	std::this_thread::sleep_for (interval * 5);
+	auto elapsed (std::chrono::steady_clock::now () - start);
+	for (auto & election : elections)
+	{
+		auto election_lock (node1.active.lock_election (election->root));
+		// Announced on the first pass and at most once per interval after that
+		ASSERT_LE (1, election->announcements);
+		ASSERT_GE (elapsed / interval + 1, election->announcements);
+	}
+}
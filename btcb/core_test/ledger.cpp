@@ -787,7 +787,6 @@ TEST (votes, check_signature)
 	node1.active.start (send1);
 	auto votes1 (node1.active.roots.find (send1->root ())->election);
 	ASSERT_EQ (1, votes1->last_votes.size ());
-	std::unique_lock<std::mutex> lock (node1.active.mutex);
 	auto vote1 (std::make_shared<btcb::vote> (btcb::test_genesis_key.pub, btcb::test_genesis_key.prv, 1, send1));
 	vote1->signature.bytes[0] ^= 1;
 	ASSERT_EQ (btcb::vote_code::invalid, node1.vote_processor.vote_blocking (transaction, vote1, btcb::endpoint (boost::asio::ip::address_v6 (), 0)));
@@ -899,16 +898,12 @@ TEST (votes, add_old)
 	node1.active.start (send1);
 	auto votes1 (node1.active.roots.find (send1->root ())->election);
 	auto vote1 (std::make_shared<btcb::vote> (btcb::test_genesis_key.pub, btcb::test_genesis_key.prv, 2, send1));
-	std::unique_lock<std::mutex> lock (node1.active.mutex);
 	node1.vote_processor.vote_blocking (transaction, vote1, node1.network.endpoint ());
-	lock.unlock ();
 	btcb::keypair key2;
 	auto send2 (std::make_shared<btcb::send_block> (genesis.hash (), key2.pub, 0, btcb::test_genesis_key.prv, btcb::test_genesis_key.pub, 0));
 	auto vote2 (std::make_shared<btcb::vote> (btcb::test_genesis_key.pub, btcb::test_genesis_key.prv, 1, send2));
 	votes1->last_votes[btcb::test_genesis_key.pub].time = std::chrono::steady_clock::now () - std::chrono::seconds (20);
-	lock.lock ();
 	node1.vote_processor.vote_blocking (transaction, vote2, node1.network.endpoint ());
-	lock.unlock ();
 	ASSERT_EQ (2, votes1->last_votes.size ());
 	ASSERT_NE (votes1->last_votes.end (), votes1->last_votes.find (btcb::test_genesis_key.pub));
 	ASSERT_EQ (send1->hash (), votes1->last_votes[btcb::test_genesis_key.pub].hash);
@@ -937,16 +932,12 @@ TEST (votes, add_old_different_account)
 	ASSERT_EQ (1, votes1->last_votes.size ());
 	ASSERT_EQ (1, votes2->last_votes.size ());
 	auto vote1 (std::make_shared<btcb::vote> (btcb::test_genesis_key.pub, btcb::test_genesis_key.prv, 2, send1));
-	std::unique_lock<std::mutex> lock (node1.active.mutex);
 	auto vote_result1 (node1.vote_processor.vote_blocking (transaction, vote1, node1.network.endpoint ()));
-	lock.unlock ();
 	ASSERT_EQ (btcb::vote_code::vote, vote_result1);
 	ASSERT_EQ (2, votes1->last_votes.size ());
 	ASSERT_EQ (1, votes2->last_votes.size ());
-	lock.lock ();
 	auto vote2 (std::make_shared<btcb::vote> (btcb::test_genesis_key.pub, btcb::test_genesis_key.prv, 1, send2));
 	auto vote_result2 (node1.vote_processor.vote_blocking (transaction, vote2, node1.network.endpoint ()));
-	lock.unlock ();
 	ASSERT_EQ (btcb::vote_code::vote, vote_result2);
 	ASSERT_EQ (2, votes1->last_votes.size ());
 	ASSERT_EQ (2, votes2->last_votes.size ());
@@ -974,16 +965,12 @@ TEST (votes, add_cooldown)
 	node1.active.start (send1);
 	auto votes1 (node1.active.roots.find (send1->root ())->election);
 	auto vote1 (std::make_shared<btcb::vote> (btcb::test_genesis_key.pub, btcb::test_genesis_key.prv, 1, send1));
-	std::unique_lock<std::mutex> lock (node1.active.mutex);
 	node1.vote_processor.vote_blocking (transaction, vote1, node1.network.endpoint ());
-	lock.unlock ();
 	btcb::keypair key2;
 	auto send2 (std::make_shared<btcb::send_block> (genesis.hash (), key2.pub, 0, btcb::test_genesis_key.prv, btcb::test_genesis_key.pub, 0));
 	node1.work_generate_blocking (*send2);
 	auto vote2 (std::make_shared<btcb::vote> (btcb::test_genesis_key.pub, btcb::test_genesis_key.prv, 2, send2));
-	lock.lock ();
 	node1.vote_processor.vote_blocking (transaction, vote2, node1.network.endpoint ());
-	lock.unlock ();
 	ASSERT_EQ (2, votes1->last_votes.size ());
 	ASSERT_NE (votes1->last_votes.end (), votes1->last_votes.find (btcb::test_genesis_key.pub));
 	ASSERT_EQ (send1->hash (), votes1->last_votes[btcb::test_genesis_key.pub].hash);
@@ -1513,6 +1500,113 @@ TEST (ledger, change_representative_move_representation)
 	ASSERT_EQ (btcb::genesis_amount, ledger.weight (transaction, key3.pub));
 }
 
+TEST (ledger, delegators_index)
+{
+	bool init (false);
+	btcb::mdb_store store (init, btcb::unique_path ());
+	ASSERT_TRUE (!init);
+	btcb::stat stats;
+	btcb::ledger ledger (store, stats);
+	auto transaction (store.tx_begin (true));
+	btcb::genesis genesis;
+	store.initialize (transaction, genesis);
+	ASSERT_EQ (1, store.delegators_count (transaction, btcb::test_genesis_key.pub));
+	btcb::keypair key1;
+	btcb::keypair key2;
+	btcb::send_block send (genesis.hash (), key1.pub, btcb::genesis_amount - 100, btcb::test_genesis_key.prv, btcb::test_genesis_key.pub, 0);
+	ASSERT_EQ (btcb::process_result::progress, ledger.process (transaction, send).code);
+	btcb::open_block open (send.hash (), btcb::test_genesis_key.pub, key1.pub, key1.prv, key1.pub, 0);
+	ASSERT_EQ (btcb::process_result::progress, ledger.process (transaction, open).code);
+	ASSERT_EQ (2, store.delegators_count (transaction, btcb::test_genesis_key.pub));
+	btcb::change_block change (open.hash (), key2.pub, key1.prv, key1.pub, 0);
+	ASSERT_EQ (btcb::process_result::progress, ledger.process (transaction, change).code);
+	ASSERT_EQ (1, store.delegators_count (transaction, btcb::test_genesis_key.pub));
+	auto delegators (store.delegators_get (transaction, key2.pub, 0, std::numeric_limits<size_t>::max ()));
+	ASSERT_EQ (1, delegators.size ());
+	ASSERT_EQ (key1.pub, delegators[0]);
+	ledger.rollback (transaction, change.hash ());
+	ASSERT_EQ (0, store.delegators_count (transaction, key2.pub));
+	ASSERT_EQ (2, store.delegators_count (transaction, btcb::test_genesis_key.pub));
+	// Pagination starts at the given delegator
+	ASSERT_EQ (1, store.delegators_get (transaction, btcb::test_genesis_key.pub, 0, 1).size ());
+	auto page (store.delegators_get (transaction, btcb::test_genesis_key.pub, std::max (key1.pub, btcb::test_genesis_key.pub), 2));
+	ASSERT_EQ (1, page.size ());
+	ledger.rollback (transaction, open.hash ());
+	delegators = store.delegators_get (transaction, btcb::test_genesis_key.pub, 0, std::numeric_limits<size_t>::max ());
+	ASSERT_EQ (1, delegators.size ());
+	ASSERT_EQ (btcb::test_genesis_key.pub, delegators[0]);
+}
+
+TEST (ledger, account_height_index)
+{
+	bool init (false);
+	btcb::mdb_store store (init, btcb::unique_path ());
+	ASSERT_TRUE (!init);
+	btcb::stat stats;
+	btcb::ledger ledger (store, stats);
+	auto transaction (store.tx_begin (true));
+	btcb::genesis genesis;
+	store.initialize (transaction, genesis);
+	btcb::block_hash hash;
+	ASSERT_FALSE (store.account_height_get (transaction, btcb::test_genesis_key.pub, 1, hash));
+	ASSERT_EQ (genesis.hash (), hash);
+	btcb::keypair key1;
+	btcb::send_block send (genesis.hash (), key1.pub, btcb::genesis_amount - 100, btcb::test_genesis_key.prv, btcb::test_genesis_key.pub, 0);
+	ASSERT_EQ (btcb::process_result::progress, ledger.process (transaction, send).code);
+	btcb::open_block open (send.hash (), btcb::test_genesis_key.pub, key1.pub, key1.prv, key1.pub, 0);
+	ASSERT_EQ (btcb::process_result::progress, ledger.process (transaction, open).code);
+	ASSERT_FALSE (store.account_height_get (transaction, btcb::test_genesis_key.pub, 2, hash));
+	ASSERT_EQ (send.hash (), hash);
+	ASSERT_FALSE (store.account_height_get (transaction, key1.pub, 1, hash));
+	ASSERT_EQ (open.hash (), hash);
+	ASSERT_TRUE (store.account_height_get (transaction, key1.pub, 2, hash));
+	ledger.rollback (transaction, send.hash ());
+	ASSERT_TRUE (store.account_height_get (transaction, key1.pub, 1, hash));
+	ASSERT_TRUE (store.account_height_get (transaction, btcb::test_genesis_key.pub, 2, hash));
+	ASSERT_FALSE (store.account_height_get (transaction, btcb::test_genesis_key.pub, 1, hash));
+	ASSERT_EQ (genesis.hash (), hash);
+}
+
+TEST (ledger, sideband)
+{
+	bool init (false);
+	btcb::mdb_store store (init, btcb::unique_path ());
+	ASSERT_TRUE (!init);
+	btcb::stat stats;
+	btcb::ledger ledger (store, stats);
+	auto transaction (store.tx_begin (true));
+	btcb::genesis genesis;
+	store.initialize (transaction, genesis);
+	btcb::keypair key1;
+	btcb::send_block send (genesis.hash (), key1.pub, btcb::genesis_amount - 100, btcb::test_genesis_key.prv, btcb::test_genesis_key.pub, 0);
+	ASSERT_EQ (btcb::process_result::progress, ledger.process (transaction, send).code);
+	btcb::open_block open (send.hash (), btcb::test_genesis_key.pub, key1.pub, key1.prv, key1.pub, 0);
+	ASSERT_EQ (btcb::process_result::progress, ledger.process (transaction, open).code);
+	btcb::block_sideband sideband;
+	ASSERT_FALSE (store.block_sideband_get (transaction, genesis.hash (), sideband));
+	ASSERT_EQ (send.hash (), sideband.successor);
+	ASSERT_EQ (btcb::genesis_account, sideband.account);
+	ASSERT_EQ (1, sideband.height);
+	ASSERT_FALSE (store.block_sideband_get (transaction, send.hash (), sideband));
+	ASSERT_TRUE (sideband.successor.is_zero ());
+	ASSERT_EQ (btcb::genesis_account, sideband.account);
+	ASSERT_EQ (2, sideband.height);
+	ASSERT_EQ (btcb::genesis_amount - 100, sideband.balance.number ());
+	ASSERT_NE (0, sideband.timestamp);
+	ASSERT_FALSE (store.block_sideband_get (transaction, open.hash (), sideband));
+	ASSERT_EQ (key1.pub, sideband.account);
+	ASSERT_EQ (1, sideband.height);
+	ASSERT_EQ (100, sideband.balance.number ());
+	ASSERT_EQ (key1.pub, ledger.account (transaction, open.hash ()));
+	ASSERT_EQ (100, ledger.amount (transaction, open.hash ()));
+	ASSERT_EQ (btcb::genesis_amount - 100, ledger.balance (transaction, send.hash ()));
+	ledger.rollback (transaction, send.hash ());
+	ASSERT_TRUE (store.block_sideband_get (transaction, send.hash (), sideband));
+	ASSERT_FALSE (store.block_sideband_get (transaction, genesis.hash (), sideband));
+	ASSERT_TRUE (sideband.successor.is_zero ());
+	ASSERT_EQ (1, sideband.height);
+}
+
 TEST (ledger, send_open_receive_rollback)
 {
 	bool init (false);
@@ -1581,6 +1675,8 @@ TEST (ledger, bootstrap_rep_weight)
 	btcb::account_info info1;
 	btcb::keypair key2;
 	btcb::genesis genesis;
+	ledger.bootstrap_weight_max_blocks = 3;
+	ledger.bootstrap_weights[key2.pub] = 1000;
 	{
 		auto transaction (store.tx_begin (true));
 		store.initialize (transaction, genesis);
@@ -1590,8 +1686,6 @@ TEST (ledger, bootstrap_rep_weight)
 	}
 	{
 		auto transaction (store.tx_begin ());
-		ledger.bootstrap_weight_max_blocks = 3;
-		ledger.bootstrap_weights[key2.pub] = 1000;
 		ASSERT_EQ (1000, ledger.weight (transaction, key2.pub));
 	}
 	{
@@ -260,6 +260,59 @@ TEST (network, send_insufficient_work)
 	ASSERT_EQ (1, system.nodes[1]->stats.count (btcb::stat::type::error, btcb::stat::detail::insufficient_work));
 }
 
+TEST (network, duplicate_publish)
+{
+	btcb::system system (24000, 2);
+	auto block (std::make_shared<btcb::send_block> (1, 1, 2, btcb::keypair ().prv, 4, system.work.generate (1)));
+	btcb::publish publish (std::move (block));
+	std::shared_ptr<std::vector<uint8_t>> bytes (new std::vector<uint8_t>);
+	{
+		btcb::vectorstream stream (*bytes);
+		publish.serialize (stream);
+	}
+	auto node1 (system.nodes[1]->shared ());
+	system.nodes[0]->network.send_buffer (bytes->data (), bytes->size (), system.nodes[1]->network.endpoint (), [bytes, node1](boost::system::error_code const & ec, size_t size) {});
+	system.deadline_set (10s);
+	while (system.nodes[1]->stats.count (btcb::stat::type::message, btcb::stat::detail::publish, btcb::stat::dir::in) == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	system.nodes[0]->network.send_buffer (bytes->data (), bytes->size (), system.nodes[1]->network.endpoint (), [bytes, node1](boost::system::error_code const & ec, size_t size) {});
+	while (system.nodes[1]->stats.count (btcb::stat::type::udp, btcb::stat::detail::duplicate_publish) == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (1, system.nodes[1]->stats.count (btcb::stat::type::message, btcb::stat::detail::publish, btcb::stat::dir::in));
+}
+
+TEST (network_filter, apply)
+{
+	btcb::network_filter filter (64);
+	std::vector<uint8_t> bytes1 (32, 1);
+	std::vector<uint8_t> bytes2 (bytes1);
+	bytes2.back () = 2;
+	ASSERT_FALSE (filter.apply (bytes1.data (), bytes1.size ()));
+	ASSERT_TRUE (filter.apply (bytes1.data (), bytes1.size ()));
+	ASSERT_FALSE (filter.apply (bytes2.data (), bytes2.size ()));
+	// Version bytes aren't hashed
+	std::vector<uint8_t> bytes3 (bytes1);
+	bytes3[2] = 0;
+	ASSERT_TRUE (filter.apply (bytes3.data (), bytes3.size ()));
+	filter.rotate ();
+	ASSERT_TRUE (filter.apply (bytes1.data (), bytes1.size ()));
+	filter.rotate ();
+	ASSERT_FALSE (filter.apply (bytes1.data (), bytes1.size ()));
+	ASSERT_TRUE (filter.apply (bytes1.data (), bytes1.size ()));
+}
+
+TEST (network_filter, disabled)
+{
+	btcb::network_filter filter (0);
+	std::vector<uint8_t> bytes (32, 1);
+	ASSERT_FALSE (filter.apply (bytes.data (), bytes.size ()));
+	ASSERT_FALSE (filter.apply (bytes.data (), bytes.size ()));
+}
+
 TEST (receivable_processor, confirm_insufficient_pos)
 {
 	btcb::system system (24000, 1);
@@ -437,6 +490,7 @@ TEST (bulk_pull, end_not_owned)
 	open.hashables.account = key2.pub;
 	open.hashables.representative = key2.pub;
 	open.hashables.source = latest;
+	open.refresh ();
 	open.signature = btcb::sign_message (key2.prv, key2.pub, open.hash ());
 	ASSERT_EQ (btcb::process_result::progress, system.nodes[0]->process (open).code);
 	auto connection (std::make_shared<btcb::bootstrap_server> (nullptr, system.nodes[0]));
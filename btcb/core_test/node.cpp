@@ -496,6 +496,16 @@ TEST (node_config, serialization)
 	config1.callback_port = 10;
 	config1.callback_target = "test";
 	config1.lmdb_max_dbs = 256;
+	config1.signature_checker_threads = config1.signature_checker_threads + 1;
+	config1.vote_processor_threads = config1.vote_processor_threads + 1;
+	config1.callback_connections = 8;
+	config1.callback_batch_max = 16;
+	config1.network_filter_size = 1024;
+	config1.network_filter_expiry = std::chrono::seconds (30);
+	config1.unchecked_cache_mb = 8;
+	config1.unchecked_cache_cutoff = std::chrono::seconds (600);
+	config1.active_elections_size = 100;
+	config1.active_backlog_size = 200;
 	boost::property_tree::ptree tree;
 	config1.serialize_json (tree);
 	btcb::logging logging2;
@@ -513,6 +523,16 @@ TEST (node_config, serialization)
 	ASSERT_NE (config2.callback_port, config1.callback_port);
 	ASSERT_NE (config2.callback_target, config1.callback_target);
 	ASSERT_NE (config2.lmdb_max_dbs, config1.lmdb_max_dbs);
+	ASSERT_NE (config2.signature_checker_threads, config1.signature_checker_threads);
+	ASSERT_NE (config2.vote_processor_threads, config1.vote_processor_threads);
+	ASSERT_NE (config2.callback_connections, config1.callback_connections);
+	ASSERT_NE (config2.callback_batch_max, config1.callback_batch_max);
+	ASSERT_NE (config2.network_filter_size, config1.network_filter_size);
+	ASSERT_NE (config2.network_filter_expiry, config1.network_filter_expiry);
+	ASSERT_NE (config2.unchecked_cache_mb, config1.unchecked_cache_mb);
+	ASSERT_NE (config2.unchecked_cache_cutoff, config1.unchecked_cache_cutoff);
+	ASSERT_NE (config2.active_elections_size, config1.active_elections_size);
+	ASSERT_NE (config2.active_backlog_size, config1.active_backlog_size);
 
 	ASSERT_FALSE (tree.get_optional<std::string> ("epoch_block_link"));
 	ASSERT_FALSE (tree.get_optional<std::string> ("epoch_block_signer"));
@@ -531,6 +551,16 @@ TEST (node_config, serialization)
 	ASSERT_EQ (config2.callback_port, config1.callback_port);
 	ASSERT_EQ (config2.callback_target, config1.callback_target);
 	ASSERT_EQ (config2.lmdb_max_dbs, config1.lmdb_max_dbs);
+	ASSERT_EQ (config2.signature_checker_threads, config1.signature_checker_threads);
+	ASSERT_EQ (config2.vote_processor_threads, config1.vote_processor_threads);
+	ASSERT_EQ (config2.callback_connections, config1.callback_connections);
+	ASSERT_EQ (config2.callback_batch_max, config1.callback_batch_max);
+	ASSERT_EQ (config2.network_filter_size, config1.network_filter_size);
+	ASSERT_EQ (config2.network_filter_expiry, config1.network_filter_expiry);
+	ASSERT_EQ (config2.unchecked_cache_mb, config1.unchecked_cache_mb);
+	ASSERT_EQ (config2.unchecked_cache_cutoff, config1.unchecked_cache_cutoff);
+	ASSERT_EQ (config2.active_elections_size, config1.active_elections_size);
+	ASSERT_EQ (config2.active_backlog_size, config1.active_backlog_size);
 }
 
 TEST (node_config, v1_v2_upgrade)
@@ -1407,6 +1437,90 @@ TEST (node, send_callback)
 	ASSERT_EQ (std::numeric_limits<btcb::uint128_t>::max () - system.nodes[0]->config.receive_minimum.number (), system.nodes[0]->balance (btcb::test_genesis_key.pub));
 }
 
+namespace
+{
+class callback_server : public std::enable_shared_from_this<callback_server>
+{
+public:
+	callback_server (boost::asio::io_context & io_ctx_a, uint16_t port_a) :
+	acceptor (io_ctx_a, boost::asio::ip::tcp::endpoint (boost::asio::ip::address_v4::loopback (), port_a)),
+	socket (io_ctx_a)
+	{
+	}
+	void accept ()
+	{
+		auto this_l (shared_from_this ());
+		acceptor.async_accept (socket, [this_l](boost::system::error_code const & ec) {
+			if (!ec)
+			{
+				++this_l->connections;
+				this_l->read ();
+			}
+		});
+	}
+	void read ()
+	{
+		auto this_l (shared_from_this ());
+		request = boost::beast::http::request<boost::beast::http::string_body> ();
+		boost::beast::http::async_read (socket, buffer, request, [this_l](boost::system::error_code const & ec, size_t) {
+			if (!ec)
+			{
+				this_l->bodies.push_back (this_l->request.body ());
+				this_l->response = boost::beast::http::response<boost::beast::http::string_body> (boost::beast::http::status::ok, 11);
+				this_l->response.keep_alive (true);
+				this_l->response.prepare_payload ();
+				boost::beast::http::async_write (this_l->socket, this_l->response, [this_l](boost::system::error_code const & ec, size_t) {
+					if (!ec)
+					{
+						this_l->read ();
+					}
+				});
+			}
+		});
+	}
+	boost::asio::ip::tcp::acceptor acceptor;
+	boost::asio::ip::tcp::socket socket;
+	boost::beast::flat_buffer buffer;
+	boost::beast::http::request<boost::beast::http::string_body> request;
+	boost::beast::http::response<boost::beast::http::string_body> response;
+	std::vector<std::string> bodies;
+	unsigned connections{ 0 };
+};
+}
+
+TEST (node, http_callback_keepalive)
+{
+	btcb::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	auto server (std::make_shared<callback_server> (system.io_ctx, 24100));
+	server->accept ();
+	node.config.callback_address = "127.0.0.1";
+	node.config.callback_port = 24100;
+	node.config.callback_target = "/";
+	node.config.callback_connections = 1;
+	node.http_callbacks.add ("{\"a\": 1}");
+	system.deadline_set (10s);
+	while (node.stats.count (btcb::stat::type::http_callback, btcb::stat::detail::initiate, btcb::stat::dir::out) < 1)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	node.config.callback_batch_max = 2;
+	node.http_callbacks.add ("{\"b\": 2}");
+	node.http_callbacks.add ("{\"c\": 3}");
+	node.http_callbacks.add ("{\"d\": 4}");
+	while (server->bodies.size () < 3 || node.stats.count (btcb::stat::type::http_callback, btcb::stat::detail::initiate, btcb::stat::dir::out) < 4)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (1, server->connections);
+	ASSERT_EQ ("{\"a\": 1}", server->bodies[0]);
+	// The connection was busy with the second event, the remaining two are sent in one batch
+	ASSERT_EQ ("[{\"b\": 2}]", server->bodies[1]);
+	ASSERT_EQ ("[{\"c\": 3},{\"d\": 4}]", server->bodies[2]);
+	ASSERT_EQ (3, node.stats.count (btcb::stat::type::http_callback, btcb::stat::detail::requests, btcb::stat::dir::out));
+	ASSERT_EQ (0, node.stats.count (btcb::stat::type::error, btcb::stat::detail::http_callback, btcb::stat::dir::out));
+}
+
 // Check that votes get replayed back to nodes if they sent an old sequence number.
 // This helps representatives continue from their last sequence number if their node is reinitialized and the old sequence number is lost
 TEST (node, vote_replay)
@@ -1805,7 +1919,6 @@ TEST (node, fork_invalid_block_signature_vote_by_hash)
 	auto vote (std::make_shared<btcb::vote> (btcb::test_genesis_key.pub, btcb::test_genesis_key.prv, 0, vote_blocks));
 	{
 		auto transaction (system.nodes[0]->store.tx_begin_read ());
-		std::unique_lock<std::mutex> lock (system.nodes[0]->active.mutex);
 		system.nodes[0]->vote_processor.vote_blocking (transaction, vote, system.nodes[0]->network.endpoint ());
 	}
 	while (system.nodes[0]->block (send1->hash ()))
@@ -1897,6 +2010,35 @@ TEST (node, block_processor_reject_state)
 	ASSERT_TRUE (node.ledger.block_exists (send2->hash ()));
 }
 
+TEST (node, block_processor_pipeline)
+{
+	btcb::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	btcb::genesis genesis;
+	std::vector<std::shared_ptr<btcb::state_block>> blocks;
+	auto previous (genesis.hash ());
+	for (auto i (1); i <= 16; ++i)
+	{
+		auto send (std::make_shared<btcb::state_block> (btcb::test_genesis_key.pub, previous, btcb::test_genesis_key.pub, btcb::genesis_amount - i * btcb::Gbcb_ratio, btcb::test_genesis_key.pub, btcb::test_genesis_key.prv, btcb::test_genesis_key.pub, 0));
+		node.work_generate_blocking (*send);
+		previous = send->hash ();
+		blocks.push_back (send);
+	}
+	for (auto & block : blocks)
+	{
+		node.block_processor.add (block, std::chrono::steady_clock::now ());
+	}
+	node.block_processor.flush ();
+	for (auto & block : blocks)
+	{
+		ASSERT_TRUE (node.ledger.block_exists (block->hash ()));
+	}
+	ASSERT_EQ (blocks.size (), node.stats.count (btcb::stat::type::block_processor, btcb::stat::detail::verified_blocks));
+	ASSERT_LE (blocks.size (), node.stats.count (btcb::stat::type::block_processor, btcb::stat::detail::written_blocks));
+	ASSERT_LE (1, node.stats.count (btcb::stat::type::block_processor, btcb::stat::detail::verification_batches));
+	ASSERT_LE (1, node.stats.count (btcb::stat::type::block_processor, btcb::stat::detail::write_batches));
+}
+
 TEST (node, confirm_back)
 {
 	btcb::system system (24000, 1);
@@ -1917,7 +2059,6 @@ TEST (node, confirm_back)
 	auto vote (std::make_shared<btcb::vote> (btcb::test_genesis_key.pub, btcb::test_genesis_key.prv, 0, vote_blocks));
 	{
 		auto transaction (node.store.tx_begin_read ());
-		std::unique_lock<std::mutex> lock (node.active.mutex);
 		node.vote_processor.vote_blocking (transaction, vote, node.network.endpoint ());
 	}
 	system.deadline_set (10s);
@@ -1926,3 +2067,243 @@ TEST (node, confirm_back)
 		ASSERT_NO_ERROR (system.poll ());
 	}
 }
+
+TEST (stat, counters_multi_threaded)
+{
+	btcb::stat stats;
+	std::vector<boost::thread> threads;
+	for (auto i (0); i < 16; ++i)
+	{
+		threads.push_back (boost::thread ([&stats]() {
+			for (auto j (0); j < 1000; ++j)
+			{
+				stats.inc (btcb::stat::type::ledger, btcb::stat::detail::send, btcb::stat::dir::in);
+				stats.add (btcb::stat::type::traffic, btcb::stat::dir::out, 2);
+			}
+		}));
+	}
+	for (auto & thread : threads)
+	{
+		thread.join ();
+	}
+	ASSERT_EQ (16000, stats.count (btcb::stat::type::ledger, btcb::stat::detail::send, btcb::stat::dir::in));
+	ASSERT_EQ (16000, stats.count (btcb::stat::type::ledger, btcb::stat::dir::in));
+	ASSERT_EQ (32000, stats.count (btcb::stat::type::traffic, btcb::stat::dir::out));
+	ASSERT_EQ (0, stats.count (btcb::stat::type::traffic, btcb::stat::dir::in));
+	uint64_t old_l (0);
+	uint64_t new_l (0);
+	stats.observe_count (btcb::stat::type::ledger, btcb::stat::detail::send, btcb::stat::dir::in, [&old_l, &new_l](uint64_t old_a, uint64_t new_a) {
+		old_l = old_a;
+		new_l = new_a;
+	});
+	stats.inc (btcb::stat::type::ledger, btcb::stat::detail::send, btcb::stat::dir::in);
+	ASSERT_EQ (16000, old_l);
+	ASSERT_EQ (16001, new_l);
+	auto sink (stats.log_sink_json ());
+	stats.log_counters (*sink);
+	auto tree (static_cast<boost::property_tree::ptree *> (sink->to_object ()));
+	ASSERT_EQ (3, tree->get_child ("entries").size ());
+}
+
+TEST (stat, histogram)
+{
+	btcb::stat stats;
+	auto histogram (stats.histogram ("test", { 10, 100 }));
+	ASSERT_EQ (histogram, stats.histogram ("test", { 1 }));
+	histogram->add (5);
+	histogram->add (10);
+	histogram->add (50);
+	histogram->add (1000);
+	ASSERT_EQ (4, histogram->count ());
+	ASSERT_EQ (1065, histogram->sum ());
+	auto buckets (histogram->buckets ());
+	ASSERT_EQ (3, buckets.size ());
+	ASSERT_EQ (10, buckets[0].first);
+	ASSERT_EQ (2, buckets[0].second);
+	ASSERT_EQ (1, buckets[1].second);
+	ASSERT_EQ (std::numeric_limits<uint64_t>::max (), buckets[2].first);
+	ASSERT_EQ (1, buckets[2].second);
+	auto sink (stats.log_sink_json ());
+	stats.log_histograms (*sink);
+	auto tree (static_cast<boost::property_tree::ptree *> (sink->to_object ()));
+	auto & entries (tree->get_child ("entries"));
+	ASSERT_EQ (1, entries.size ());
+	ASSERT_EQ ("test", entries.front ().second.get<std::string> ("name"));
+	ASSERT_EQ (4, entries.front ().second.get<uint64_t> ("count"));
+	ASSERT_EQ ("inf", entries.front ().second.get_child ("buckets").back ().second.get<std::string> ("bound"));
+}
+
+TEST (verified_vote_cache, evict)
+{
+	// One entry per shard, small numbers all map to the first shard
+	btcb::verified_vote_cache cache (btcb::verified_vote_cache::shard_count);
+	btcb::uint256_union hash1 (1);
+	btcb::uint256_union hash2 (2);
+	ASSERT_FALSE (cache.exists (hash1));
+	cache.insert (hash1);
+	ASSERT_TRUE (cache.exists (hash1));
+	cache.insert (hash1);
+	ASSERT_EQ (1, cache.size ());
+	cache.insert (hash2);
+	ASSERT_FALSE (cache.exists (hash1));
+	ASSERT_TRUE (cache.exists (hash2));
+	ASSERT_EQ (1, cache.size ());
+}
+
+TEST (unchecked_cache, put_pop)
+{
+	btcb::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	auto block1 (std::make_shared<btcb::send_block> (1, 1, 2, btcb::keypair ().prv, 4, 5));
+	auto block2 (std::make_shared<btcb::send_block> (1, 1, 3, btcb::keypair ().prv, 4, 5));
+	auto block3 (std::make_shared<btcb::send_block> (2, 1, 3, btcb::keypair ().prv, 4, 5));
+	auto transaction (node1.store.tx_begin_write ());
+	node1.unchecked.put (transaction, 1, block1);
+	node1.unchecked.put (transaction, 1, block2);
+	node1.unchecked.put (transaction, 2, block3);
+	node1.unchecked.put (transaction, 2, block3);
+	ASSERT_EQ (3, node1.unchecked.size ());
+	ASSERT_EQ (3, node1.unchecked.count (transaction));
+	ASSERT_EQ (0, node1.store.unchecked_count (transaction));
+	ASSERT_EQ (block3, node1.unchecked.block_get (block3->hash ()));
+	ASSERT_EQ (2, node1.unchecked.list (1, 2).size ());
+	ASSERT_EQ (1, node1.unchecked.list (2, 2).size ());
+	auto blocks (node1.unchecked.pop (transaction, 1));
+	ASSERT_EQ (2, blocks.size ());
+	ASSERT_TRUE (node1.unchecked.pop (transaction, 1).empty ());
+	ASSERT_EQ (1, node1.unchecked.size ());
+	ASSERT_EQ (nullptr, node1.unchecked.block_get (block1->hash ()));
+	ASSERT_EQ (block3, node1.unchecked.block_get (block3->hash ()));
+}
+
+TEST (unchecked_cache, flush_expire)
+{
+	btcb::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	auto block1 (std::make_shared<btcb::send_block> (1, 1, 2, btcb::keypair ().prv, 4, 5));
+	auto block2 (std::make_shared<btcb::send_block> (2, 1, 2, btcb::keypair ().prv, 4, 5));
+	auto transaction (node1.store.tx_begin_write ());
+	node1.unchecked.put (transaction, 1, block1);
+	node1.unchecked.flush (transaction);
+	ASSERT_EQ (0, node1.unchecked.size ());
+	ASSERT_EQ (1, node1.store.unchecked_count (transaction));
+	node1.unchecked.put (transaction, 2, block2);
+	node1.unchecked.expire (std::chrono::steady_clock::now () + std::chrono::seconds (1));
+	ASSERT_EQ (0, node1.unchecked.size ());
+	ASSERT_EQ (1, node1.stats.count (btcb::stat::type::unchecked, btcb::stat::detail::expired));
+	// Blocks that spilled to the table are still found
+	auto blocks (node1.unchecked.pop (transaction, 1));
+	ASSERT_EQ (1, blocks.size ());
+	ASSERT_EQ (block1->hash (), blocks[0]->hash ());
+	ASSERT_EQ (0, node1.store.unchecked_count (transaction));
+}
+
+TEST (local_vote_cache, reuse)
+{
+	btcb::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	btcb::genesis genesis;
+	btcb::raw_key prv;
+	prv.data = btcb::test_genesis_key.prv.data;
+	auto transaction (node1.store.tx_begin_read ());
+	auto vote1 (node1.local_votes.vote (transaction, btcb::test_genesis_key.pub, prv, genesis.hash ()));
+	auto vote2 (node1.local_votes.vote (transaction, btcb::test_genesis_key.pub, prv, genesis.hash ()));
+	ASSERT_EQ (vote1.first, vote2.first);
+	ASSERT_EQ (vote1.second, vote2.second);
+	auto vote3 (node1.local_votes.vote (transaction, btcb::test_genesis_key.pub, prv, 1));
+	ASSERT_NE (vote1.first, vote3.first);
+	ASSERT_LT (vote1.first->sequence, vote3.first->sequence);
+	ASSERT_EQ (2, node1.local_votes.size ());
+	ASSERT_EQ (2, node1.stats.count (btcb::stat::type::vote_cache, btcb::stat::detail::miss, btcb::stat::dir::out));
+	ASSERT_EQ (1, node1.stats.count (btcb::stat::type::vote_cache, btcb::stat::detail::hit, btcb::stat::dir::out));
+}
+
+TEST (local_vote_cache, concurrent)
+{
+	btcb::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	btcb::genesis genesis;
+	btcb::raw_key prv;
+	prv.data = btcb::test_genesis_key.prv.data;
+	std::vector<std::shared_ptr<btcb::vote>> votes (8);
+	std::vector<boost::thread> threads;
+	for (size_t i (0); i < votes.size (); ++i)
+	{
+		threads.push_back (boost::thread ([&node1, &votes, &prv, &genesis, i]() {
+			auto transaction (node1.store.tx_begin_read ());
+			votes[i] = node1.local_votes.vote (transaction, btcb::test_genesis_key.pub, prv, genesis.hash ()).first;
+		}));
+	}
+	for (auto & i : threads)
+	{
+		i.join ();
+	}
+	for (auto & i : votes)
+	{
+		ASSERT_EQ (votes[0], i);
+	}
+	ASSERT_EQ (1, node1.stats.count (btcb::stat::type::vote_cache, btcb::stat::detail::miss, btcb::stat::dir::out));
+}
+
+TEST (vote_processor, duplicate_votes)
+{
+	btcb::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	btcb::genesis genesis;
+	auto vote (std::make_shared<btcb::vote> (btcb::test_genesis_key.pub, btcb::test_genesis_key.prv, 1, genesis.open));
+	node1.vote_processor.vote (vote, node1.network.endpoint ());
+	node1.vote_processor.flush ();
+	ASSERT_TRUE (node1.vote_processor.verified.exists (vote->full_hash ()));
+	ASSERT_EQ (1, node1.stats.count (btcb::stat::type::vote_cache, btcb::stat::detail::miss));
+	ASSERT_EQ (0, node1.stats.count (btcb::stat::type::vote_cache, btcb::stat::detail::hit));
+	// Copies of the verified vote are dropped before being queued
+	node1.vote_processor.vote (std::make_shared<btcb::vote> (*vote), node1.network.endpoint ());
+	node1.vote_processor.flush ();
+	ASSERT_EQ (1, node1.stats.count (btcb::stat::type::vote_cache, btcb::stat::detail::miss));
+	ASSERT_EQ (1, node1.stats.count (btcb::stat::type::vote_cache, btcb::stat::detail::hit));
+	// A copy with a different signature is verified separately and rejected
+	auto forged (std::make_shared<btcb::vote> (*vote));
+	forged->signature.bytes[63] ^= 1;
+	ASSERT_NE (vote->full_hash (), forged->full_hash ());
+	node1.vote_processor.vote (forged, node1.network.endpoint ());
+	node1.vote_processor.flush ();
+	ASSERT_EQ (2, node1.stats.count (btcb::stat::type::vote_cache, btcb::stat::detail::miss));
+	ASSERT_FALSE (node1.vote_processor.verified.exists (forged->full_hash ()));
+}
+
+TEST (vote_processor, threads)
+{
+	btcb::system system (24000, 1);
+	btcb::node_init init1;
+	btcb::node_config config (24001, system.logging);
+	config.vote_processor_threads = 4;
+	auto node1 (std::make_shared<btcb::node> (init1, system.io_ctx, btcb::unique_path (), system.alarm, config, system.work));
+	ASSERT_FALSE (init1.error ());
+	node1->start ();
+	btcb::genesis genesis;
+	std::vector<std::shared_ptr<btcb::vote>> votes;
+	auto latest (genesis.hash ());
+	for (auto i (0); i < 16; ++i)
+	{
+		btcb::keypair key;
+		auto send (std::make_shared<btcb::state_block> (btcb::genesis_account, latest, btcb::genesis_account, btcb::genesis_amount - (i + 1), key.pub, btcb::test_genesis_key.prv, btcb::test_genesis_key.pub, system.work.generate (latest)));
+		latest = send->hash ();
+		node1->process_active (send);
+		votes.push_back (std::make_shared<btcb::vote> (btcb::test_genesis_key.pub, btcb::test_genesis_key.prv, i + 1, std::vector<btcb::block_hash> (1, send->hash ())));
+	}
+	node1->block_processor.flush ();
+	ASSERT_EQ (16, node1->active.roots.size ());
+	for (auto & vote : votes)
+	{
+		node1->vote_processor.vote (vote, node1->network.endpoint ());
+	}
+	node1->vote_processor.flush ();
+	ASSERT_EQ (16, node1->stats.count (btcb::stat::type::vote, btcb::stat::detail::vote_valid));
+	// Genesis holds all the weight, every election is confirmed and removed
+	system.deadline_set (10s);
+	while (!node1->active.roots.empty ())
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	node1->stop ();
+}
@@ -169,3 +169,37 @@ TEST (peer_container, depeer)
 	peers.contacted (endpoint0, btcb::protocol_version_min - 1);
 	ASSERT_EQ (0, peers.size ());
 }
+
+TEST (peer_container, snapshot)
+{
+	btcb::peer_container peers (btcb::endpoint{});
+	btcb::endpoint endpoint0 (boost::asio::ip::address_v6::loopback (), 24000);
+	btcb::endpoint endpoint1 (boost::asio::ip::address_v6::loopback (), 24001);
+	btcb::endpoint endpoint2 (boost::asio::ip::address_v6::loopback (), 24002);
+	auto snapshot1 (peers.snapshot ());
+	ASSERT_TRUE (snapshot1->peers.empty ());
+	peers.insert (endpoint0, btcb::protocol_version);
+	peers.insert (endpoint1, btcb::protocol_version);
+	peers.insert (endpoint2, btcb::protocol_version);
+	btcb::keypair key1;
+	btcb::keypair key2;
+	peers.rep_response (endpoint0, key1.pub, btcb::amount (100));
+	peers.rep_response (endpoint1, key2.pub, btcb::amount (200));
+	// Same representative seen from a second address is only counted once
+	peers.rep_response (endpoint2, key2.pub, btcb::amount (200));
+	auto snapshot2 (peers.snapshot ());
+	ASSERT_TRUE (snapshot1->peers.empty ());
+	ASSERT_EQ (3, snapshot2->peers.size ());
+	ASSERT_EQ (3, snapshot2->representatives.size ());
+	ASSERT_EQ (200, snapshot2->representatives[0].rep_weight.number ());
+	ASSERT_EQ (100, snapshot2->representatives[2].rep_weight.number ());
+	ASSERT_EQ (300, snapshot2->total_weight);
+	ASSERT_EQ (snapshot2, peers.snapshot ());
+	ASSERT_EQ (2, peers.list_vector (2).size ());
+	ASSERT_EQ (3, peers.list_vector (10).size ());
+	peers.purge_list (std::chrono::steady_clock::now () + std::chrono::seconds (10));
+	ASSERT_EQ (3, snapshot2->peers.size ());
+	ASSERT_EQ (0, peers.size ());
+	ASSERT_TRUE (peers.representatives (std::numeric_limits<size_t>::max ()).empty ());
+	ASSERT_EQ (0, peers.total_weight ());
+}
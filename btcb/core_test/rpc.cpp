@@ -6,6 +6,7 @@
 #include <boost/property_tree/ptree.hpp>
 #include <boost/thread.hpp>
 #include <btcb/core_test/testutil.hpp>
+#include <btcb/lib/jsonstream.hpp>
 #include <btcb/node/common.hpp>
 #include <btcb/node/rpc.hpp>
 #include <btcb/node/testing.hpp>
@@ -830,6 +831,39 @@ TEST (rpc, chain_limit)
 	ASSERT_EQ (block->hash (), blocks[0]);
 }
 
+TEST (json_stream, write)
+{
+	std::string output;
+	btcb::json_stream json (output);
+	json.begin_object ();
+	json.put ("text", "quote \" slash \\ line\n\x01");
+	json.key ("list");
+	json.begin_array ();
+	json.value ("1");
+	json.value ("2");
+	json.end_array ();
+	boost::property_tree::ptree entry;
+	entry.put ("a", "1");
+	entry.put ("b.c", "2");
+	json.key ("entry");
+	json.write (entry);
+	// Empty children are written as "" the same as write_json
+	json.key ("empty");
+	json.begin_object ();
+	json.end_object ();
+	json.key ("empty_list");
+	json.begin_array ();
+	json.end_array ();
+	json.end_object ();
+	ASSERT_EQ ("{\"text\":\"quote \\\" slash \\\\ line\\n\\u0001\",\"list\":[\"1\",\"2\"],\"entry\":{\"a\":\"1\",\"b\":{\"c\":\"2\"}},\"empty\":\"\",\"empty_list\":\"\"}", output);
+	boost::property_tree::ptree tree;
+	std::stringstream stream (output);
+	boost::property_tree::read_json (stream, tree);
+	ASSERT_EQ ("quote \" slash \\ line\n\x01", tree.get<std::string> ("text"));
+	ASSERT_EQ (2, tree.get_child ("list").size ());
+	ASSERT_EQ ("2", tree.get<std::string> ("entry.b.c"));
+}
+
 TEST (rpc, frontier)
 {
 	btcb::system system (24000, 1);
@@ -1025,6 +1059,65 @@ TEST (rpc, history_count)
 	ASSERT_EQ (1, history_node.size ());
 }
 
+TEST (rpc, account_history_offset)
+{
+	btcb::system system (24000, 1);
+	system.wallet (0)->insert_adhoc (btcb::test_genesis_key.prv);
+	btcb::keypair key;
+	auto send1 (system.wallet (0)->send_action (btcb::test_genesis_key.pub, key.pub, 1));
+	ASSERT_NE (nullptr, send1);
+	auto send2 (system.wallet (0)->send_action (btcb::test_genesis_key.pub, key.pub, 1));
+	ASSERT_NE (nullptr, send2);
+	btcb::genesis genesis;
+	btcb::rpc rpc (system.io_ctx, *system.nodes[0], btcb::rpc_config (true));
+	rpc.start ();
+	boost::property_tree::ptree request;
+	request.put ("action", "account_history");
+	request.put ("account", btcb::test_genesis_key.pub.to_account ());
+	request.put ("offset", 1);
+	request.put ("count", 1);
+	{
+		test_response response (request, rpc, system.io_ctx);
+		system.deadline_set (5s);
+		while (response.status == 0)
+		{
+			ASSERT_NO_ERROR (system.poll ());
+		}
+		ASSERT_EQ (200, response.status);
+		auto & history_node (response.json.get_child ("history"));
+		ASSERT_EQ (1, history_node.size ());
+		ASSERT_EQ (send1->hash ().to_string (), history_node.begin ()->second.get<std::string> ("hash"));
+		ASSERT_EQ (genesis.hash ().to_string (), response.json.get<std::string> ("previous"));
+	}
+	// Paging forwards from the open block
+	request.put ("offset", 0);
+	request.put ("reverse", true);
+	{
+		test_response response (request, rpc, system.io_ctx);
+		system.deadline_set (5s);
+		while (response.status == 0)
+		{
+			ASSERT_NO_ERROR (system.poll ());
+		}
+		ASSERT_EQ (200, response.status);
+		auto & history_node (response.json.get_child ("history"));
+		ASSERT_EQ (1, history_node.size ());
+		ASSERT_EQ (genesis.hash ().to_string (), history_node.begin ()->second.get<std::string> ("hash"));
+		ASSERT_EQ (send1->hash ().to_string (), response.json.get<std::string> ("next"));
+	}
+	request.put ("offset", 3);
+	{
+		test_response response (request, rpc, system.io_ctx);
+		system.deadline_set (5s);
+		while (response.status == 0)
+		{
+			ASSERT_NO_ERROR (system.poll ());
+		}
+		ASSERT_EQ (200, response.status);
+		ASSERT_EQ (0, response.json.get_child ("history").size ());
+	}
+}
+
 TEST (rpc, process_block)
 {
 	btcb::system system (24000, 1);
@@ -1516,6 +1609,8 @@ TEST (rpc_config, serialization)
 	config1.enable_control = true;
 	config1.frontier_request_limit = 8192;
 	config1.chain_request_limit = 4096;
+	config1.max_requests_per_connection = 10;
+	config1.idle_timeout = std::chrono::seconds (5);
 	boost::property_tree::ptree tree;
 	config1.serialize_json (tree);
 	btcb::rpc_config config2;
@@ -1524,12 +1619,16 @@ TEST (rpc_config, serialization)
 	ASSERT_NE (config2.enable_control, config1.enable_control);
 	ASSERT_NE (config2.frontier_request_limit, config1.frontier_request_limit);
 	ASSERT_NE (config2.chain_request_limit, config1.chain_request_limit);
+	ASSERT_NE (config2.max_requests_per_connection, config1.max_requests_per_connection);
+	ASSERT_NE (config2.idle_timeout, config1.idle_timeout);
 	config2.deserialize_json (tree);
 	ASSERT_EQ (config2.address, config1.address);
 	ASSERT_EQ (config2.port, config1.port);
 	ASSERT_EQ (config2.enable_control, config1.enable_control);
 	ASSERT_EQ (config2.frontier_request_limit, config1.frontier_request_limit);
 	ASSERT_EQ (config2.chain_request_limit, config1.chain_request_limit);
+	ASSERT_EQ (config2.max_requests_per_connection, config1.max_requests_per_connection);
+	ASSERT_EQ (config2.idle_timeout, config1.idle_timeout);
 }
 
 TEST (rpc, search_pending)
@@ -1620,6 +1719,37 @@ TEST (rpc, work_generate)
 	ASSERT_FALSE (btcb::work_validate (hash1, work2));
 }
 
+TEST (rpc, work_generate_timeout)
+{
+	btcb::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	btcb::rpc rpc (system.io_ctx, node1, btcb::rpc_config (true));
+	rpc.start ();
+	btcb::block_hash hash1 (1);
+	boost::property_tree::ptree request1;
+	request1.put ("action", "work_generate");
+	request1.put ("hash", hash1.to_string ());
+	request1.put ("priority", "precache");
+	request1.put ("timeout", "0");
+	test_response response1 (request1, rpc, system.io_ctx);
+	system.deadline_set (5s);
+	while (response1.status == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (200, response1.status);
+	ASSERT_EQ ("Cancelled", response1.json.get<std::string> ("error"));
+	ASSERT_EQ (0, node1.work.size (btcb::work_priority::precache));
+	request1.put ("priority", "urgent");
+	test_response response2 (request1, rpc, system.io_ctx);
+	while (response2.status == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (200, response2.status);
+	ASSERT_EQ ("Bad work priority", response2.json.get<std::string> ("error"));
+}
+
 TEST (rpc, work_cancel)
 {
 	btcb::system system (24000, 1);
@@ -1652,6 +1782,29 @@ TEST (rpc, work_cancel)
 	}
 }
 
+TEST (rpc, work_queue)
+{
+	btcb::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	btcb::block_hash hash1 (1);
+	auto work (node1.work.generate (hash1));
+	ASSERT_FALSE (btcb::work_validate (hash1, work));
+	btcb::rpc rpc (system.io_ctx, node1, btcb::rpc_config (true));
+	rpc.start ();
+	boost::property_tree::ptree request1;
+	request1.put ("action", "work_queue");
+	test_response response1 (request1, rpc, system.io_ctx);
+	system.deadline_set (5s);
+	while (response1.status == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (200, response1.status);
+	ASSERT_EQ ("0", response1.json.get<std::string> ("interactive.queued"));
+	ASSERT_LE (1, response1.json.get<uint64_t> ("interactive.generated"));
+	ASSERT_EQ ("0", response1.json.get<std::string> ("precache.queued"));
+}
+
 TEST (rpc, work_peer_bad)
 {
 	btcb::system system (24000, 2);
@@ -1764,6 +1917,210 @@ TEST (rpc, block_count)
 	ASSERT_EQ ("0", response1.json.get<std::string> ("unchecked"));
 }
 
+TEST (rpc, unchecked_cache)
+{
+	btcb::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	auto block (std::make_shared<btcb::send_block> (1, 1, 2, btcb::keypair ().prv, 4, system.work.generate (1)));
+	node1.process_active (block);
+	node1.block_processor.flush ();
+	btcb::rpc rpc (system.io_ctx, node1, btcb::rpc_config (true));
+	rpc.start ();
+	boost::property_tree::ptree request1;
+	request1.put ("action", "unchecked_cache");
+	test_response response1 (request1, rpc, system.io_ctx);
+	system.deadline_set (5s);
+	while (response1.status == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (200, response1.status);
+	ASSERT_EQ ("1", response1.json.get<std::string> ("blocks"));
+	ASSERT_EQ ("0", response1.json.get<std::string> ("stored"));
+	ASSERT_EQ (node1.unchecked.max_size (), response1.json.get<size_t> ("blocks_max"));
+	boost::property_tree::ptree request2;
+	request2.put ("action", "unchecked_get");
+	request2.put ("hash", block->hash ().to_string ());
+	test_response response2 (request2, rpc, system.io_ctx);
+	while (response2.status == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (200, response2.status);
+	ASSERT_FALSE (response2.json.get<std::string> ("contents").empty ());
+}
+
+TEST (rpc, stats_histograms)
+{
+	btcb::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	btcb::rpc rpc (system.io_ctx, node1, btcb::rpc_config (true));
+	rpc.start ();
+	boost::property_tree::ptree request1;
+	request1.put ("action", "block_count");
+	for (auto i (0); i < 2; ++i)
+	{
+		test_response response1 (request1, rpc, system.io_ctx);
+		system.deadline_set (5s);
+		while (response1.status == 0)
+		{
+			ASSERT_NO_ERROR (system.poll ());
+		}
+		ASSERT_EQ (200, response1.status);
+	}
+	// Handlers are returned to the pool once the response has been written
+	system.deadline_set (5s);
+	while (rpc.handlers->size () == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	boost::property_tree::ptree request2;
+	request2.put ("action", "stats");
+	request2.put ("type", "histograms");
+	test_response response2 (request2, rpc, system.io_ctx);
+	while (response2.status == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (200, response2.status);
+	auto found (false);
+	for (auto & i : response2.json.get_child ("entries"))
+	{
+		if (i.second.get<std::string> ("name") == "rpc_block_count")
+		{
+			ASSERT_EQ (2, i.second.get<uint64_t> ("count"));
+			found = true;
+		}
+	}
+	ASSERT_TRUE (found);
+	boost::property_tree::ptree request3;
+	request3.put ("action", "no_such_action");
+	test_response response3 (request3, rpc, system.io_ctx);
+	while (response3.status == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (200, response3.status);
+	ASSERT_EQ ("Unknown command", response3.json.get<std::string> ("error"));
+}
+
+TEST (rpc, keep_alive)
+{
+	btcb::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	btcb::rpc_config config (true);
+	config.max_requests_per_connection = 2;
+	btcb::rpc rpc (system.io_ctx, node1, config);
+	rpc.start ();
+	boost::property_tree::ptree request;
+	request.put ("action", "block_count");
+	std::stringstream ostream;
+	boost::property_tree::write_json (ostream, request);
+	boost::beast::http::request<boost::beast::http::string_body> req;
+	req.method (boost::beast::http::verb::post);
+	req.target ("/");
+	req.version (11);
+	req.body () = ostream.str ();
+	req.prepare_payload ();
+	// Two requests pipelined on one connection, the connection is closed after the second as it reaches the limit
+	std::stringstream pipelined;
+	pipelined << req << req;
+	std::vector<boost::beast::http::response<boost::beast::http::string_body>> responses;
+	boost::system::error_code last_error;
+	std::atomic<bool> done (false);
+	boost::thread client ([&]() {
+		boost::asio::io_context io_ctx;
+		boost::asio::ip::tcp::socket sock (io_ctx);
+		sock.connect (btcb::tcp_endpoint (boost::asio::ip::address_v6::loopback (), rpc.config.port));
+		boost::asio::write (sock, boost::asio::buffer (pipelined.str ()));
+		boost::beast::flat_buffer buffer;
+		while (!last_error)
+		{
+			boost::beast::http::response<boost::beast::http::string_body> response;
+			boost::beast::http::read (sock, buffer, response, last_error);
+			if (!last_error)
+			{
+				responses.push_back (response);
+			}
+		}
+		done = true;
+	});
+	system.deadline_set (10s);
+	while (!done)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	client.join ();
+	ASSERT_EQ (2, responses.size ());
+	ASSERT_TRUE (responses[0].keep_alive ());
+	ASSERT_FALSE (responses[1].keep_alive ());
+	ASSERT_EQ (boost::beast::http::error::end_of_stream, last_error);
+}
+
+TEST (rpc, idle_timeout)
+{
+	btcb::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	btcb::rpc_config config (true);
+	config.idle_timeout = std::chrono::seconds (1);
+	btcb::rpc rpc (system.io_ctx, node1, config);
+	rpc.start ();
+	boost::asio::ip::tcp::socket sock (system.io_ctx);
+	auto closed (false);
+	std::array<uint8_t, 1> byte;
+	sock.async_connect (btcb::tcp_endpoint (boost::asio::ip::address_v6::loopback (), rpc.config.port), [&sock, &closed, &byte](boost::system::error_code const & ec) {
+		ASSERT_FALSE (ec);
+		sock.async_read_some (boost::asio::buffer (byte), [&closed](boost::system::error_code const & ec, size_t size_a) {
+			closed = true;
+		});
+	});
+	system.deadline_set (10s);
+	while (!closed)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+}
+
+TEST (rpc, json_depth)
+{
+	btcb::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	btcb::rpc_config config (true);
+	config.max_json_depth = 2;
+	btcb::rpc rpc (system.io_ctx, node1, config);
+	rpc.start ();
+	// Brackets inside strings and sibling arrays don't add to the depth
+	boost::property_tree::ptree request1;
+	request1.put ("action", "block_count");
+	request1.put ("ignored", "[[[{{{");
+	boost::property_tree::ptree list;
+	boost::property_tree::ptree entry;
+	entry.put ("", "1");
+	list.push_back (std::make_pair ("", entry));
+	request1.add_child ("first", list);
+	request1.add_child ("second", list);
+	test_response response1 (request1, rpc, system.io_ctx);
+	system.deadline_set (5s);
+	while (response1.status == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (200, response1.status);
+	ASSERT_EQ (1, response1.json.count ("count"));
+	boost::property_tree::ptree request2;
+	request2.put ("action", "block_count");
+	boost::property_tree::ptree nested;
+	nested.add_child ("inner", list);
+	request2.add_child ("outer", nested);
+	test_response response2 (request2, rpc, system.io_ctx);
+	while (response2.status == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (200, response2.status);
+	ASSERT_EQ ("Max JSON depth exceeded", response2.json.get<std::string> ("error"));
+}
+
 TEST (rpc, frontier_count)
 {
 	btcb::system system (24000, 1);
@@ -2962,6 +3319,80 @@ TEST (rpc, delegators)
 	ASSERT_EQ ("340282366920938463463374607431768211355", delegators.get<std::string> (key.pub.to_account ()));
 }
 
+TEST (rpc, streamed_empty)
+{
+	btcb::system system (24000, 1);
+	btcb::keypair key;
+	btcb::rpc rpc (system.io_ctx, *system.nodes[0], btcb::rpc_config (true));
+	rpc.start ();
+	// Empty results are written as "" the same as the property tree responses they replaced
+	std::vector<std::pair<boost::property_tree::ptree, std::string>> requests;
+	boost::property_tree::ptree request1;
+	request1.put ("action", "delegators");
+	request1.put ("account", key.pub.to_account ());
+	requests.push_back (std::make_pair (request1, "\"delegators\":\"\""));
+	boost::property_tree::ptree request2;
+	request2.put ("action", "unchecked");
+	request2.put ("count", "1");
+	requests.push_back (std::make_pair (request2, "\"blocks\":\"\""));
+	boost::property_tree::ptree request3;
+	request3.put ("action", "frontiers");
+	request3.put ("account", btcb::account (std::numeric_limits<btcb::uint256_t>::max ()).to_account ());
+	request3.put ("count", "1");
+	requests.push_back (std::make_pair (request3, "\"frontiers\":\"\""));
+	for (auto & request : requests)
+	{
+		test_response response (request.first, rpc, system.io_ctx);
+		system.deadline_set (5s);
+		while (response.status == 0)
+		{
+			ASSERT_NO_ERROR (system.poll ());
+		}
+		ASSERT_EQ (200, response.status);
+		ASSERT_NE (std::string::npos, response.resp.body ().find (request.second)) << response.resp.body ();
+	}
+}
+
+TEST (rpc, delegators_paging)
+{
+	btcb::system system (24000, 1);
+	btcb::keypair key;
+	auto & node1 (*system.nodes[0]);
+	auto latest (node1.latest (btcb::test_genesis_key.pub));
+	btcb::send_block send (latest, key.pub, 100, btcb::test_genesis_key.prv, btcb::test_genesis_key.pub, node1.work_generate_blocking (latest));
+	ASSERT_EQ (btcb::process_result::progress, node1.process (send).code);
+	btcb::open_block open (send.hash (), btcb::test_genesis_key.pub, key.pub, key.prv, key.pub, node1.work_generate_blocking (key.pub));
+	ASSERT_EQ (btcb::process_result::progress, node1.process (open).code);
+	btcb::rpc rpc (system.io_ctx, node1, btcb::rpc_config (true));
+	rpc.start ();
+	auto first (std::min (key.pub, btcb::test_genesis_key.pub));
+	auto second (std::max (key.pub, btcb::test_genesis_key.pub));
+	boost::property_tree::ptree request;
+	request.put ("action", "delegators");
+	request.put ("account", btcb::test_genesis_key.pub.to_account ());
+	request.put ("count", "1");
+	test_response response1 (request, rpc, system.io_ctx);
+	system.deadline_set (5s);
+	while (response1.status == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (200, response1.status);
+	auto & delegators1 (response1.json.get_child ("delegators"));
+	ASSERT_EQ (1, delegators1.size ());
+	ASSERT_EQ (first.to_account (), delegators1.begin ()->first);
+	request.put ("start", second.to_account ());
+	test_response response2 (request, rpc, system.io_ctx);
+	while (response2.status == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (200, response2.status);
+	auto & delegators2 (response2.json.get_child ("delegators"));
+	ASSERT_EQ (1, delegators2.size ());
+	ASSERT_EQ (second.to_account (), delegators2.begin ()->first);
+}
+
 TEST (rpc, delegators_count)
 {
 	btcb::system system (24000, 1);
@@ -70,3 +70,43 @@ TEST (signature_checker, one)
 	checker.add (check);
 	promise.get_future ().wait ();
 }
+
+TEST (signature_checker, many_multi_threaded)
+{
+	btcb::keypair key;
+	btcb::state_block block (key.pub, 0, key.pub, 0, 0, key.prv, key.pub, 0);
+	btcb::state_block invalid_block (key.pub, 0, key.pub, 0, 0, key.prv, key.pub, 0);
+	invalid_block.signature.bytes[31] ^= 0x1;
+	btcb::signature_checker checker (4);
+	std::promise<void> promise;
+	// Not a multiple of the batch size so the last chunk is partial
+	size_t size (btcb::signature_checker::batch_size * 4 + 17);
+	std::vector<btcb::uint256_union> hashes;
+	hashes.reserve (size);
+	std::vector<unsigned char const *> messages;
+	messages.reserve (size);
+	std::vector<size_t> lengths;
+	lengths.reserve (size);
+	std::vector<unsigned char const *> pub_keys;
+	pub_keys.reserve (size);
+	std::vector<unsigned char const *> signatures;
+	signatures.reserve (size);
+	std::vector<int> verifications;
+	verifications.resize (size, -1);
+	for (auto i (0); i < size; ++i)
+	{
+		auto & current (i % 3 == 0 ? invalid_block : block);
+		hashes.push_back (current.hash ());
+		messages.push_back (hashes.back ().bytes.data ());
+		lengths.push_back (sizeof (decltype (hashes)::value_type));
+		pub_keys.push_back (current.hashables.account.bytes.data ());
+		signatures.push_back (current.signature.bytes.data ());
+	}
+	btcb::signature_check_set check = { size, messages.data (), lengths.data (), pub_keys.data (), signatures.data (), verifications.data (), &promise };
+	checker.add (check);
+	promise.get_future ().wait ();
+	for (auto i (0); i < size; ++i)
+	{
+		ASSERT_EQ (i % 3 == 0 ? 0 : 1, verifications[i]);
+	}
+}
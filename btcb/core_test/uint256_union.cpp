@@ -405,6 +405,31 @@ TEST (uint256_union, account_encode_lex)
 	}
 }
 
+TEST (uint256_union, encode_accounts)
+{
+	std::vector<btcb::account> accounts;
+	accounts.push_back (btcb::account (0));
+	accounts.push_back (btcb::account ("ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"));
+	for (auto i (0); i < 8; ++i)
+	{
+		accounts.push_back (btcb::keypair ().pub);
+	}
+	std::string buffer (accounts.size () * btcb::account_text_size, '\0');
+	btcb::encode_accounts (accounts.data (), accounts.size (), &buffer[0]);
+	ASSERT_EQ ("bcb_1111111111111111111111111111111111111111111111111111hifc8npp", buffer.substr (0, btcb::account_text_size));
+	for (size_t i (0); i < accounts.size (); ++i)
+	{
+		auto text (buffer.substr (i * btcb::account_text_size, btcb::account_text_size));
+		ASSERT_EQ (accounts[i].to_account (), text);
+		btcb::account decoded;
+		ASSERT_FALSE (decoded.decode_account (text));
+		ASSERT_EQ (accounts[i], decoded);
+		// Changing the last digit breaks the checksum
+		text.back () = text.back () == '1' ? '3' : '1';
+		ASSERT_TRUE (decoded.decode_account (text));
+	}
+}
+
 TEST (uint256_union, bounds)
 {
 	btcb::uint256_union key;
@@ -2,6 +2,9 @@
 
 #include <btcb/node/node.hpp>
 #include <btcb/node/wallet.hpp>
+#include <btcb/node/xorshift.hpp>
+
+#include <future>
 
 TEST (work, one)
 {
@@ -25,6 +28,36 @@ TEST (work, validate)
 	ASSERT_LT (btcb::work_pool::publish_threshold, difficulty);
 }
 
+TEST (work, kernels)
+{
+	btcb::xorshift1024star rng;
+	btcb::random_pool.GenerateBlock (reinterpret_cast<uint8_t *> (rng.s.data ()), rng.s.size () * sizeof (decltype (rng.s)::value_type));
+	ASSERT_TRUE (btcb::work_kernel_supported (btcb::work_kernel::scalar));
+	ASSERT_TRUE (btcb::work_kernel_supported (btcb::work_kernel_best ()));
+	for (auto kernel : { btcb::work_kernel::scalar, btcb::work_kernel::avx2 })
+	{
+		if (btcb::work_kernel_supported (kernel))
+		{
+			for (auto i (0); i < 64; ++i)
+			{
+				btcb::uint256_union root;
+				btcb::random_pool.GenerateBlock (root.bytes.data (), root.bytes.size ());
+				std::array<uint64_t, btcb::work_lanes> nonces;
+				std::array<uint64_t, btcb::work_lanes> values;
+				for (auto & nonce : nonces)
+				{
+					nonce = rng.next ();
+				}
+				btcb::work_values (kernel, root, nonces.data (), values.data ());
+				for (size_t j (0); j < btcb::work_lanes; ++j)
+				{
+					ASSERT_EQ (btcb::work_value (root, nonces[j]), values[j]);
+				}
+			}
+		}
+	}
+}
+
 TEST (work, cancel)
 {
 	btcb::work_pool pool (std::numeric_limits<unsigned>::max (), nullptr);
@@ -60,6 +93,65 @@ TEST (work, cancel_many)
 	pool.cancel (key1);
 }
 
+TEST (work, concurrent_roots)
+{
+	btcb::work_pool pool (std::numeric_limits<unsigned>::max (), nullptr);
+	btcb::uint256_union key1 (1);
+	btcb::uint256_union key2 (2);
+	std::promise<bool> cancelled;
+	// Work for key1 is practically never found, it mustn't hold up key2 queued behind it
+	pool.generate (key1, [&cancelled](boost::optional<uint64_t> work_a) {
+		cancelled.set_value (!work_a);
+	},
+	std::numeric_limits<uint64_t>::max ());
+	auto work (pool.generate (key2));
+	ASSERT_FALSE (btcb::work_validate (key2, work));
+	ASSERT_EQ (1, pool.size (btcb::work_priority::interactive));
+	pool.cancel (key1);
+	ASSERT_TRUE (cancelled.get_future ().get ());
+	ASSERT_EQ (0, pool.size (btcb::work_priority::interactive));
+	ASSERT_EQ (1, pool.generated[static_cast<size_t> (btcb::work_priority::interactive)].load ());
+}
+
+TEST (work, priority)
+{
+	btcb::work_pool pool (std::numeric_limits<unsigned>::max (), nullptr);
+	std::atomic<unsigned> precached (0);
+	for (auto i (1); i <= 64; ++i)
+	{
+		pool.generate (btcb::uint256_union (i), [&precached](boost::optional<uint64_t> work_a) {
+			++precached;
+		},
+		std::numeric_limits<uint64_t>::max (), btcb::work_priority::precache);
+	}
+	ASSERT_EQ (64, pool.size (btcb::work_priority::precache));
+	// Interactive requests go ahead of all queued precaching
+	btcb::uint256_union key (100);
+	auto work (pool.generate (key));
+	ASSERT_FALSE (btcb::work_validate (key, work));
+	ASSERT_EQ (0, precached.load ());
+	ASSERT_EQ (64, pool.size (btcb::work_priority::precache));
+	for (auto i (1); i <= 64; ++i)
+	{
+		pool.cancel (btcb::uint256_union (i));
+	}
+	ASSERT_EQ (64, precached.load ());
+}
+
+TEST (work, deadline)
+{
+	btcb::work_pool pool (std::numeric_limits<unsigned>::max (), nullptr);
+	std::promise<bool> expired;
+	pool.generate (btcb::uint256_union (1), [&expired](boost::optional<uint64_t> work_a) {
+		expired.set_value (!work_a);
+	},
+	std::numeric_limits<uint64_t>::max (), btcb::work_priority::interactive, std::chrono::steady_clock::now () + std::chrono::milliseconds (100));
+	auto future (expired.get_future ());
+	ASSERT_EQ (std::future_status::ready, future.wait_for (std::chrono::seconds (5)));
+	ASSERT_TRUE (future.get ());
+	ASSERT_EQ (0, pool.size (btcb::work_priority::interactive));
+}
+
 TEST (work, DISABLED_opencl)
 {
 	btcb::logging logging;
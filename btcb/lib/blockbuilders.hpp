@@ -52,6 +52,7 @@ public:
 			static_cast<BUILDER *> (this)->validate ();
 		}
 		assert (!ec);
+		block->refresh ();
 		return std::move (block);
 	}
 
@@ -63,6 +64,7 @@ public:
 			static_cast<BUILDER *> (this)->validate ();
 		}
 		ec = this->ec;
+		block->refresh ();
 		return std::move (block);
 	}
 
@@ -77,6 +79,7 @@ public:
 	/** Sign the block using the \p private_key and \p public_key */
 	inline abstract_builder & sign (btcb::raw_key const & private_key, btcb::public_key const & public_key)
 	{
+		block->refresh ();
 		block->signature = btcb::sign_message (private_key, public_key, block->hash ());
 		build_state |= build_flags::signature_present;
 		return *this;
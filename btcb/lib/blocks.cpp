@@ -60,32 +60,83 @@ std::string btcb::block::to_json ()
 	return result;
 }
 
+btcb::block_hash_cache::block_hash_cache (btcb::block_hash_cache const &) :
+block_hash_cache ()
+{
+}
+
+btcb::block_hash_cache & btcb::block_hash_cache::operator= (btcb::block_hash_cache const &)
+{
+	clear ();
+	return *this;
+}
+
+bool btcb::block_hash_cache::get (btcb::block_hash & hash_a) const
+{
+	auto result (state.load (std::memory_order_acquire) == ready);
+	if (result)
+	{
+		hash_a = value;
+	}
+	return result;
+}
+
+void btcb::block_hash_cache::set (btcb::block_hash const & hash_a) const
+{
+	auto expected (empty);
+	if (state.compare_exchange_strong (expected, writing, std::memory_order_acquire))
+	{
+		value = hash_a;
+		state.store (ready, std::memory_order_release);
+	}
+}
+
+void btcb::block_hash_cache::clear ()
+{
+	state.store (empty, std::memory_order_release);
+}
+
 btcb::block_hash btcb::block::hash () const
 {
 	btcb::uint256_union result;
-	blake2b_state hash_l;
-	auto status (blake2b_init (&hash_l, sizeof (result.bytes)));
-	assert (status == 0);
-	hash (hash_l);
-	status = blake2b_final (&hash_l, result.bytes.data (), sizeof (result.bytes));
-	assert (status == 0);
+	if (!cached_hash.get (result))
+	{
+		blake2b_state hash_l;
+		auto status (blake2b_init (&hash_l, sizeof (result.bytes)));
+		assert (status == 0);
+		hash (hash_l);
+		status = blake2b_final (&hash_l, result.bytes.data (), sizeof (result.bytes));
+		assert (status == 0);
+		cached_hash.set (result);
+	}
 	return result;
 }
 
 btcb::block_hash btcb::block::full_hash () const
 {
 	btcb::block_hash result;
-	blake2b_state state;
-	blake2b_init (&state, sizeof (result.bytes));
-	blake2b_update (&state, hash ().bytes.data (), sizeof (hash ()));
-	auto signature (block_signature ());
-	blake2b_update (&state, signature.bytes.data (), sizeof (signature));
-	auto work (block_work ());
-	blake2b_update (&state, &work, sizeof (work));
-	blake2b_final (&state, result.bytes.data (), sizeof (result.bytes));
+	if (!cached_full_hash.get (result))
+	{
+		blake2b_state state;
+		blake2b_init (&state, sizeof (result.bytes));
+		auto hash_l (hash ());
+		blake2b_update (&state, hash_l.bytes.data (), sizeof (hash_l));
+		auto signature (block_signature ());
+		blake2b_update (&state, signature.bytes.data (), sizeof (signature));
+		auto work (block_work ());
+		blake2b_update (&state, &work, sizeof (work));
+		blake2b_final (&state, result.bytes.data (), sizeof (result.bytes));
+		cached_full_hash.set (result);
+	}
 	return result;
 }
 
+void btcb::block::refresh ()
+{
+	cached_hash.clear ();
+	cached_full_hash.clear ();
+}
+
 void btcb::send_block::visit (btcb::block_visitor & visitor_a) const
 {
 	visitor_a.send_block (*this);
@@ -104,6 +155,7 @@ uint64_t btcb::send_block::block_work () const
 void btcb::send_block::block_work_set (uint64_t work_a)
 {
 	work = work_a;
+	cached_full_hash.clear ();
 }
 
 btcb::send_hashables::send_hashables (btcb::block_hash const & previous_a, btcb::account const & destination_a, btcb::amount const & balance_a) :
@@ -208,6 +260,7 @@ bool btcb::send_block::deserialize (btcb::stream & stream_a)
 			}
 		}
 	}
+	refresh ();
 	return error;
 }
 
@@ -244,6 +297,7 @@ bool btcb::send_block::deserialize_json (boost::property_tree::ptree const & tre
 	{
 		error = true;
 	}
+	refresh ();
 	return error;
 }
 
@@ -356,6 +410,7 @@ btcb::signature btcb::send_block::block_signature () const
 void btcb::send_block::signature_set (btcb::uint512_union const & signature_a)
 {
 	signature = signature_a;
+	cached_full_hash.clear ();
 }
 
 btcb::open_hashables::open_hashables (btcb::block_hash const & source_a, btcb::account const & representative_a, btcb::account const & account_a) :
@@ -471,6 +526,7 @@ uint64_t btcb::open_block::block_work () const
 void btcb::open_block::block_work_set (uint64_t work_a)
 {
 	work = work_a;
+	cached_full_hash.clear ();
 }
 
 btcb::block_hash btcb::open_block::previous () const
@@ -523,6 +579,7 @@ bool btcb::open_block::deserialize (btcb::stream & stream_a)
 			}
 		}
 	}
+	refresh ();
 	return error;
 }
 
@@ -559,6 +616,7 @@ bool btcb::open_block::deserialize_json (boost::property_tree::ptree const & tre
 	{
 		error = true;
 	}
+	refresh ();
 	return error;
 }
 
@@ -615,6 +673,7 @@ btcb::signature btcb::open_block::block_signature () const
 void btcb::open_block::signature_set (btcb::uint512_union const & signature_a)
 {
 	signature = signature_a;
+	cached_full_hash.clear ();
 }
 
 btcb::change_hashables::change_hashables (btcb::block_hash const & previous_a, btcb::account const & representative_a) :
@@ -711,6 +770,7 @@ uint64_t btcb::change_block::block_work () const
 void btcb::change_block::block_work_set (uint64_t work_a)
 {
 	work = work_a;
+	cached_full_hash.clear ();
 }
 
 btcb::block_hash btcb::change_block::previous () const
@@ -756,6 +816,7 @@ bool btcb::change_block::deserialize (btcb::stream & stream_a)
 			}
 		}
 	}
+	refresh ();
 	return error;
 }
 
@@ -787,6 +848,7 @@ bool btcb::change_block::deserialize_json (boost::property_tree::ptree const & t
 	{
 		error = true;
 	}
+	refresh ();
 	return error;
 }
 
@@ -856,6 +918,7 @@ btcb::signature btcb::change_block::block_signature () const
 void btcb::change_block::signature_set (btcb::uint512_union const & signature_a)
 {
 	signature = signature_a;
+	cached_full_hash.clear ();
 }
 
 btcb::state_hashables::state_hashables (btcb::account const & account_a, btcb::block_hash const & previous_a, btcb::account const & representative_a, btcb::amount const & balance_a, btcb::uint256_union const & link_a) :
@@ -993,6 +1056,7 @@ uint64_t btcb::state_block::block_work () const
 void btcb::state_block::block_work_set (uint64_t work_a)
 {
 	work = work_a;
+	cached_full_hash.clear ();
 }
 
 btcb::block_hash btcb::state_block::previous () const
@@ -1058,6 +1122,7 @@ bool btcb::state_block::deserialize (btcb::stream & stream_a)
 			}
 		}
 	}
+	refresh ();
 	return error;
 }
 
@@ -1104,6 +1169,7 @@ bool btcb::state_block::deserialize_json (boost::property_tree::ptree const & tr
 	{
 		error = true;
 	}
+	refresh ();
 	return error;
 }
 
@@ -1160,6 +1226,7 @@ btcb::signature btcb::state_block::block_signature () const
 void btcb::state_block::signature_set (btcb::uint512_union const & signature_a)
 {
 	signature = signature_a;
+	cached_full_hash.clear ();
 }
 
 std::shared_ptr<btcb::block> btcb::deserialize_block_json (boost::property_tree::ptree const & tree_a, btcb::block_uniquer * uniquer_a)
@@ -1302,6 +1369,33 @@ std::shared_ptr<btcb::block> btcb::deserialize_block (btcb::stream & stream_a, b
 	return result;
 }
 
+size_t btcb::block_size (btcb::block_type type_a)
+{
+	size_t result (0);
+	switch (type_a)
+	{
+		case btcb::block_type::send:
+			result = btcb::send_block::size;
+			break;
+		case btcb::block_type::receive:
+			result = btcb::receive_block::size;
+			break;
+		case btcb::block_type::open:
+			result = btcb::open_block::size;
+			break;
+		case btcb::block_type::change:
+			result = btcb::change_block::size;
+			break;
+		case btcb::block_type::state:
+			result = btcb::state_block::size;
+			break;
+		case btcb::block_type::invalid:
+		case btcb::block_type::not_a_block:
+			break;
+	}
+	return result;
+}
+
 void btcb::receive_block::visit (btcb::block_visitor & visitor_a) const
 {
 	visitor_a.receive_block (*this);
@@ -1329,6 +1423,7 @@ bool btcb::receive_block::deserialize (btcb::stream & stream_a)
 			}
 		}
 	}
+	refresh ();
 	return error;
 }
 
@@ -1360,6 +1455,7 @@ bool btcb::receive_block::deserialize_json (boost::property_tree::ptree const &
 	{
 		error = true;
 	}
+	refresh ();
 	return error;
 }
 
@@ -1445,6 +1541,7 @@ uint64_t btcb::receive_block::block_work () const
 void btcb::receive_block::block_work_set (uint64_t work_a)
 {
 	work = work_a;
+	cached_full_hash.clear ();
 }
 
 bool btcb::receive_block::operator== (btcb::block const & other_a) const
@@ -1503,6 +1600,7 @@ btcb::signature btcb::receive_block::block_signature () const
 void btcb::receive_block::signature_set (btcb::uint512_union const & signature_a)
 {
 	signature = signature_a;
+	cached_full_hash.clear ();
 }
 
 btcb::block_type btcb::receive_block::type () const
@@ -3,6 +3,7 @@
 #include <btcb/lib/numbers.hpp>
 
 #include <assert.h>
+#include <atomic>
 #include <blake2/blake2.h>
 #include <boost/property_tree/json_parser.hpp>
 #include <streambuf>
@@ -40,6 +41,28 @@ enum class block_type : uint8_t
 	change = 5,
 	state = 6
 };
+/**
+ * Lazily computed digest of a block. Copies start out empty so a cached value is never carried over to a block that is modified afterwards.
+ */
+class block_hash_cache
+{
+public:
+	block_hash_cache () = default;
+	block_hash_cache (btcb::block_hash_cache const &);
+	btcb::block_hash_cache & operator= (btcb::block_hash_cache const &);
+	// Returns true and fills the argument if a value has been cached
+	bool get (btcb::block_hash &) const;
+	// Caches the value unless another thread already did so
+	void set (btcb::block_hash const &) const;
+	void clear ();
+
+private:
+	static uint8_t constexpr empty = 0;
+	static uint8_t constexpr writing = 1;
+	static uint8_t constexpr ready = 2;
+	mutable std::atomic<uint8_t> state{ empty };
+	mutable btcb::block_hash value;
+};
 class block
 {
 public:
@@ -47,6 +70,8 @@ public:
 	btcb::block_hash hash () const;
 	// Return a digest of hashables and non-hashables in this block.
 	btcb::block_hash full_hash () const;
+	// Discard cached digests, must be called after modifying hashables, signature or work directly.
+	void refresh ();
 	std::string to_json ();
 	virtual void hash (blake2b_state &) const = 0;
 	virtual uint64_t block_work () const = 0;
@@ -69,6 +94,10 @@ public:
 	virtual void signature_set (btcb::uint512_union const &) = 0;
 	virtual ~block () = default;
 	virtual bool valid_predecessor (btcb::block const &) const = 0;
+
+protected:
+	btcb::block_hash_cache cached_hash;
+	btcb::block_hash_cache cached_full_hash;
 };
 class send_hashables
 {
@@ -337,6 +366,8 @@ private:
 };
 std::shared_ptr<btcb::block> deserialize_block (btcb::stream &, btcb::block_uniquer * = nullptr);
 std::shared_ptr<btcb::block> deserialize_block (btcb::stream &, btcb::block_type, btcb::block_uniquer * = nullptr);
+/** Serialized size of a block of type \p type_a excluding the type byte, 0 if it isn't a block type */
+size_t block_size (btcb::block_type type_a);
 std::shared_ptr<btcb::block> deserialize_block_json (boost::property_tree::ptree const &, btcb::block_uniquer * = nullptr);
 void serialize_block (btcb::stream &, btcb::block const &);
 }
@@ -124,6 +124,8 @@ std::string btcb::error_rpc_messages::message (int ev) const
 			return "Bad source";
 		case btcb::error_rpc::bad_timeout:
 			return "Bad timeout number";
+		case btcb::error_rpc::bad_work_priority:
+			return "Bad work priority";
 		case btcb::error_rpc::block_create_balance_mismatch:
 			return "Balance mismatch for previous block";
 		case btcb::error_rpc::block_create_key_required:
@@ -0,0 +1,166 @@
+#include <btcb/lib/jsonstream.hpp>
+
+#include <cassert>
+
+btcb::json_stream::json_stream (std::string & output_a) :
+output (output_a),
+keyed (false)
+{
+}
+
+void btcb::json_stream::begin_object ()
+{
+	separator ();
+	starts.push_back (output.size ());
+	output.push_back ('{');
+	nonempty.push_back (false);
+}
+
+void btcb::json_stream::end_object ()
+{
+	end ('}');
+}
+
+void btcb::json_stream::begin_array ()
+{
+	separator ();
+	starts.push_back (output.size ());
+	output.push_back ('[');
+	nonempty.push_back (false);
+}
+
+void btcb::json_stream::end_array ()
+{
+	end (']');
+}
+
+void btcb::json_stream::end (char close_a)
+{
+	assert (!nonempty.empty () && !keyed);
+	if (nonempty.back ())
+	{
+		output.push_back (close_a);
+	}
+	else
+	{
+		output.resize (starts.back ());
+		output.append ("\"\"");
+	}
+	nonempty.pop_back ();
+	starts.pop_back ();
+}
+
+void btcb::json_stream::key (std::string const & key_a)
+{
+	key (key_a.data (), key_a.size ());
+}
+
+void btcb::json_stream::key (char const * key_a, size_t size_a)
+{
+	separator ();
+	string (key_a, size_a);
+	output.push_back (':');
+	keyed = true;
+}
+
+void btcb::json_stream::value (std::string const & value_a)
+{
+	separator ();
+	string (value_a.data (), value_a.size ());
+}
+
+void btcb::json_stream::put (std::string const & key_a, std::string const & value_a)
+{
+	key (key_a);
+	value (value_a);
+}
+
+void btcb::json_stream::write (boost::property_tree::ptree const & tree_a)
+{
+	if (tree_a.empty ())
+	{
+		value (tree_a.data ());
+	}
+	else if (tree_a.front ().first.empty ())
+	{
+		begin_array ();
+		for (auto & i : tree_a)
+		{
+			write (i.second);
+		}
+		end_array ();
+	}
+	else
+	{
+		begin_object ();
+		for (auto & i : tree_a)
+		{
+			key (i.first);
+			write (i.second);
+		}
+		end_object ();
+	}
+}
+
+void btcb::json_stream::separator ()
+{
+	if (keyed)
+	{
+		keyed = false;
+	}
+	else if (!nonempty.empty ())
+	{
+		if (nonempty.back ())
+		{
+			output.push_back (',');
+		}
+		nonempty.back () = true;
+	}
+}
+
+void btcb::json_stream::string (char const * value_a, size_t size_a)
+{
+	static char const hex[] = "0123456789abcdef";
+	output.push_back ('"');
+	for (auto i (value_a), n (value_a + size_a); i != n; ++i)
+	{
+		auto c (*i);
+		switch (c)
+		{
+			case '"':
+				output.append ("\\\"");
+				break;
+			case '\\':
+				output.append ("\\\\");
+				break;
+			case '\b':
+				output.append ("\\b");
+				break;
+			case '\f':
+				output.append ("\\f");
+				break;
+			case '\n':
+				output.append ("\\n");
+				break;
+			case '\r':
+				output.append ("\\r");
+				break;
+			case '\t':
+				output.append ("\\t");
+				break;
+			default:
+				if (static_cast<unsigned char> (c) < 0x20)
+				{
+					output.append ("\\u00");
+					output.push_back (hex[(c >> 4) & 0xf]);
+					output.push_back (hex[c & 0xf]);
+				}
+				else
+				{
+					output.push_back (c);
+				}
+				break;
+		}
+	}
+	output.push_back ('"');
+}
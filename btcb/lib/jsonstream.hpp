@@ -0,0 +1,45 @@
+#pragma once
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <string>
+#include <vector>
+
+namespace btcb
+{
+/**
+ * Writes compact JSON straight into a string as it's produced, for responses too large to build as a property tree first.
+ * Values are always written as strings, the same as boost::property_tree::write_json, so either can produce a response.
+ */
+class json_stream
+{
+public:
+	json_stream (std::string &);
+	void begin_object ();
+	void end_object ();
+	void begin_array ();
+	void end_array ();
+	/** Starts a member of the enclosing object, followed by exactly one value, object, array or tree */
+	void key (std::string const &);
+	/** Same as key (std::string const &) for \p size_a characters at \p key_a, so keys can be written from a shared buffer */
+	void key (char const * key_a, size_t size_a);
+	void value (std::string const &);
+	/** Writes a string member of the enclosing object */
+	void put (std::string const & key_a, std::string const & value_a);
+	/** Writes \p tree_a the way write_json would, children with empty names become an array */
+	void write (boost::property_tree::ptree const & tree_a);
+
+private:
+	void separator ();
+	void string (char const *, size_t);
+	std::string & output;
+	/** Closes the innermost object or array, written as "" if it's empty the same as write_json does for a childless node */
+	void end (char);
+	/** One entry per open object or array, true once something has been written to it */
+	std::vector<bool> nonempty;
+	/** Offset of the opening bracket of each open object or array */
+	std::vector<size_t> starts;
+	/** Set after a key until its value starts */
+	bool keyed;
+};
+}
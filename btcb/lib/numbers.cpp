@@ -10,6 +10,14 @@
 
 thread_local CryptoPP::AutoSeededRandomPool btcb::random_pool;
 
+#if defined(__GNUC__) && defined(__x86_64__)
+// Built by ed25519-donna/ed25519-ifma.c under the same condition
+#define BTCB_ED25519_IFMA
+extern "C" {
+int ed25519_sign_open_batch_ifma (const unsigned char ** m, size_t * mlen, const unsigned char ** pk, const unsigned char ** RS, size_t num, int * valid);
+}
+#endif
+
 namespace
 {
 char const * base58_reverse ("~012345678~~~~~~~9:;<=>?@~ABCDE~FGHIJKLMNOP~~~~~~QRSTUVWXYZ[~\\]^_`abcdefghi");
@@ -22,12 +30,6 @@ uint8_t base58_decode (char value)
 }
 char const * account_lookup ("13456789abcdefghijkmnopqrstuwxyz");
 char const * account_reverse ("~0~1234567~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~89:;<=>?@AB~CDEFGHIJK~LMNO~~~~~");
-char account_encode (uint8_t value)
-{
-	assert (value < 32);
-	auto result (account_lookup[value]);
-	return result;
-}
 uint8_t account_decode (char value)
 {
 	assert (value >= '0');
@@ -39,28 +41,57 @@ uint8_t account_decode (char value)
 	}
 	return result;
 }
-}
+// Length of the base32 part of an account, 4 zero bits then the 256 bit key and 40 bit checksum
+size_t constexpr account_digits = 60;
+size_t constexpr account_check_size = 5;
 
-void btcb::uint256_union::encode_account (std::string & destination_a) const
+std::array<uint8_t, account_check_size> account_check (btcb::uint256_union const & account_a)
 {
-	assert (destination_a.empty ());
-	destination_a.reserve (64);
-	uint64_t check (0);
+	std::array<uint8_t, account_check_size> result;
 	blake2b_state hash;
-	blake2b_init (&hash, 5);
-	blake2b_update (&hash, bytes.data (), bytes.size ());
-	blake2b_final (&hash, reinterpret_cast<uint8_t *> (&check), 5);
-	btcb::uint512_t number_l (number ());
-	number_l <<= 40;
-	number_l |= btcb::uint512_t (check);
-	for (auto i (0); i < 60; ++i)
+	blake2b_init (&hash, result.size ());
+	blake2b_update (&hash, account_a.bytes.data (), account_a.bytes.size ());
+	blake2b_final (&hash, result.data (), result.size ());
+	return result;
+}
+
+/*
+ * Writes the 60 digits of \p account_a, most significant first. The checksum is a little endian number in the
+ * low 40 bits so its bytes are fed in reverse, each digit is then a 5 bit group read straight from the byte stream.
+ */
+void account_digits_encode (btcb::uint256_union const & account_a, char * destination_a)
+{
+	auto check (account_check (account_a));
+	uint32_t buffer (0);
+	// The 4 leading zero bits
+	int bits (4);
+	auto digit (destination_a);
+	auto push = [&buffer, &bits, &digit](uint8_t byte_a) {
+		buffer = (buffer << 8) | byte_a;
+		bits += 8;
+		while (bits >= 5)
+		{
+			bits -= 5;
+			*digit++ = account_lookup[(buffer >> bits) & 0x1f];
+		}
+	};
+	for (auto byte : account_a.bytes)
 	{
-		uint8_t r (number_l & static_cast<uint8_t> (0x1f));
-		number_l >>= 5;
-		destination_a.push_back (account_encode (r));
+		push (byte);
 	}
-	destination_a.append ("_bcb"); // bcb_
-	std::reverse (destination_a.begin (), destination_a.end ());
+	for (auto i (check.rbegin ()), n (check.rend ()); i != n; ++i)
+	{
+		push (*i);
+	}
+	assert (bits == 0 && digit == destination_a + account_digits);
+}
+}
+
+void btcb::uint256_union::encode_account (std::string & destination_a) const
+{
+	assert (destination_a.empty ());
+	destination_a.resize (btcb::account_text_size);
+	btcb::encode_accounts (this, 1, &destination_a[0]);
 }
 
 std::string btcb::uint256_union::to_account () const
@@ -70,6 +101,16 @@ std::string btcb::uint256_union::to_account () const
 	return result;
 }
 
+void btcb::encode_accounts (btcb::uint256_union const * accounts_a, size_t count_a, char * destination_a)
+{
+	for (size_t i (0); i < count_a; ++i)
+	{
+		auto destination (destination_a + i * btcb::account_text_size);
+		std::copy_n ("bcb_", 4, destination);
+		account_digits_encode (accounts_a[i], destination + 4);
+	}
+}
+
 bool btcb::uint256_union::decode_account (std::string const & source_a)
 {
 	auto error (source_a.size () < 5);
@@ -85,32 +126,38 @@ bool btcb::uint256_union::decode_account (std::string const & source_a)
 				auto i (source_a.begin () + (bcb_prefix ? 4 : 5));
 				if (*i == '1' || *i == '3')
 				{
-					btcb::uint512_t number_l;
+					// The key followed by the checksum bytes, most significant first
+					std::array<uint8_t, 32 + account_check_size> decoded;
+					auto byte_l (decoded.begin ());
+					uint32_t buffer (0);
+					// Drops the 4 zero bits at the top of the first digit, which is '1' or '3'
+					int bits (-4);
 					for (auto j (source_a.end ()); !error && i != j; ++i)
 					{
 						uint8_t character (*i);
 						error = character < 0x30 || character >= 0x80;
 						if (!error)
 						{
-							uint8_t byte (account_decode (character));
-							error = byte == '~';
+							uint8_t digit (account_decode (character));
+							error = digit == '~';
 							if (!error)
 							{
-								number_l <<= 5;
-								number_l += byte;
+								buffer = (buffer << 5) | digit;
+								bits += 5;
+								if (bits >= 8)
+								{
+									bits -= 8;
+									*byte_l++ = static_cast<uint8_t> (buffer >> bits);
+								}
 							}
 						}
 					}
 					if (!error)
 					{
-						*this = (number_l >> 40).convert_to<btcb::uint256_t> ();
-						uint64_t check (number_l & static_cast<uint64_t> (0xffffffffff));
-						uint64_t validation (0);
-						blake2b_state hash;
-						blake2b_init (&hash, 5);
-						blake2b_update (&hash, bytes.data (), bytes.size ());
-						blake2b_final (&hash, reinterpret_cast<uint8_t *> (&validation), 5);
-						error = check != validation;
+						assert (bits == 0 && byte_l == decoded.end ());
+						std::copy_n (decoded.begin (), bytes.size (), bytes.begin ());
+						auto validation (account_check (*this));
+						error = !std::equal (validation.rbegin (), validation.rend (), decoded.begin () + bytes.size ());
 					}
 				}
 				else
@@ -420,9 +467,65 @@ bool btcb::validate_message (btcb::public_key const & public_key, btcb::uint256_
 	return result;
 }
 
+bool btcb::signature_backend_supported (btcb::signature_backend backend_a)
+{
+	bool result (false);
+	switch (backend_a)
+	{
+		case btcb::signature_backend::donna:
+			result = true;
+			break;
+		case btcb::signature_backend::donna_ifma:
+#ifdef BTCB_ED25519_IFMA
+			result = __builtin_cpu_supports ("avx512ifma");
+#endif
+			break;
+	}
+	return result;
+}
+
+btcb::signature_backend btcb::signature_backend_best ()
+{
+	static btcb::signature_backend const result (btcb::signature_backend_supported (btcb::signature_backend::donna_ifma) ? btcb::signature_backend::donna_ifma : btcb::signature_backend::donna);
+	return result;
+}
+
+std::string btcb::signature_backend_name (btcb::signature_backend backend_a)
+{
+	std::string result;
+	switch (backend_a)
+	{
+		case btcb::signature_backend::donna:
+			result = "donna";
+			break;
+		case btcb::signature_backend::donna_ifma:
+			result = "donna-ifma";
+			break;
+	}
+	return result;
+}
+
 bool btcb::validate_message_batch (const unsigned char ** m, size_t * mlen, const unsigned char ** pk, const unsigned char ** RS, size_t num, int * valid)
 {
-	bool result (0 == ed25519_sign_open_batch (m, mlen, pk, RS, num, valid));
+	return btcb::validate_message_batch (btcb::signature_backend_best (), m, mlen, pk, RS, num, valid);
+}
+
+bool btcb::validate_message_batch (btcb::signature_backend backend_a, const unsigned char ** m, size_t * mlen, const unsigned char ** pk, const unsigned char ** RS, size_t num, int * valid)
+{
+	assert (btcb::signature_backend_supported (backend_a));
+	int status;
+	switch (backend_a)
+	{
+#ifdef BTCB_ED25519_IFMA
+		case btcb::signature_backend::donna_ifma:
+			status = ed25519_sign_open_batch_ifma (m, mlen, pk, RS, num, valid);
+			break;
+#endif
+		default:
+			status = ed25519_sign_open_batch (m, mlen, pk, RS, num, valid);
+			break;
+	}
+	bool result (0 == status);
 	return result;
 }
 
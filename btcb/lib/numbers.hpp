@@ -88,6 +88,10 @@ union uint256_union
 	std::string to_string () const;
 	btcb::uint256_t number () const;
 };
+/** Length of an account as written by encode_account, the bcb_ prefix and 60 base32 digits */
+size_t constexpr account_text_size = 64;
+/** Writes count_a accounts back to back in to destination_a, which must hold count_a * account_text_size characters. No separators or terminators are added */
+void encode_accounts (btcb::uint256_union const * accounts_a, size_t count_a, char * destination_a);
 // All keys and hashes are 256 bit.
 using block_hash = uint256_union;
 using account = uint256_union;
@@ -129,6 +133,19 @@ using signature = uint512_union;
 btcb::uint512_union sign_message (btcb::raw_key const &, btcb::public_key const &, btcb::uint256_union const &);
 bool validate_message (btcb::public_key const &, btcb::uint256_union const &, btcb::uint512_union const &);
 bool validate_message_batch (const unsigned char **, size_t *, const unsigned char **, const unsigned char **, size_t, int *);
+/** Ways of checking a batch of signatures */
+enum class signature_backend
+{
+	/** ed25519-donna's batch verifier */
+	donna,
+	/** Eight signatures at a time with AVX-512 IFMA, x86-64 only */
+	donna_ifma
+};
+bool signature_backend_supported (btcb::signature_backend);
+/** Fastest backend supported by this build and CPU, used by validate_message_batch */
+btcb::signature_backend signature_backend_best ();
+std::string signature_backend_name (btcb::signature_backend);
+bool validate_message_batch (btcb::signature_backend, const unsigned char **, size_t *, const unsigned char **, const unsigned char **, size_t, int *);
 void deterministic_key (btcb::uint256_union const &, uint32_t, btcb::uint256_union &);
 btcb::public_key pub_key (btcb::private_key const &);
 }
@@ -43,6 +43,9 @@ namespace thread_role
 			case btcb::thread_role::name::block_processing:
 				thread_role_name_string = "Blck processing";
 				break;
+			case btcb::thread_role::name::block_verification:
+				thread_role_name_string = "Blck verifying";
+				break;
 			case btcb::thread_role::name::announce_loop:
 				thread_role_name_string = "Announce loop";
 				break;
@@ -37,6 +37,7 @@ namespace thread_role
 		alarm,
 		vote_processing,
 		block_processing,
+		block_verification,
 		announce_loop,
 		wallet_actions,
 		bootstrap_initiator,
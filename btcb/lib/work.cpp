@@ -3,8 +3,13 @@
 #include <btcb/lib/blocks.hpp>
 #include <btcb/node/xorshift.hpp>
 
+#include <algorithm>
+#include <array>
 #include <future>
 
+size_t constexpr btcb::work_pool::roots_max;
+unsigned constexpr btcb::work_pool::slice_size;
+
 bool btcb::work_validate (btcb::block_hash const & root_a, uint64_t work_a, uint64_t * difficulty_a)
 {
 	auto value (btcb::work_value (root_a, work_a));
@@ -34,8 +39,14 @@ uint64_t btcb::work_value (btcb::block_hash const & root_a, uint64_t work_a)
 btcb::work_pool::work_pool (unsigned max_threads_a, std::function<boost::optional<uint64_t> (btcb::uint256_union const &)> opencl_a) :
 ticket (0),
 done (false),
+next_id (0),
 opencl (opencl_a)
 {
+	for (size_t i (0); i < btcb::work_priority_count; ++i)
+	{
+		generated[i] = 0;
+		generation_time[i] = 0;
+	}
 	static_assert (ATOMIC_INT_LOCK_FREE == 2, "Atomic int needed");
 	boost::thread::attributes attrs;
 	btcb::thread_attributes::set (attrs);
@@ -65,58 +76,92 @@ void btcb::work_pool::loop (uint64_t thread)
 	// Quick RNG for work attempts.
 	xorshift1024star rng;
 	btcb::random_pool.GenerateBlock (reinterpret_cast<uint8_t *> (rng.s.data ()), rng.s.size () * sizeof (decltype (rng.s)::value_type));
-	uint64_t work;
+	auto kernel (btcb::work_kernel_best ());
+	std::array<uint64_t, btcb::work_lanes> nonces;
+	std::array<uint64_t, btcb::work_lanes> values;
+	uint64_t work (0);
 	uint64_t output;
-	blake2b_state hash;
-	blake2b_init (&hash, sizeof (output));
+	// Start threads on different requests
+	uint64_t turn (thread);
+	// Threads revisit the queue after every slice, observers are only told when it becomes empty or non-empty
+	boost::optional<bool> working;
 	std::unique_lock<std::mutex> lock (mutex);
 	while (!done || !pending.empty ())
 	{
+		expire (lock);
 		auto empty (pending.empty ());
-		if (thread == 0)
+		if (thread == 0 && working != !empty)
 		{
 			// Only work thread 0 notifies work observers
+			working = !empty;
 			work_observers.notify (!empty);
 		}
 		if (!empty)
 		{
-			auto current_l (pending.front ());
+			// Requests sharing the highest queued priority, up to roots_max, are worked on in turn
+			auto priority (pending.front ().priority);
+			size_t window (0);
+			for (auto i (pending.begin ()), n (pending.end ()); i != n && i->priority == priority && window < roots_max; ++i)
+			{
+				++window;
+			}
+			auto current (pending.begin ());
+			std::advance (current, turn % window);
+			++turn;
+			auto current_l (*current);
 			int ticket_l (ticket);
 			lock.unlock ();
 			output = 0;
-			// ticket != ticket_l indicates a different thread found a solution and we should stop
-			while (ticket == ticket_l && output < current_l.difficulty)
+			// ticket != ticket_l indicates the queue changed and we should pick our request again
+			unsigned slice (slice_size / 256);
+			auto timed (current_l.deadline != std::chrono::steady_clock::time_point::max ());
+			while (slice && ticket == ticket_l && output < current_l.difficulty && (!timed || std::chrono::steady_clock::now () < current_l.deadline))
 			{
 				// Don't query main memory every iteration in order to reduce memory bus traffic
 				// All operations here operate on stack memory
 				// Count iterations down to zero since comparing to zero is easier than comparing to another number
-				unsigned iteration (256);
+				unsigned iteration (256 / btcb::work_lanes);
 				while (iteration && output < current_l.difficulty)
 				{
-					work = rng.next ();
-					blake2b_update (&hash, reinterpret_cast<uint8_t *> (&work), sizeof (work));
-					blake2b_update (&hash, current_l.item.bytes.data (), current_l.item.bytes.size ());
-					blake2b_final (&hash, reinterpret_cast<uint8_t *> (&output), sizeof (output));
-					blake2b_init (&hash, sizeof (output));
+					for (auto & nonce : nonces)
+					{
+						nonce = rng.next ();
+					}
+					btcb::work_values (kernel, current_l.item, nonces.data (), values.data ());
+					for (size_t i (0); i < btcb::work_lanes && output < current_l.difficulty; ++i)
+					{
+						if (values[i] >= current_l.difficulty)
+						{
+							work = nonces[i];
+							output = values[i];
+						}
+					}
 					iteration -= 1;
 				}
+				slice -= 1;
 			}
 			lock.lock ();
-			if (ticket == ticket_l)
+			if (output >= current_l.difficulty)
 			{
-				// If the ticket matches what we started with, we're the ones that found the solution
-				assert (output >= btcb::work_pool::publish_threshold);
-				assert (work_value (current_l.item, work) == output);
-				// Signal other threads to stop their work next time they check ticket
-				++ticket;
-				pending.pop_front ();
-				lock.unlock ();
-				current_l.callback (work);
-				lock.lock ();
-			}
-			else
-			{
-				// A different thread found a solution
+				auto existing (std::find_if (pending.begin (), pending.end (), [&current_l](btcb::work_item const & item_a) { return item_a.id == current_l.id; }));
+				if (existing != pending.end ())
+				{
+					// The request is still queued, we're the ones that found the solution
+					assert (work_value (current_l.item, work) == output);
+					// Signal other threads to pick their requests again next time they check ticket
+					++ticket;
+					erase (existing);
+					auto index (static_cast<size_t> (current_l.priority));
+					generated[index] += 1;
+					generation_time[index] += std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - current_l.queued).count ();
+					lock.unlock ();
+					current_l.callback (work);
+					lock.lock ();
+				}
+				else
+				{
+					// A different thread found a solution or the request was cancelled
+				}
 			}
 		}
 		else
@@ -127,29 +172,62 @@ void btcb::work_pool::loop (uint64_t thread)
 	}
 }
 
-void btcb::work_pool::cancel (btcb::uint256_union const & root_a)
+void btcb::work_pool::expire (std::unique_lock<std::mutex> & lock_a)
 {
-	std::lock_guard<std::mutex> lock (mutex);
-	if (!pending.empty ())
+	assert (lock_a.owns_lock ());
+	if (!deadlines.empty ())
 	{
-		if (pending.front ().item == root_a)
+		auto now (std::chrono::steady_clock::now ());
+		std::vector<btcb::work_item> expired;
+		while (!deadlines.empty () && deadlines.begin ()->first <= now)
+		{
+			auto item (deadlines.begin ()->second);
+			deadlines.erase (deadlines.begin ());
+			expired.push_back (std::move (*item));
+			pending.erase (item);
+		}
+		if (!expired.empty ())
 		{
 			++ticket;
+			lock_a.unlock ();
+			for (auto & item : expired)
+			{
+				item.callback (boost::none);
+			}
+			lock_a.lock ();
 		}
 	}
-	pending.remove_if ([&root_a](decltype (pending)::value_type const & item_a) {
-		bool result;
-		if (item_a.item == root_a)
+}
+
+void btcb::work_pool::erase (std::list<btcb::work_item>::iterator item_a)
+{
+	if (item_a->deadline != std::chrono::steady_clock::time_point::max ())
+	{
+		auto range (deadlines.equal_range (item_a->deadline));
+		auto existing (std::find_if (range.first, range.second, [item_a](decltype (deadlines)::value_type const & entry_a) { return entry_a.second == item_a; }));
+		assert (existing != range.second);
+		deadlines.erase (existing);
+	}
+	pending.erase (item_a);
+}
+
+void btcb::work_pool::cancel (btcb::uint256_union const & root_a)
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	for (auto i (pending.begin ()), n (pending.end ()); i != n;)
+	{
+		if (i->item == root_a)
 		{
-			item_a.callback (boost::none);
-			result = true;
+			// Threads working on it pick a different request
+			++ticket;
+			i->callback (boost::none);
+			erase (i++);
 		}
 		else
 		{
-			result = false;
+			++i;
 		}
-		return result;
-	});
+	}
 }
 
 void btcb::work_pool::stop ()
@@ -161,7 +239,7 @@ void btcb::work_pool::stop ()
 	producer_condition.notify_all ();
 }
 
-void btcb::work_pool::generate (btcb::uint256_union const & root_a, std::function<void(boost::optional<uint64_t> const &)> callback_a, uint64_t difficulty_a)
+void btcb::work_pool::generate (btcb::uint256_union const & root_a, std::function<void(boost::optional<uint64_t> const &)> callback_a, uint64_t difficulty_a, btcb::work_priority priority_a, std::chrono::steady_clock::time_point deadline_a)
 {
 	assert (!root_a.is_zero ());
 	boost::optional<uint64_t> result;
@@ -173,7 +251,18 @@ void btcb::work_pool::generate (btcb::uint256_union const & root_a, std::functio
 	{
 		{
 			std::lock_guard<std::mutex> lock (mutex);
-			pending.push_back ({ root_a, callback_a, difficulty_a });
+			// Queue behind requests of the same or a higher priority
+			auto position (std::find_if (pending.begin (), pending.end (), [priority_a](btcb::work_item const & item_a) { return item_a.priority > priority_a; }));
+			if (static_cast<size_t> (std::distance (pending.begin (), position)) < roots_max)
+			{
+				// The request is in the set being worked on, threads pick their requests again
+				++ticket;
+			}
+			auto item (pending.insert (position, { root_a, callback_a, difficulty_a, priority_a, std::chrono::steady_clock::now (), deadline_a, next_id++ }));
+			if (deadline_a != std::chrono::steady_clock::time_point::max ())
+			{
+				deadlines.emplace (deadline_a, item);
+			}
 		}
 		producer_condition.notify_all ();
 	}
@@ -183,13 +272,26 @@ void btcb::work_pool::generate (btcb::uint256_union const & root_a, std::functio
 	}
 }
 
-uint64_t btcb::work_pool::generate (btcb::uint256_union const & hash_a, uint64_t difficulty_a)
+uint64_t btcb::work_pool::generate (btcb::uint256_union const & hash_a, uint64_t difficulty_a, btcb::work_priority priority_a)
 {
 	std::promise<boost::optional<uint64_t>> work;
 	generate (hash_a, [&work](boost::optional<uint64_t> work_a) {
 		work.set_value (work_a);
 	},
-	difficulty_a);
+	difficulty_a, priority_a);
 	auto result (work.get_future ().get ());
 	return result.value ();
 }
+
+size_t btcb::work_pool::size (btcb::work_priority priority_a)
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	return std::count_if (pending.begin (), pending.end (), [priority_a](btcb::work_item const & item_a) { return item_a.priority == priority_a; });
+}
+
+uint64_t btcb::work_pool::average_time (btcb::work_priority priority_a)
+{
+	auto index (static_cast<size_t> (priority_a));
+	uint64_t count (generated[index]);
+	return count > 0 ? generation_time[index] / count : 0;
+}
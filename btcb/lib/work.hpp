@@ -6,9 +6,14 @@
 #include <btcb/lib/numbers.hpp>
 #include <btcb/lib/utility.hpp>
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <list>
+#include <map>
 #include <memory>
+#include <string>
 #include <thread>
 
 namespace btcb
@@ -17,14 +22,45 @@ class block;
 bool work_validate (btcb::block_hash const &, uint64_t, uint64_t * = nullptr);
 bool work_validate (btcb::block const &, uint64_t * = nullptr);
 uint64_t work_value (btcb::block_hash const &, uint64_t);
+/** Implementations of the proof of work hash which evaluate work_lanes nonces per call */
+enum class work_kernel
+{
+	scalar,
+	avx2
+};
+size_t constexpr work_lanes = 8;
+bool work_kernel_supported (btcb::work_kernel);
+/** Fastest kernel supported by this build and CPU */
+btcb::work_kernel work_kernel_best ();
+std::string work_kernel_name (btcb::work_kernel);
+/** Writes work_value (root_a, nonces_a[i]) to values_a[i] for work_lanes nonces */
+void work_values (btcb::work_kernel, btcb::uint256_union const & root_a, uint64_t const * nonces_a, uint64_t * values_a);
 class opencl_work;
+enum class work_priority : uint8_t
+{
+	/** Someone is waiting for the result, e.g. a block being created or a work_generate request */
+	interactive,
+	/** Work cached ahead of time, only worked on while no interactive requests are queued */
+	precache
+};
+size_t constexpr work_priority_count = 2;
 class work_item
 {
 public:
 	btcb::uint256_union item;
 	std::function<void(boost::optional<uint64_t> const &)> callback;
 	uint64_t difficulty;
+	btcb::work_priority priority;
+	std::chrono::steady_clock::time_point queued;
+	/** The request is cancelled if no work was found by this time */
+	std::chrono::steady_clock::time_point deadline;
+	uint64_t id;
 };
+/**
+ * Generates work on a set of threads.
+ * Requests are ordered by priority then age. Threads take turns on up to roots_max of the oldest requests sharing the highest
+ * queued priority, so a slow request doesn't hold up the ones behind it.
+ */
 class work_pool
 {
 public:
@@ -33,12 +69,22 @@ public:
 	void loop (uint64_t);
 	void stop ();
 	void cancel (btcb::uint256_union const &);
-	void generate (btcb::uint256_union const &, std::function<void(boost::optional<uint64_t> const &)>, uint64_t = btcb::work_pool::publish_threshold);
-	uint64_t generate (btcb::uint256_union const &, uint64_t = btcb::work_pool::publish_threshold);
+	void generate (btcb::uint256_union const &, std::function<void(boost::optional<uint64_t> const &)>, uint64_t = btcb::work_pool::publish_threshold, btcb::work_priority = btcb::work_priority::interactive, std::chrono::steady_clock::time_point = std::chrono::steady_clock::time_point::max ());
+	uint64_t generate (btcb::uint256_union const &, uint64_t = btcb::work_pool::publish_threshold, btcb::work_priority = btcb::work_priority::interactive);
+	/** Number of queued requests with the given priority */
+	size_t size (btcb::work_priority);
+	/** Average microseconds from queueing to solution for requests with the given priority */
+	uint64_t average_time (btcb::work_priority);
 	std::atomic<int> ticket;
 	bool done;
 	std::vector<boost::thread> threads;
 	std::list<btcb::work_item> pending;
+	/** Queued requests that have a deadline, soonest first */
+	std::multimap<std::chrono::steady_clock::time_point, std::list<btcb::work_item>::iterator> deadlines;
+	uint64_t next_id;
+	/** Solved requests and their summed time to solution in microseconds, indexed by priority */
+	std::array<std::atomic<uint64_t>, btcb::work_priority_count> generated;
+	std::array<std::atomic<uint64_t>, btcb::work_priority_count> generation_time;
 	std::mutex mutex;
 	std::condition_variable producer_condition;
 	std::function<boost::optional<uint64_t> (btcb::uint256_union const &)> opencl;
@@ -47,5 +93,13 @@ public:
 	static uint64_t const publish_test_threshold = 0xff00000000000000;
 	static uint64_t const publish_full_threshold = 0xffffffc000000000;
 	static uint64_t const publish_threshold = btcb::btcb_network == btcb::btcb_networks::btcb_test_network ? publish_test_threshold : publish_full_threshold;
+	static size_t constexpr roots_max = 16;
+	/** Hashes tried on a request before a thread moves on to the next one */
+	static unsigned constexpr slice_size = 4096;
+
+private:
+	void expire (std::unique_lock<std::mutex> &);
+	/** Removes a request from pending and deadlines */
+	void erase (std::list<btcb::work_item>::iterator);
 };
 }
@@ -0,0 +1,220 @@
+#include <btcb/lib/work.hpp>
+
+#include <array>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BTCB_WORK_AVX2
+#include <immintrin.h>
+#endif
+
+namespace
+{
+/*
+ * Work hashes are blake2b with an 8 byte digest over exactly 40 bytes, the nonce followed by the root.
+ * The input always fits in a single final block so the state is set up directly from the IV, message words 5-15 are zero
+ * and only word 0, the nonce, differs between lanes.
+ */
+std::array<uint64_t, 8> constexpr blake2b_iv{ { 0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL, 0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL } };
+uint8_t constexpr blake2b_sigma[12][16] = {
+	{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+	{ 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 },
+	{ 11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4 },
+	{ 7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8 },
+	{ 9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13 },
+	{ 2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9 },
+	{ 12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11 },
+	{ 13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10 },
+	{ 6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5 },
+	{ 10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0 },
+	{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+	{ 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 }
+};
+// Parameter block word 0 for an 8 byte digest, no key, fanout 1, depth 1
+uint64_t constexpr blake2b_param = 0x01010000ULL ^ sizeof (uint64_t);
+// Length of the nonce and root
+uint64_t constexpr work_input_size = sizeof (uint64_t) + sizeof (btcb::uint256_union);
+
+std::array<uint64_t, 16> message_words (btcb::uint256_union const & root_a)
+{
+	std::array<uint64_t, 16> result{};
+	std::memcpy (&result[1], root_a.bytes.data (), root_a.bytes.size ());
+	return result;
+}
+
+inline uint64_t rotr64 (uint64_t value_a, unsigned shift_a)
+{
+	return (value_a >> shift_a) | (value_a << (64 - shift_a));
+}
+
+inline void g (uint64_t * v, int a, int b, int c, int d, uint64_t x, uint64_t y)
+{
+	v[a] = v[a] + v[b] + x;
+	v[d] = rotr64 (v[d] ^ v[a], 32);
+	v[c] = v[c] + v[d];
+	v[b] = rotr64 (v[b] ^ v[c], 24);
+	v[a] = v[a] + v[b] + y;
+	v[d] = rotr64 (v[d] ^ v[a], 16);
+	v[c] = v[c] + v[d];
+	v[b] = rotr64 (v[b] ^ v[c], 63);
+}
+
+uint64_t work_value_scalar (std::array<uint64_t, 16> const & m, uint64_t nonce_a)
+{
+	uint64_t v[16] = { blake2b_iv[0] ^ blake2b_param, blake2b_iv[1], blake2b_iv[2], blake2b_iv[3], blake2b_iv[4], blake2b_iv[5], blake2b_iv[6], blake2b_iv[7],
+		blake2b_iv[0], blake2b_iv[1], blake2b_iv[2], blake2b_iv[3], blake2b_iv[4] ^ work_input_size, blake2b_iv[5], ~blake2b_iv[6], blake2b_iv[7] };
+	auto m0 (m);
+	m0[0] = nonce_a;
+	for (auto i (0); i < 12; ++i)
+	{
+		auto s (blake2b_sigma[i]);
+		g (v, 0, 4, 8, 12, m0[s[0]], m0[s[1]]);
+		g (v, 1, 5, 9, 13, m0[s[2]], m0[s[3]]);
+		g (v, 2, 6, 10, 14, m0[s[4]], m0[s[5]]);
+		g (v, 3, 7, 11, 15, m0[s[6]], m0[s[7]]);
+		g (v, 0, 5, 10, 15, m0[s[8]], m0[s[9]]);
+		g (v, 1, 6, 11, 12, m0[s[10]], m0[s[11]]);
+		g (v, 2, 7, 8, 13, m0[s[12]], m0[s[13]]);
+		g (v, 3, 4, 9, 14, m0[s[14]], m0[s[15]]);
+	}
+	return blake2b_iv[0] ^ blake2b_param ^ v[0] ^ v[8];
+}
+
+#ifdef BTCB_WORK_AVX2
+/*
+ * Each 256 bit register holds the same state word for 4 nonces. The lanes are split over avx2_groups independent
+ * register sets which are interleaved, so every G step issues one instruction per set back to back.
+ */
+size_t constexpr avx2_groups = btcb::work_lanes / 4;
+
+__attribute__ ((target ("avx2"))) inline __m256i rotr24 (__m256i value_a)
+{
+	return _mm256_shuffle_epi8 (value_a, _mm256_setr_epi8 (3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10, 3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10));
+}
+
+__attribute__ ((target ("avx2"))) inline __m256i rotr16 (__m256i value_a)
+{
+	return _mm256_shuffle_epi8 (value_a, _mm256_setr_epi8 (2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9, 2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9));
+}
+
+__attribute__ ((target ("avx2"))) inline void g_avx2 (__m256i (&v)[avx2_groups][16], int a, int b, int c, int d, __m256i const * x, __m256i const * y)
+{
+	for (size_t i (0); i < avx2_groups; ++i)
+	{
+		v[i][a] = _mm256_add_epi64 (_mm256_add_epi64 (v[i][a], v[i][b]), x[i]);
+		v[i][d] = _mm256_shuffle_epi32 (_mm256_xor_si256 (v[i][d], v[i][a]), _MM_SHUFFLE (2, 3, 0, 1));
+		v[i][c] = _mm256_add_epi64 (v[i][c], v[i][d]);
+		v[i][b] = rotr24 (_mm256_xor_si256 (v[i][b], v[i][c]));
+		v[i][a] = _mm256_add_epi64 (_mm256_add_epi64 (v[i][a], v[i][b]), y[i]);
+		v[i][d] = rotr16 (_mm256_xor_si256 (v[i][d], v[i][a]));
+		v[i][c] = _mm256_add_epi64 (v[i][c], v[i][d]);
+		auto b_l (_mm256_xor_si256 (v[i][b], v[i][c]));
+		v[i][b] = _mm256_or_si256 (_mm256_srli_epi64 (b_l, 63), _mm256_add_epi64 (b_l, b_l));
+	}
+}
+
+__attribute__ ((target ("avx2"))) void work_values_avx2 (std::array<uint64_t, 16> const & m, uint64_t const * nonces_a, uint64_t * values_a)
+{
+	// Message words indexed [word][group], only word 0 differs between groups
+	__m256i mv[16][avx2_groups];
+	for (size_t j (0); j < avx2_groups; ++j)
+	{
+		mv[0][j] = _mm256_loadu_si256 (reinterpret_cast<__m256i const *> (nonces_a + 4 * j));
+		for (size_t k (1); k < 16; ++k)
+		{
+			mv[k][j] = _mm256_set1_epi64x (m[k]);
+		}
+	}
+	__m256i v[avx2_groups][16];
+	for (size_t j (0); j < avx2_groups; ++j)
+	{
+		v[j][0] = _mm256_set1_epi64x (blake2b_iv[0] ^ blake2b_param);
+		for (size_t k (1); k < 8; ++k)
+		{
+			v[j][k] = _mm256_set1_epi64x (blake2b_iv[k]);
+		}
+		for (size_t k (0); k < 8; ++k)
+		{
+			v[j][8 + k] = _mm256_set1_epi64x (blake2b_iv[k]);
+		}
+		v[j][12] = _mm256_set1_epi64x (blake2b_iv[4] ^ work_input_size);
+		v[j][14] = _mm256_set1_epi64x (~blake2b_iv[6]);
+	}
+	for (auto i (0); i < 12; ++i)
+	{
+		auto s (blake2b_sigma[i]);
+		g_avx2 (v, 0, 4, 8, 12, mv[s[0]], mv[s[1]]);
+		g_avx2 (v, 1, 5, 9, 13, mv[s[2]], mv[s[3]]);
+		g_avx2 (v, 2, 6, 10, 14, mv[s[4]], mv[s[5]]);
+		g_avx2 (v, 3, 7, 11, 15, mv[s[6]], mv[s[7]]);
+		g_avx2 (v, 0, 5, 10, 15, mv[s[8]], mv[s[9]]);
+		g_avx2 (v, 1, 6, 11, 12, mv[s[10]], mv[s[11]]);
+		g_avx2 (v, 2, 7, 8, 13, mv[s[12]], mv[s[13]]);
+		g_avx2 (v, 3, 4, 9, 14, mv[s[14]], mv[s[15]]);
+	}
+	auto h0 (_mm256_set1_epi64x (blake2b_iv[0] ^ blake2b_param));
+	for (size_t j (0); j < avx2_groups; ++j)
+	{
+		_mm256_storeu_si256 (reinterpret_cast<__m256i *> (values_a + 4 * j), _mm256_xor_si256 (h0, _mm256_xor_si256 (v[j][0], v[j][8])));
+	}
+}
+#endif
+}
+
+bool btcb::work_kernel_supported (btcb::work_kernel kernel_a)
+{
+	bool result (false);
+	switch (kernel_a)
+	{
+		case btcb::work_kernel::scalar:
+			result = true;
+			break;
+		case btcb::work_kernel::avx2:
+#ifdef BTCB_WORK_AVX2
+			result = __builtin_cpu_supports ("avx2");
+#endif
+			break;
+	}
+	return result;
+}
+
+btcb::work_kernel btcb::work_kernel_best ()
+{
+	static btcb::work_kernel const result (btcb::work_kernel_supported (btcb::work_kernel::avx2) ? btcb::work_kernel::avx2 : btcb::work_kernel::scalar);
+	return result;
+}
+
+std::string btcb::work_kernel_name (btcb::work_kernel kernel_a)
+{
+	std::string result;
+	switch (kernel_a)
+	{
+		case btcb::work_kernel::scalar:
+			result = "scalar";
+			break;
+		case btcb::work_kernel::avx2:
+			result = "avx2";
+			break;
+	}
+	return result;
+}
+
+void btcb::work_values (btcb::work_kernel kernel_a, btcb::uint256_union const & root_a, uint64_t const * nonces_a, uint64_t * values_a)
+{
+	assert (btcb::work_kernel_supported (kernel_a));
+	auto m (message_words (root_a));
+	switch (kernel_a)
+	{
+#ifdef BTCB_WORK_AVX2
+		case btcb::work_kernel::avx2:
+			work_values_avx2 (m, nonces_a, values_a);
+			break;
+#endif
+		default:
+			for (size_t i (0); i < btcb::work_lanes; ++i)
+			{
+				values_a[i] = work_value_scalar (m, nonces_a[i]);
+			}
+			break;
+	}
+}
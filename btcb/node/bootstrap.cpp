@@ -14,6 +14,9 @@ constexpr double bootstrap_minimum_termination_time_sec = 30.0;
 constexpr unsigned bootstrap_max_new_connections = 10;
 constexpr unsigned bulk_push_cost_limit = 200;
 
+size_t constexpr btcb::bulk_pull_client::receive_chunk_size;
+size_t constexpr btcb::bulk_pull_server::send_batch_size;
+
 btcb::socket::socket (std::shared_ptr<btcb::node> node_a) :
 socket_m (node_a->io_ctx),
 cutoff (std::numeric_limits<uint64_t>::max ()),
@@ -44,6 +47,18 @@ void btcb::socket::async_read (std::shared_ptr<std::vector<uint8_t>> buffer_a, s
 	});
 }
 
+void btcb::socket::async_read_some (std::shared_ptr<std::vector<uint8_t>> buffer_a, size_t offset_a, size_t size_a, std::function<void(boost::system::error_code const &, size_t)> callback_a)
+{
+	assert (offset_a + size_a <= buffer_a->size ());
+	auto this_l (shared_from_this ());
+	start ();
+	socket_m.async_read_some (boost::asio::buffer (buffer_a->data () + offset_a, size_a), [this_l, callback_a, buffer_a](boost::system::error_code const & ec, size_t size_a) {
+		this_l->node->stats.add (btcb::stat::type::traffic_bootstrap, btcb::stat::dir::in, size_a);
+		this_l->stop ();
+		callback_a (ec, size_a);
+	});
+}
+
 void btcb::socket::async_write (std::shared_ptr<std::vector<uint8_t>> buffer_a, std::function<void(boost::system::error_code const &, size_t)> callback_a)
 {
 	auto this_l (shared_from_this ());
@@ -129,7 +144,7 @@ pending_stop (false),
 hard_stop (false)
 {
 	++attempt->connections;
-	receive_buffer->resize (256);
+	receive_buffer->resize (btcb::bulk_pull_client::receive_chunk_size);
 }
 
 btcb::bootstrap_client::~bootstrap_client ()
@@ -411,7 +426,9 @@ void btcb::frontier_req_client::next (btcb::transaction const & transaction_a)
 btcb::bulk_pull_client::bulk_pull_client (std::shared_ptr<btcb::bootstrap_client> connection_a, btcb::pull_info const & pull_a) :
 connection (connection_a),
 pull (pull_a),
-total_blocks (0)
+total_blocks (0),
+buffer_begin (0),
+buffer_end (0)
 {
 	std::lock_guard<std::mutex> mutex (connection->attempt->mutex);
 	connection->attempt->condition.notify_all ();
@@ -482,140 +499,132 @@ void btcb::bulk_pull_client::request ()
 
 void btcb::bulk_pull_client::receive_block ()
 {
+	// Keep a partially received block at the start of the buffer and fill the rest
+	auto buffer (connection->receive_buffer);
+	if (buffer_begin > 0)
+	{
+		std::memmove (buffer->data (), buffer->data () + buffer_begin, buffer_end - buffer_begin);
+		buffer_end -= buffer_begin;
+		buffer_begin = 0;
+	}
 	auto this_l (shared_from_this ());
-	connection->socket->async_read (connection->receive_buffer, 1, [this_l](boost::system::error_code const & ec, size_t size_a) {
+	connection->socket->async_read_some (buffer, buffer_end, buffer->size () - buffer_end, [this_l](boost::system::error_code const & ec, size_t size_a) {
 		if (!ec)
 		{
-			this_l->received_type ();
+			this_l->buffer_end += size_a;
+			this_l->received_data ();
 		}
 		else
 		{
 			if (this_l->connection->node->config.logging.bulk_pull_logging ())
 			{
-				BOOST_LOG (this_l->connection->node->log) << boost::str (boost::format ("Error receiving block type: %1%") % ec.message ());
+				BOOST_LOG (this_l->connection->node->log) << boost::str (boost::format ("Error bulk receiving blocks: %1%") % ec.message ());
 			}
 		}
 	});
 }
 
-void btcb::bulk_pull_client::received_type ()
+void btcb::bulk_pull_client::received_data ()
 {
-	auto this_l (shared_from_this ());
-	btcb::block_type type (static_cast<btcb::block_type> (connection->receive_buffer->data ()[0]));
-	switch (type)
+	std::vector<std::shared_ptr<btcb::block>> batch;
+	auto receive_more (true);
+	auto parsing (true);
+	while (parsing && buffer_begin < buffer_end)
 	{
-		case btcb::block_type::send:
-		{
-			connection->socket->async_read (connection->receive_buffer, btcb::send_block::size, [this_l, type](boost::system::error_code const & ec, size_t size_a) {
-				this_l->received_block (ec, size_a, type);
-			});
-			break;
-		}
-		case btcb::block_type::receive:
-		{
-			connection->socket->async_read (connection->receive_buffer, btcb::receive_block::size, [this_l, type](boost::system::error_code const & ec, size_t size_a) {
-				this_l->received_block (ec, size_a, type);
-			});
-			break;
-		}
-		case btcb::block_type::open:
-		{
-			connection->socket->async_read (connection->receive_buffer, btcb::open_block::size, [this_l, type](boost::system::error_code const & ec, size_t size_a) {
-				this_l->received_block (ec, size_a, type);
-			});
-			break;
-		}
-		case btcb::block_type::change:
-		{
-			connection->socket->async_read (connection->receive_buffer, btcb::change_block::size, [this_l, type](boost::system::error_code const & ec, size_t size_a) {
-				this_l->received_block (ec, size_a, type);
-			});
-			break;
-		}
-		case btcb::block_type::state:
-		{
-			connection->socket->async_read (connection->receive_buffer, btcb::state_block::size, [this_l, type](boost::system::error_code const & ec, size_t size_a) {
-				this_l->received_block (ec, size_a, type);
-			});
-			break;
-		}
-		case btcb::block_type::not_a_block:
+		auto data (connection->receive_buffer->data () + buffer_begin);
+		btcb::block_type type (static_cast<btcb::block_type> (data[0]));
+		auto size (btcb::block_size (type));
+		if (type == btcb::block_type::not_a_block)
 		{
+			++buffer_begin;
+			parsing = false;
+			receive_more = false;
 			// Avoid re-using slow peers, or peers that sent the wrong blocks.
 			if (!connection->pending_stop && expected == pull.end)
 			{
 				connection->attempt->pool_connection (connection);
 			}
-			break;
 		}
-		default:
+		else if (size == 0)
 		{
+			parsing = false;
+			receive_more = false;
 			if (connection->node->config.logging.network_packet_logging ())
 			{
 				BOOST_LOG (connection->node->log) << boost::str (boost::format ("Unknown type received as block type: %1%") % static_cast<int> (type));
 			}
-			break;
+		}
+		else if (buffer_end - buffer_begin < 1 + size)
+		{
+			// Wait for the rest of the block
+			parsing = false;
+		}
+		else
+		{
+			btcb::bufferstream stream (data + 1, size);
+			std::shared_ptr<btcb::block> block (btcb::deserialize_block (stream, type));
+			buffer_begin += 1 + size;
+			parsing = received_block (block, batch);
+			receive_more = parsing;
 		}
 	}
+	if (!batch.empty ())
+	{
+		connection->node->block_processor.add (batch, std::chrono::steady_clock::time_point ());
+	}
+	if (receive_more)
+	{
+		receive_block ();
+	}
 }
 
-void btcb::bulk_pull_client::received_block (boost::system::error_code const & ec, size_t size_a, btcb::block_type type_a)
+bool btcb::bulk_pull_client::received_block (std::shared_ptr<btcb::block> block_a, std::vector<std::shared_ptr<btcb::block>> & batch_a)
 {
-	if (!ec)
+	auto result (false);
+	if (block_a != nullptr && !btcb::work_validate (*block_a))
 	{
-		btcb::bufferstream stream (connection->receive_buffer->data (), size_a);
-		std::shared_ptr<btcb::block> block (btcb::deserialize_block (stream, type_a));
-		if (block != nullptr && !btcb::work_validate (*block))
+		auto hash (block_a->hash ());
+		if (connection->node->config.logging.bulk_pull_logging ())
 		{
-			auto hash (block->hash ());
-			if (connection->node->config.logging.bulk_pull_logging ())
-			{
-				std::string block_l;
-				block->serialize_json (block_l);
-				BOOST_LOG (connection->node->log) << boost::str (boost::format ("Pulled block %1% %2%") % hash.to_string () % block_l);
-			}
-			bool block_expected (false);
-			if (hash == expected)
-			{
-				expected = block->previous ();
-				block_expected = true;
-			}
-			if (connection->block_count++ == 0)
-			{
-				connection->start_time = std::chrono::steady_clock::now ();
-			}
-			connection->attempt->total_blocks++;
-			total_blocks++;
-			bool stop_pull (connection->attempt->process_block (block, total_blocks, block_expected));
-			if (!stop_pull && !connection->hard_stop.load ())
-			{
-				receive_block ();
-			}
-			else if (stop_pull && block_expected)
-			{
-				expected = pull.end;
-				connection->attempt->pool_connection (connection);
-			}
-			if (stop_pull)
-			{
-				connection->attempt->lazy_stopped++;
-			}
+			std::string block_l;
+			block_a->serialize_json (block_l);
+			BOOST_LOG (connection->node->log) << boost::str (boost::format ("Pulled block %1% %2%") % hash.to_string () % block_l);
 		}
-		else
+		bool block_expected (false);
+		if (hash == expected)
 		{
-			if (connection->node->config.logging.bulk_pull_logging ())
-			{
-				BOOST_LOG (connection->node->log) << "Error deserializing block received from pull request";
-			}
+			expected = block_a->previous ();
+			block_expected = true;
+		}
+		if (connection->block_count++ == 0)
+		{
+			connection->start_time = std::chrono::steady_clock::now ();
+		}
+		connection->attempt->total_blocks++;
+		total_blocks++;
+		bool stop_pull (connection->attempt->process_block (block_a, total_blocks, block_expected, batch_a));
+		if (!stop_pull && !connection->hard_stop.load ())
+		{
+			result = true;
+		}
+		else if (stop_pull && block_expected)
+		{
+			expected = pull.end;
+			connection->attempt->pool_connection (connection);
+		}
+		if (stop_pull)
+		{
+			connection->attempt->lazy_stopped++;
 		}
 	}
 	else
 	{
 		if (connection->node->config.logging.bulk_pull_logging ())
 		{
-			BOOST_LOG (connection->node->log) << boost::str (boost::format ("Error bulk receiving block: %1%") % ec.message ());
+			BOOST_LOG (connection->node->log) << "Error deserializing block received from pull request";
 		}
 	}
+	return result;
 }
 
 btcb::bulk_push_client::bulk_push_client (std::shared_ptr<btcb::bootstrap_client> const & connection_a) :
@@ -1331,7 +1340,7 @@ void btcb::bootstrap_attempt::lazy_run ()
 	idle.clear ();
 }
 
-bool btcb::bootstrap_attempt::process_block (std::shared_ptr<btcb::block> block_a, uint64_t total_blocks, bool block_expected)
+bool btcb::bootstrap_attempt::process_block (std::shared_ptr<btcb::block> block_a, uint64_t total_blocks, bool block_expected, std::vector<std::shared_ptr<btcb::block>> & batch_a)
 {
 	bool stop_pull (false);
 	if (lazy_mode && block_expected)
@@ -1346,7 +1355,7 @@ bool btcb::bootstrap_attempt::process_block (std::shared_ptr<btcb::block> block_
 			if (!node->store.block_exists (transaction, block_a->type (), hash))
 			{
 				btcb::uint128_t balance (std::numeric_limits<btcb::uint128_t>::max ());
-				node->block_processor.add (block_a, std::chrono::steady_clock::time_point ());
+				batch_a.push_back (block_a);
 				// Search for new dependencies
 				if (!block_a->source ().is_zero () && !node->store.block_exists (transaction, block_a->source ()))
 				{
@@ -1480,7 +1489,7 @@ bool btcb::bootstrap_attempt::process_block (std::shared_ptr<btcb::block> block_
 	}
 	else
 	{
-		node->block_processor.add (block_a, std::chrono::steady_clock::time_point ());
+		batch_a.push_back (block_a);
 	}
 	return stop_pull;
 }
@@ -2067,27 +2076,45 @@ void btcb::bulk_pull_server::set_current_end ()
 
 void btcb::bulk_pull_server::send_next ()
 {
-	auto block (get_next ());
-	if (block != nullptr)
+	// Serialize blocks until the batch is full or the chain is exhausted, then send them with a single write
+	auto finished (false);
+	send_buffer->clear ();
 	{
+		btcb::vectorstream stream (*send_buffer);
+		while (!finished && send_buffer->size () < send_batch_size)
 		{
-			send_buffer->clear ();
-			btcb::vectorstream stream (*send_buffer);
-			btcb::serialize_block (stream, *block);
+			auto block (get_next ());
+			if (block != nullptr)
+			{
+				if (connection->node->config.logging.bulk_pull_logging ())
+				{
+					BOOST_LOG (connection->node->log) << boost::str (boost::format ("Sending block: %1%") % block->hash ().to_string ());
+				}
+				btcb::serialize_block (stream, *block);
+			}
+			else
+			{
+				btcb::write (stream, btcb::block_type::not_a_block);
+				finished = true;
+				if (connection->node->config.logging.bulk_pull_logging ())
+				{
+					BOOST_LOG (connection->node->log) << "Bulk sending finished";
+				}
+			}
+			stream.pubsync ();
 		}
-		auto this_l (shared_from_this ());
-		if (connection->node->config.logging.bulk_pull_logging ())
+	}
+	auto this_l (shared_from_this ());
+	connection->socket->async_write (send_buffer, [this_l, finished](boost::system::error_code const & ec, size_t size_a) {
+		if (finished)
 		{
-			BOOST_LOG (connection->node->log) << boost::str (boost::format ("Sending block: %1%") % block->hash ().to_string ());
+			this_l->no_block_sent (ec, size_a);
 		}
-		connection->socket->async_write (send_buffer, [this_l](boost::system::error_code const & ec, size_t size_a) {
+		else
+		{
 			this_l->sent_action (ec, size_a);
-		});
-	}
-	else
-	{
-		send_finished ();
-	}
+		}
+	});
 }
 
 std::shared_ptr<btcb::block> btcb::bulk_pull_server::get_next ()
@@ -2177,25 +2204,10 @@ void btcb::bulk_pull_server::sent_action (boost::system::error_code const & ec,
 	}
 }
 
-void btcb::bulk_pull_server::send_finished ()
-{
-	send_buffer->clear ();
-	send_buffer->push_back (static_cast<uint8_t> (btcb::block_type::not_a_block));
-	auto this_l (shared_from_this ());
-	if (connection->node->config.logging.bulk_pull_logging ())
-	{
-		BOOST_LOG (connection->node->log) << "Bulk sending finished";
-	}
-	connection->socket->async_write (send_buffer, [this_l](boost::system::error_code const & ec, size_t size_a) {
-		this_l->no_block_sent (ec, size_a);
-	});
-}
-
 void btcb::bulk_pull_server::no_block_sent (boost::system::error_code const & ec, size_t size_a)
 {
 	if (!ec)
 	{
-		assert (size_a == 1);
 		connection->finish_request ();
 	}
 	else
@@ -30,6 +30,8 @@ public:
 	socket (std::shared_ptr<btcb::node>);
 	void async_connect (btcb::tcp_endpoint const &, std::function<void(boost::system::error_code const &)>);
 	void async_read (std::shared_ptr<std::vector<uint8_t>>, size_t, std::function<void(boost::system::error_code const &, size_t)>);
+	/** Reads whatever is available, up to \p size_a bytes, in to the buffer starting at \p offset_a */
+	void async_read_some (std::shared_ptr<std::vector<uint8_t>>, size_t offset_a, size_t size_a, std::function<void(boost::system::error_code const &, size_t)>);
 	void async_write (std::shared_ptr<std::vector<uint8_t>>, std::function<void(boost::system::error_code const &, size_t)>);
 	void start (std::chrono::steady_clock::time_point = std::chrono::steady_clock::now () + std::chrono::seconds (5));
 	void stop ();
@@ -85,7 +87,8 @@ public:
 	unsigned target_connections (size_t pulls_remaining);
 	bool should_log ();
 	void add_bulk_push_target (btcb::block_hash const &, btcb::block_hash const &);
-	bool process_block (std::shared_ptr<btcb::block>, uint64_t, bool);
+	/** Returns true if the pull should stop, blocks to process are appended to \p batch_a */
+	bool process_block (std::shared_ptr<btcb::block>, uint64_t, bool, std::vector<std::shared_ptr<btcb::block>> & batch_a);
 	void lazy_run ();
 	void lazy_start (btcb::block_hash const &);
 	void lazy_add (btcb::block_hash const &);
@@ -150,13 +153,19 @@ public:
 	~bulk_pull_client ();
 	void request ();
 	void receive_block ();
-	void received_type ();
-	void received_block (boost::system::error_code const &, size_t, btcb::block_type);
+	/** Parses every complete block in the buffer and hands them to the block processor together */
+	void received_data ();
+	/** Returns true if more blocks should be read */
+	bool received_block (std::shared_ptr<btcb::block>, std::vector<std::shared_ptr<btcb::block>> &);
 	btcb::block_hash first ();
 	std::shared_ptr<btcb::bootstrap_client> connection;
 	btcb::block_hash expected;
 	btcb::pull_info pull;
 	uint64_t total_blocks;
+	/** Unparsed bytes in the connection's receive buffer */
+	size_t buffer_begin;
+	size_t buffer_end;
+	static size_t constexpr receive_chunk_size = 64 * 1024;
 };
 class bootstrap_client : public std::enable_shared_from_this<bootstrap_client>
 {
@@ -262,10 +271,11 @@ public:
 	bulk_pull_server (std::shared_ptr<btcb::bootstrap_server> const &, std::unique_ptr<btcb::bulk_pull>);
 	void set_current_end ();
 	std::shared_ptr<btcb::block> get_next ();
+	/** Sends as many blocks as fit in send_batch_size with one write, followed by not_a_block once the chain is exhausted */
 	void send_next ();
 	void sent_action (boost::system::error_code const &, size_t);
-	void send_finished ();
 	void no_block_sent (boost::system::error_code const &, size_t);
+	static size_t constexpr send_batch_size = 64 * 1024;
 	std::shared_ptr<btcb::bootstrap_server> connection;
 	std::unique_ptr<btcb::bulk_pull> request;
 	std::shared_ptr<std::vector<uint8_t>> send_buffer;
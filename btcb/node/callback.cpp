@@ -0,0 +1,234 @@
+#include <btcb/node/callback.hpp>
+#include <btcb/node/node.hpp>
+
+size_t constexpr btcb::http_callback::max_queue;
+
+btcb::http_callback_connection::http_callback_connection (btcb::node & node_a) :
+node (node_a),
+socket (node_a.io_ctx),
+resolver (node_a.io_ctx),
+count (0),
+reused (false)
+{
+}
+
+void btcb::http_callback_connection::send (std::shared_ptr<std::string> body_a, size_t count_a)
+{
+	body = body_a;
+	count = count_a;
+	start_time = std::chrono::steady_clock::now ();
+	reused = socket.is_open ();
+	if (reused)
+	{
+		write ();
+	}
+	else
+	{
+		connect ();
+	}
+}
+
+void btcb::http_callback_connection::close ()
+{
+	boost::system::error_code ignored;
+	socket.close (ignored);
+	buffer.consume (buffer.size ());
+}
+
+void btcb::http_callback_connection::connect ()
+{
+	auto this_l (shared_from_this ());
+	auto node_l (node.shared ());
+	resolver.async_resolve (boost::asio::ip::tcp::resolver::query (node.config.callback_address, std::to_string (node.config.callback_port)), [this_l, node_l](boost::system::error_code const & ec, boost::asio::ip::tcp::resolver::iterator i_a) {
+		if (!ec)
+		{
+			boost::asio::async_connect (this_l->socket, i_a, [this_l, node_l](boost::system::error_code const & ec, boost::asio::ip::tcp::resolver::iterator) {
+				if (!ec)
+				{
+					this_l->write ();
+				}
+				else
+				{
+					this_l->failed ("Unable to connect to callback address", ec);
+				}
+			});
+		}
+		else
+		{
+			this_l->failed ("Error resolving callback", ec);
+		}
+	});
+}
+
+void btcb::http_callback_connection::write ()
+{
+	auto this_l (shared_from_this ());
+	auto node_l (node.shared ());
+	request = boost::beast::http::request<boost::beast::http::string_body> ();
+	request.method (boost::beast::http::verb::post);
+	request.target (node.config.callback_target);
+	request.version (11);
+	request.insert (boost::beast::http::field::host, node.config.callback_address);
+	request.insert (boost::beast::http::field::content_type, "application/json");
+	request.keep_alive (true);
+	request.body () = *body;
+	request.prepare_payload ();
+	boost::beast::http::async_write (socket, request, [this_l, node_l](boost::system::error_code const & ec, size_t bytes_transferred) {
+		if (!ec)
+		{
+			this_l->response = boost::beast::http::response<boost::beast::http::string_body> ();
+			boost::beast::http::async_read (this_l->socket, this_l->buffer, this_l->response, [this_l, node_l](boost::system::error_code const & ec, size_t bytes_transferred) {
+				if (!ec)
+				{
+					node_l->stats.inc (btcb::stat::type::http_callback, btcb::stat::detail::requests, btcb::stat::dir::out);
+					node_l->stats.add (btcb::stat::type::http_callback, btcb::stat::detail::request_time, btcb::stat::dir::out, std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - this_l->start_time).count ());
+					if (this_l->response.result () == boost::beast::http::status::ok)
+					{
+						node_l->stats.add (btcb::stat::type::http_callback, btcb::stat::detail::initiate, btcb::stat::dir::out, this_l->count);
+					}
+					else
+					{
+						if (node_l->config.logging.callback_logging ())
+						{
+							BOOST_LOG (node_l->log) << boost::str (boost::format ("Callback to %1%:%2% failed with status: %3%") % node_l->config.callback_address % node_l->config.callback_port % this_l->response.result ());
+						}
+						node_l->stats.inc (btcb::stat::type::error, btcb::stat::detail::http_callback, btcb::stat::dir::out);
+					}
+					auto reusable (this_l->response.keep_alive ());
+					if (!reusable)
+					{
+						this_l->close ();
+					}
+					node_l->http_callbacks.finished (this_l, reusable);
+				}
+				else
+				{
+					this_l->failed ("Unable complete callback", ec);
+				}
+			});
+		}
+		else
+		{
+			this_l->failed ("Unable to send callback", ec);
+		}
+	});
+}
+
+void btcb::http_callback_connection::failed (std::string const & message_a, boost::system::error_code const & ec)
+{
+	close ();
+	if (reused)
+	{
+		// The server may have closed the connection while it was idle, retry once on a new one
+		reused = false;
+		connect ();
+	}
+	else
+	{
+		if (node.config.logging.callback_logging ())
+		{
+			BOOST_LOG (node.log) << boost::str (boost::format ("%1%: %2%:%3%: %4%") % message_a % node.config.callback_address % node.config.callback_port % ec.message ());
+		}
+		node.stats.inc (btcb::stat::type::error, btcb::stat::detail::http_callback, btcb::stat::dir::out);
+		node.http_callbacks.finished (shared_from_this (), false);
+	}
+}
+
+btcb::http_callback::http_callback (btcb::node & node_a) :
+node (node_a),
+connections (0),
+stopped (false)
+{
+}
+
+void btcb::http_callback::add (std::string const & body_a)
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	if (!stopped)
+	{
+		if (events.size () < max_queue)
+		{
+			events.push_back (body_a);
+			dispatch (lock);
+		}
+		else
+		{
+			node.stats.inc (btcb::stat::type::http_callback, btcb::stat::detail::overflow, btcb::stat::dir::out);
+		}
+	}
+}
+
+void btcb::http_callback::stop ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	stopped = true;
+	events.clear ();
+	for (auto & i : idle)
+	{
+		i->close ();
+	}
+	connections -= idle.size ();
+	idle.clear ();
+}
+
+void btcb::http_callback::finished (std::shared_ptr<btcb::http_callback_connection> connection_a, bool reusable_a)
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	if (reusable_a && !stopped)
+	{
+		idle.push_back (connection_a);
+	}
+	else
+	{
+		assert (connections > 0);
+		--connections;
+	}
+	dispatch (lock);
+}
+
+void btcb::http_callback::dispatch (std::unique_lock<std::mutex> & lock_a)
+{
+	assert (!mutex.try_lock ());
+	while (!stopped && !events.empty () && (!idle.empty () || connections < node.config.callback_connections))
+	{
+		std::shared_ptr<btcb::http_callback_connection> connection;
+		if (!idle.empty ())
+		{
+			connection = idle.back ();
+			idle.pop_back ();
+		}
+		else
+		{
+			connection = std::make_shared<btcb::http_callback_connection> (node);
+			++connections;
+		}
+		// Summed on every request, divide by the requests stat for the average depth
+		node.stats.add (btcb::stat::type::http_callback, btcb::stat::detail::queue_depth, btcb::stat::dir::out, events.size ());
+		auto body (std::make_shared<std::string> ());
+		size_t count (0);
+		if (node.config.callback_batch_max > 1)
+		{
+			body->push_back ('[');
+			while (!events.empty () && count < node.config.callback_batch_max)
+			{
+				if (count > 0)
+				{
+					body->push_back (',');
+				}
+				body->append (events.front ());
+				events.pop_front ();
+				++count;
+			}
+			body->push_back (']');
+		}
+		else
+		{
+			*body = std::move (events.front ());
+			events.pop_front ();
+			count = 1;
+		}
+		lock_a.unlock ();
+		connection->send (body, count);
+		lock_a.lock ();
+	}
+}
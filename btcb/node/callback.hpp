@@ -0,0 +1,70 @@
+#pragma once
+
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace btcb
+{
+class node;
+class http_callback;
+
+/** A persistent HTTP/1.1 connection to the callback address, sending one request at a time */
+class http_callback_connection : public std::enable_shared_from_this<btcb::http_callback_connection>
+{
+public:
+	http_callback_connection (btcb::node &);
+	/** Posts \p body containing \p count_a events, reconnecting first if the connection isn't open */
+	void send (std::shared_ptr<std::string> body_a, size_t count_a);
+	void close ();
+
+private:
+	void connect ();
+	void write ();
+	void failed (std::string const &, boost::system::error_code const &);
+	btcb::node & node;
+	boost::asio::ip::tcp::socket socket;
+	boost::asio::ip::tcp::resolver resolver;
+	boost::beast::flat_buffer buffer;
+	boost::beast::http::request<boost::beast::http::string_body> request;
+	boost::beast::http::response<boost::beast::http::string_body> response;
+	std::shared_ptr<std::string> body;
+	size_t count;
+	/** Set while the current request goes over a connection that was reused, which the server may have closed in the meantime */
+	bool reused;
+	std::chrono::steady_clock::time_point start_time;
+};
+
+/**
+ * Delivers confirmation callbacks over a bounded pool of keep-alive connections.
+ * Events are queued and each free connection posts the next one, or with callback_batch_max > 1 up to that many events as a JSON array.
+ * Events are dropped when the queue is full rather than stalling the caller.
+ */
+class http_callback
+{
+public:
+	http_callback (btcb::node &);
+	void add (std::string const &);
+	void stop ();
+	static size_t constexpr max_queue = 16 * 1024;
+
+private:
+	friend class btcb::http_callback_connection;
+	/** Called by a connection once its request completed, \p reusable_a if it can take another one */
+	void finished (std::shared_ptr<btcb::http_callback_connection>, bool reusable_a);
+	void dispatch (std::unique_lock<std::mutex> &);
+	btcb::node & node;
+	std::deque<std::string> events;
+	std::vector<std::shared_ptr<btcb::http_callback_connection>> idle;
+	/** Connections open or being opened, including idle ones */
+	size_t connections;
+	bool stopped;
+	std::mutex mutex;
+};
+}
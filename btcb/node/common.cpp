@@ -150,6 +150,45 @@ std::string btcb::message_parser::status_string ()
 	return "[unknown parse_status]";
 }
 
+size_t constexpr btcb::network_filter::hash_offset;
+uint64_t constexpr btcb::network_filter::epoch_mask;
+
+btcb::network_filter::network_filter (size_t size_a) :
+items (size_a),
+epoch (0)
+{
+	for (auto & i : items)
+	{
+		i.store (0, std::memory_order_relaxed);
+	}
+}
+
+bool btcb::network_filter::apply (uint8_t const * data_a, size_t size_a)
+{
+	auto result (false);
+	if (!items.empty () && size_a > hash_offset)
+	{
+		auto digest (XXH64 (data_a + hash_offset, size_a - hash_offset, 0));
+		auto epoch_l (epoch.load (std::memory_order_relaxed) & epoch_mask);
+		auto & item (items[digest % items.size ()]);
+		auto existing (item.load (std::memory_order_relaxed));
+		if ((existing & ~epoch_mask) == (digest & ~epoch_mask) && ((epoch_l - existing) & epoch_mask) <= 1)
+		{
+			result = true;
+		}
+		else
+		{
+			item.store ((digest & ~epoch_mask) | epoch_l, std::memory_order_relaxed);
+		}
+	}
+	return result;
+}
+
+void btcb::network_filter::rotate ()
+{
+	++epoch;
+}
+
 btcb::message_parser::message_parser (btcb::block_uniquer & block_uniquer_a, btcb::vote_uniquer & vote_uniquer_a, btcb::message_visitor & visitor_a, btcb::work_pool & pool_a) :
 block_uniquer (block_uniquer_a),
 vote_uniquer (vote_uniquer_a),
@@ -5,6 +5,7 @@
 
 #include <boost/asio.hpp>
 
+#include <atomic>
 #include <bitset>
 
 #include <xxhash/xxhash.h>
@@ -211,6 +212,28 @@ public:
 	}
 	btcb::message_header header;
 };
+/**
+ * Fixed size filter over raw datagrams, used to drop exact duplicates of publish and confirm_ack messages before they're parsed.
+ * Each slot holds the high bits of a datagram's hash tagged with the epoch it was seen in, slots are overwritten on collision so
+ * a datagram may occasionally be let through twice, but a different datagram is only reported as a duplicate on a 48 bit hash match.
+ * Entries expire once the epoch has been rotated twice.
+ */
+class network_filter
+{
+public:
+	network_filter (size_t);
+	/** Records the datagram and returns true if it was already seen in the current or previous epoch */
+	bool apply (uint8_t const *, size_t);
+	/** Starts a new epoch, entries from before the previous epoch no longer match */
+	void rotate ();
+	/** Offset of the bytes that are hashed, skipping the magic and version bytes so a relayed datagram matches regardless of the sender's version */
+	static size_t constexpr hash_offset = 5;
+
+private:
+	static uint64_t constexpr epoch_mask = 0xffff;
+	std::vector<std::atomic<uint64_t>> items;
+	std::atomic<uint64_t> epoch;
+};
 class work_pool;
 class message_parser
 {
@@ -8,6 +8,8 @@
 
 #include <queue>
 
+size_t constexpr btcb::mdb_store::block_prefix_size;
+
 btcb::mdb_env::mdb_env (bool & error_a, boost::filesystem::path const & path_a, int max_dbs)
 {
 	boost::system::error_code error_mkdir, error_chmod;
@@ -287,8 +289,16 @@ btcb::mdb_txn::mdb_txn (btcb::mdb_env const & environment_a, bool write_a)
 
 btcb::mdb_txn::~mdb_txn ()
 {
+	for (auto & action : flush_actions)
+	{
+		action ();
+	}
 	auto status (mdb_txn_commit (handle));
 	release_assert (status == 0);
+	for (auto & action : commit_actions)
+	{
+		action ();
+	}
 }
 
 btcb::mdb_txn::operator MDB_txn * () const
@@ -312,14 +322,7 @@ public:
 	virtual ~block_predecessor_set () = default;
 	void fill_value (btcb::block const & block_a)
 	{
-		auto hash (block_a.hash ());
-		btcb::block_type type;
-		auto value (store.block_raw_get (transaction, block_a.previous (), type));
-		auto version (store.block_version (transaction, block_a.previous ()));
-		assert (value.mv_size != 0);
-		std::vector<uint8_t> data (static_cast<uint8_t *> (value.mv_data), static_cast<uint8_t *> (value.mv_data) + value.mv_size);
-		std::copy (hash.bytes.begin (), hash.bytes.end (), data.end () - hash.bytes.size ());
-		store.block_raw_put (transaction, store.block_database (type, version), block_a.previous (), btcb::mdb_val (data.size (), data.data ()));
+		store.block_successor_set (transaction, block_a.previous (), block_a.hash ());
 	}
 	void send_block (btcb::send_block const & block_a) override
 	{
@@ -650,6 +653,7 @@ btcb::mdb_val btcb::wallet_value::val () const
 }
 
 template class btcb::mdb_iterator<btcb::pending_key, btcb::pending_info>;
+template class btcb::mdb_iterator<btcb::pending_key, btcb::mdb_val::no_value>;
 template class btcb::mdb_iterator<btcb::uint256_union, btcb::block_info>;
 template class btcb::mdb_iterator<btcb::uint256_union, btcb::uint128_union>;
 template class btcb::mdb_iterator<btcb::uint256_union, btcb::uint256_union>;
@@ -657,6 +661,7 @@ template class btcb::mdb_iterator<btcb::uint256_union, std::shared_ptr<btcb::blo
 template class btcb::mdb_iterator<btcb::uint256_union, std::shared_ptr<btcb::vote>>;
 template class btcb::mdb_iterator<btcb::uint256_union, btcb::wallet_value>;
 template class btcb::mdb_iterator<std::array<char, 64>, btcb::mdb_val::no_value>;
+template class btcb::mdb_iterator<btcb::uint256_union, btcb::mdb_val::no_value>;
 
 btcb::store_iterator<btcb::block_hash, btcb::block_info> btcb::mdb_store::block_info_begin (btcb::transaction const & transaction_a, btcb::block_hash const & hash_a)
 {
@@ -727,14 +732,20 @@ open_blocks (0),
 change_blocks (0),
 state_blocks_v0 (0),
 state_blocks_v1 (0),
+blocks (0),
 pending_v0 (0),
 pending_v1 (0),
 blocks_info (0),
 representation (0),
+delegators (0),
+account_heights (0),
 unchecked (0),
 checksum (0),
 vote (0),
-meta (0)
+meta (0),
+legacy_blocks (false),
+rep_weights_loaded (false),
+block_counts_txn (nullptr)
 {
 	if (!error_a)
 	{
@@ -742,16 +753,23 @@ meta (0)
 		error_a |= mdb_dbi_open (env.tx (transaction), "frontiers", MDB_CREATE, &frontiers) != 0;
 		error_a |= mdb_dbi_open (env.tx (transaction), "accounts", MDB_CREATE, &accounts_v0) != 0;
 		error_a |= mdb_dbi_open (env.tx (transaction), "accounts_v1", MDB_CREATE, &accounts_v1) != 0;
-		error_a |= mdb_dbi_open (env.tx (transaction), "send", MDB_CREATE, &send_blocks) != 0;
-		error_a |= mdb_dbi_open (env.tx (transaction), "receive", MDB_CREATE, &receive_blocks) != 0;
-		error_a |= mdb_dbi_open (env.tx (transaction), "open", MDB_CREATE, &open_blocks) != 0;
-		error_a |= mdb_dbi_open (env.tx (transaction), "change", MDB_CREATE, &change_blocks) != 0;
-		error_a |= mdb_dbi_open (env.tx (transaction), "state", MDB_CREATE, &state_blocks_v0) != 0;
-		error_a |= mdb_dbi_open (env.tx (transaction), "state_v1", MDB_CREATE, &state_blocks_v1) != 0;
+		// The per-type block tables only exist in ledgers which haven't been upgraded to v13 yet
+		legacy_blocks = mdb_dbi_open (env.tx (transaction), "send", 0, &send_blocks) == 0;
+		if (legacy_blocks)
+		{
+			error_a |= mdb_dbi_open (env.tx (transaction), "receive", MDB_CREATE, &receive_blocks) != 0;
+			error_a |= mdb_dbi_open (env.tx (transaction), "open", MDB_CREATE, &open_blocks) != 0;
+			error_a |= mdb_dbi_open (env.tx (transaction), "change", MDB_CREATE, &change_blocks) != 0;
+			error_a |= mdb_dbi_open (env.tx (transaction), "state", MDB_CREATE, &state_blocks_v0) != 0;
+			error_a |= mdb_dbi_open (env.tx (transaction), "state_v1", MDB_CREATE, &state_blocks_v1) != 0;
+		}
+		error_a |= mdb_dbi_open (env.tx (transaction), "blocks", MDB_CREATE, &blocks) != 0;
 		error_a |= mdb_dbi_open (env.tx (transaction), "pending", MDB_CREATE, &pending_v0) != 0;
 		error_a |= mdb_dbi_open (env.tx (transaction), "pending_v1", MDB_CREATE, &pending_v1) != 0;
 		error_a |= mdb_dbi_open (env.tx (transaction), "blocks_info", MDB_CREATE, &blocks_info) != 0;
 		error_a |= mdb_dbi_open (env.tx (transaction), "representation", MDB_CREATE, &representation) != 0;
+		error_a |= mdb_dbi_open (env.tx (transaction), "delegators", MDB_CREATE, &delegators) != 0;
+		error_a |= mdb_dbi_open (env.tx (transaction), "account_heights", MDB_CREATE, &account_heights) != 0;
 		error_a |= mdb_dbi_open (env.tx (transaction), "unchecked", MDB_CREATE, &unchecked) != 0;
 		error_a |= mdb_dbi_open (env.tx (transaction), "checksum", MDB_CREATE, &checksum) != 0;
 		error_a |= mdb_dbi_open (env.tx (transaction), "vote", MDB_CREATE, &vote) != 0;
@@ -760,6 +778,7 @@ meta (0)
 		{
 			do_upgrades (transaction);
 			checksum_put (transaction, 0, 0, 0);
+			rep_weights_load (transaction);
 		}
 	}
 }
@@ -784,9 +803,11 @@ void btcb::mdb_store::initialize (btcb::transaction const & transaction_a, btcb:
 	auto hash_l (genesis_a.hash ());
 	assert (latest_v0_begin (transaction_a) == latest_v0_end ());
 	assert (latest_v1_begin (transaction_a) == latest_v1_end ());
-	block_put (transaction_a, hash_l, *genesis_a.open);
+	block_put (transaction_a, hash_l, *genesis_a.open, btcb::block_sideband (0, genesis_account, 1, std::numeric_limits<btcb::uint128_t>::max (), btcb::seconds_since_epoch ()));
 	account_put (transaction_a, genesis_account, { hash_l, genesis_a.open->hash (), genesis_a.open->hash (), std::numeric_limits<btcb::uint128_t>::max (), btcb::seconds_since_epoch (), 1, btcb::epoch::epoch_0 });
 	representation_put (transaction_a, genesis_account, std::numeric_limits<btcb::uint128_t>::max ());
+	delegator_put (transaction_a, genesis_account, genesis_account);
+	account_height_put (transaction_a, genesis_account, 1, hash_l);
 	checksum_put (transaction_a, 0, 0, hash_l);
 	frontier_put (transaction_a, hash_l, genesis_account);
 }
@@ -869,6 +890,14 @@ void btcb::mdb_store::do_upgrades (btcb::transaction const & transaction_a)
 		case 11:
 			upgrade_v11_to_v12 (transaction_a);
 		case 12:
+			upgrade_v12_to_v13 (transaction_a);
+		case 13:
+			upgrade_v13_to_v14 (transaction_a);
+		case 14:
+			upgrade_v14_to_v15 (transaction_a);
+		case 15:
+			upgrade_v15_to_v16 (transaction_a);
+		case 16:
 			break;
 		default:
 			assert (false);
@@ -1077,6 +1106,171 @@ void btcb::mdb_store::upgrade_v11_to_v12 (btcb::transaction const & transaction_
 	mdb_dbi_open (env.tx (transaction_a), "unchecked", MDB_CREATE, &unchecked);
 }
 
+void btcb::mdb_store::upgrade_v12_to_v13 (btcb::transaction const & transaction_a)
+{
+	version_put (transaction_a, 13);
+	if (legacy_blocks)
+	{
+		// Merge the per-type block tables in to the single blocks table, prefixing each value with its type and epoch
+		std::array<std::tuple<MDB_dbi, btcb::block_type, btcb::epoch>, 6> tables{ { std::make_tuple (send_blocks, btcb::block_type::send, btcb::epoch::epoch_0),
+		std::make_tuple (receive_blocks, btcb::block_type::receive, btcb::epoch::epoch_0),
+		std::make_tuple (open_blocks, btcb::block_type::open, btcb::epoch::epoch_0),
+		std::make_tuple (change_blocks, btcb::block_type::change, btcb::epoch::epoch_0),
+		std::make_tuple (state_blocks_v0, btcb::block_type::state, btcb::epoch::epoch_0),
+		std::make_tuple (state_blocks_v1, btcb::block_type::state, btcb::epoch::epoch_1) } };
+		auto counts (block_counts_get (transaction_a));
+		for (auto & table : tables)
+		{
+			for (btcb::mdb_iterator<btcb::block_hash, btcb::mdb_val::no_value> i (transaction_a, std::get<0> (table)), n (nullptr); i != n; ++i)
+			{
+				std::vector<uint8_t> data;
+				data.reserve (block_prefix_size + i->second.size ());
+				data.push_back (static_cast<uint8_t> (std::get<1> (table)));
+				data.push_back (static_cast<uint8_t> (std::get<2> (table)));
+				data.insert (data.end (), reinterpret_cast<uint8_t const *> (i->second.data ()), reinterpret_cast<uint8_t const *> (i->second.data ()) + i->second.size ());
+				btcb::mdb_val value (data.size (), data.data ());
+				auto status (mdb_put (env.tx (transaction_a), blocks, i->first, value, MDB_NOOVERWRITE));
+				release_assert (status == 0 || status == MDB_KEYEXIST);
+				if (status == 0)
+				{
+					++block_count_entry (counts, std::get<1> (table), std::get<2> (table));
+				}
+			}
+			auto status (mdb_drop (env.tx (transaction_a), std::get<0> (table), 1));
+			release_assert (status == 0);
+		}
+		block_counts_put (transaction_a, counts);
+		legacy_blocks = false;
+	}
+}
+
+void btcb::mdb_store::upgrade_v13_to_v14 (btcb::transaction const & transaction_a)
+{
+	version_put (transaction_a, 14);
+	// Build the delegator index from the representative of every account
+	mdb_drop (env.tx (transaction_a), delegators, 0);
+	for (auto i (latest_begin (transaction_a)), n (latest_end ()); i != n; ++i)
+	{
+		btcb::account_info const & info (i->second);
+		auto rep_block (block_get (transaction_a, info.rep_block));
+		assert (rep_block != nullptr);
+		delegator_put (transaction_a, rep_block->representative (), i->first);
+	}
+}
+
+void btcb::mdb_store::upgrade_v14_to_v15 (btcb::transaction const & transaction_a)
+{
+	version_put (transaction_a, 15);
+	// Build the height index by walking every account chain back from its head
+	mdb_drop (env.tx (transaction_a), account_heights, 0);
+	for (auto i (latest_begin (transaction_a)), n (latest_end ()); i != n; ++i)
+	{
+		btcb::account const & account (i->first);
+		btcb::account_info const & info (i->second);
+		auto height (info.block_count);
+		for (auto hash (info.head); !hash.is_zero (); --height)
+		{
+			assert (height > 0);
+			account_height_put (transaction_a, account, height, hash);
+			auto block (block_get (transaction_a, hash));
+			assert (block != nullptr);
+			hash = block->previous ();
+		}
+	}
+}
+
+void btcb::mdb_store::upgrade_v15_to_v16 (btcb::transaction const & transaction_a)
+{
+	version_put (transaction_a, 16);
+	// Rewriting every block could take hours so existing blocks get their sideband in the background through sideband_upgrade, starting from the first account
+	btcb::uint256_union position_key (5);
+	btcb::uint512_union position;
+	position.clear ();
+	auto status (mdb_put (env.tx (transaction_a), meta, btcb::mdb_val (position_key), btcb::mdb_val (sizeof (position), position.bytes.data ()), 0));
+	release_assert (status == 0);
+}
+
+bool btcb::mdb_store::sideband_upgrade (btcb::transaction const & transaction_a, size_t count_a)
+{
+	btcb::uint256_union position_key (5);
+	btcb::mdb_val value;
+	auto status1 (mdb_get (env.tx (transaction_a), meta, btcb::mdb_val (position_key), value));
+	release_assert (status1 == 0 || status1 == MDB_NOTFOUND);
+	auto result (status1 == MDB_NOTFOUND);
+	if (!result)
+	{
+		// The position is the account to continue with and the block in its chain to continue from, zero for its open block
+		btcb::uint512_union position;
+		position.clear ();
+		release_assert (value.size () <= sizeof (position));
+		std::copy (reinterpret_cast<uint8_t const *> (value.data ()), reinterpret_cast<uint8_t const *> (value.data ()) + value.size (), position.bytes.begin ());
+		btcb::block_hash next (position.uint256s[1]);
+		size_t visited (0);
+		auto i (latest_begin (transaction_a, position.uint256s[0]));
+		auto n (latest_end ());
+		while (i != n && visited < count_a)
+		{
+			btcb::account const & account (i->first);
+			btcb::account_info const & info (i->second);
+			auto hash (info.open_block);
+			uint64_t height (1);
+			if (!next.is_zero () && account == position.uint256s[0])
+			{
+				// Resuming inside the chain, the blocks before next were given their sideband by an earlier call
+				auto block (block_get (transaction_a, next));
+				btcb::block_sideband sideband;
+				btcb::block_sideband previous;
+				if (block != nullptr && (block_sideband_get (transaction_a, next, sideband) || sideband.account == account) && !block_sideband_get (transaction_a, block->previous (), previous) && previous.account == account)
+				{
+					hash = next;
+					height = previous.height + 1;
+				}
+				else
+				{
+					// next was rolled back since the last call, start the chain again from its open block. Blocks already upgraded are only looked at
+				}
+				next.clear ();
+			}
+			for (; !hash.is_zero () && visited < count_a; ++height, ++visited)
+			{
+				btcb::block_sideband sideband;
+				if (block_sideband_get (transaction_a, hash, sideband))
+				{
+					// Earlier blocks in the chain already have their sideband so the balance is found without a long walk. The local time the block arrived is unknown
+					sideband = btcb::block_sideband (block_successor (transaction_a, hash), account, height, block_balance (transaction_a, hash), 0);
+					block_sideband_set (transaction_a, hash, sideband);
+				}
+				assert (sideband.height == height);
+				hash = sideband.successor;
+			}
+			if (hash.is_zero ())
+			{
+				++i;
+				next.clear ();
+			}
+			else
+			{
+				next = hash;
+				position.uint256s[0] = account;
+			}
+		}
+		if (i != n)
+		{
+			position.uint256s[0] = i->first;
+			position.uint256s[1] = next;
+			auto status2 (mdb_put (env.tx (transaction_a), meta, btcb::mdb_val (position_key), btcb::mdb_val (sizeof (position), position.bytes.data ()), 0));
+			release_assert (status2 == 0);
+		}
+		else
+		{
+			auto status2 (mdb_del (env.tx (transaction_a), meta, btcb::mdb_val (position_key), nullptr));
+			release_assert (status2 == 0);
+			result = true;
+		}
+	}
+	return result;
+}
+
 void btcb::mdb_store::clear (MDB_dbi db_a)
 {
 	auto transaction (tx_begin_write ());
@@ -1092,10 +1286,10 @@ btcb::uint128_t btcb::mdb_store::block_balance (btcb::transaction const & transa
 
 btcb::epoch btcb::mdb_store::block_version (btcb::transaction const & transaction_a, btcb::block_hash const & hash_a)
 {
-	btcb::mdb_val value;
-	auto status (mdb_get (env.tx (transaction_a), state_blocks_v1, btcb::mdb_val (hash_a), value));
-	release_assert (status == 0 || status == MDB_NOTFOUND);
-	return status == 0 ? btcb::epoch::epoch_1 : btcb::epoch::epoch_0;
+	btcb::block_type type;
+	btcb::epoch result (btcb::epoch::epoch_0);
+	block_raw_get (transaction_a, hash_a, type, result);
+	return result;
 }
 
 void btcb::mdb_store::representation_add (btcb::transaction const & transaction_a, btcb::block_hash const & source_a, btcb::uint128_t const & amount_a)
@@ -1107,193 +1301,306 @@ void btcb::mdb_store::representation_add (btcb::transaction const & transaction_
 	representation_put (transaction_a, source_rep, source_previous + amount_a);
 }
 
-MDB_dbi btcb::mdb_store::block_database (btcb::block_type type_a, btcb::epoch epoch_a)
+size_t & btcb::mdb_store::block_count_entry (btcb::block_counts & counts_a, btcb::block_type type_a, btcb::epoch epoch_a)
 {
-	if (type_a == btcb::block_type::state)
-	{
-		assert (epoch_a == btcb::epoch::epoch_0 || epoch_a == btcb::epoch::epoch_1);
-	}
-	else
-	{
-		assert (epoch_a == btcb::epoch::epoch_0);
-	}
-	MDB_dbi result;
 	switch (type_a)
 	{
 		case btcb::block_type::send:
-			result = send_blocks;
-			break;
+			return counts_a.send;
 		case btcb::block_type::receive:
-			result = receive_blocks;
-			break;
+			return counts_a.receive;
 		case btcb::block_type::open:
-			result = open_blocks;
-			break;
+			return counts_a.open;
 		case btcb::block_type::change:
-			result = change_blocks;
-			break;
+			return counts_a.change;
 		case btcb::block_type::state:
-			switch (epoch_a)
-			{
-				case btcb::epoch::epoch_0:
-					result = state_blocks_v0;
-					break;
-				case btcb::epoch::epoch_1:
-					result = state_blocks_v1;
-					break;
-				default:
-					assert (false);
-			}
-			break;
+			return epoch_a == btcb::epoch::epoch_1 ? counts_a.state_v1 : counts_a.state_v0;
 		default:
 			assert (false);
-			break;
+			return counts_a.send;
+	}
+}
+
+btcb::block_counts btcb::mdb_store::block_counts_get (btcb::transaction const & transaction_a)
+{
+	btcb::block_counts result;
+	auto txn (env.tx (transaction_a));
+	if (txn == block_counts_txn)
+	{
+		result = block_counts_pending;
+	}
+	else
+	{
+		btcb::uint256_union counts_key (4);
+		btcb::mdb_val value;
+		auto status (mdb_get (txn, meta, btcb::mdb_val (counts_key), value));
+		release_assert (status == 0 || status == MDB_NOTFOUND);
+		if (status == 0)
+		{
+			btcb::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
+			auto error (false);
+			for (auto count : { &result.send, &result.receive, &result.open, &result.change, &result.state_v0, &result.state_v1 })
+			{
+				uint64_t count_l;
+				error |= btcb::read (stream, count_l);
+				*count = count_l;
+			}
+			assert (!error);
+		}
 	}
 	return result;
 }
 
-void btcb::mdb_store::block_raw_put (btcb::transaction const & transaction_a, MDB_dbi database_a, btcb::block_hash const & hash_a, MDB_val value_a)
+void btcb::mdb_store::block_counts_put (btcb::transaction const & transaction_a, btcb::block_counts const & counts_a)
 {
-	auto status2 (mdb_put (env.tx (transaction_a), database_a, btcb::mdb_val (hash_a), &value_a, 0));
-	release_assert (status2 == 0);
+	auto txn (env.tx (transaction_a));
+	if (txn == block_counts_txn)
+	{
+		block_counts_pending = counts_a;
+	}
+	else
+	{
+		block_counts_write (txn, counts_a);
+	}
+}
+
+void btcb::mdb_store::block_counts_update (btcb::transaction const & transaction_a, btcb::block_type type_a, btcb::epoch epoch_a, btcb::block_type old_type_a, btcb::epoch old_epoch_a)
+{
+	// Counts are kept in memory for the rest of the write transaction instead of rewriting the meta entry for every block
+	auto txn (boost::polymorphic_downcast<btcb::mdb_txn *> (transaction_a.impl.get ()));
+	if (block_counts_txn != txn->handle)
+	{
+		assert (block_counts_txn == nullptr);
+		block_counts_pending = block_counts_get (transaction_a);
+		block_counts_txn = txn->handle;
+		txn->flush_actions.push_back ([this]() {
+			block_counts_flush ();
+		});
+	}
+	if (old_type_a != btcb::block_type::invalid)
+	{
+		--block_count_entry (block_counts_pending, old_type_a, old_epoch_a);
+	}
+	if (type_a != btcb::block_type::invalid)
+	{
+		++block_count_entry (block_counts_pending, type_a, epoch_a);
+	}
+}
+
+void btcb::mdb_store::block_counts_write (MDB_txn * txn_a, btcb::block_counts const & counts_a)
+{
+	btcb::uint256_union counts_key (4);
+	std::vector<uint8_t> vector;
+	{
+		btcb::vectorstream stream (vector);
+		for (auto count : { counts_a.send, counts_a.receive, counts_a.open, counts_a.change, counts_a.state_v0, counts_a.state_v1 })
+		{
+			btcb::write (stream, static_cast<uint64_t> (count));
+		}
+	}
+	auto status (mdb_put (txn_a, meta, btcb::mdb_val (counts_key), btcb::mdb_val (vector.size (), vector.data ()), 0));
+	release_assert (status == 0);
+}
+
+void btcb::mdb_store::block_counts_flush ()
+{
+	MDB_txn * txn (block_counts_txn);
+	assert (txn != nullptr);
+	block_counts_write (txn, block_counts_pending);
+	block_counts_txn = nullptr;
+}
+
+void btcb::mdb_store::block_raw_put (btcb::transaction const & transaction_a, btcb::block_hash const & hash_a, btcb::mdb_val const & value_a)
+{
+	assert (value_a.size () > block_prefix_size);
+	auto type (static_cast<btcb::block_type> (reinterpret_cast<uint8_t const *> (value_a.data ())[0]));
+	auto epoch (static_cast<btcb::epoch> (reinterpret_cast<uint8_t const *> (value_a.data ())[1]));
+	MDB_cursor * cursor;
+	auto status1 (mdb_cursor_open (env.tx (transaction_a), blocks, &cursor));
+	release_assert (status1 == 0);
+	btcb::mdb_val key (hash_a);
+	btcb::mdb_val existing;
+	// A single descent finds any existing entry so the per-type counts stay accurate when a block is rewritten
+	auto status2 (mdb_cursor_get (cursor, key, existing, MDB_SET_KEY));
+	release_assert (status2 == 0 || status2 == MDB_NOTFOUND);
+	auto old_type (btcb::block_type::invalid);
+	auto old_epoch (btcb::epoch::invalid);
+	if (status2 == 0)
+	{
+		old_type = static_cast<btcb::block_type> (reinterpret_cast<uint8_t const *> (existing.data ())[0]);
+		old_epoch = static_cast<btcb::epoch> (reinterpret_cast<uint8_t const *> (existing.data ())[1]);
+	}
+	auto status3 (mdb_cursor_put (cursor, btcb::mdb_val (hash_a), value_a, status2 == 0 ? MDB_CURRENT : 0));
+	release_assert (status3 == 0);
+	mdb_cursor_close (cursor);
+	if (status2 != 0 && legacy_blocks)
+	{
+		block_del_legacy (transaction_a, hash_a);
+	}
+	if (old_type != type || old_epoch != epoch)
+	{
+		block_counts_update (transaction_a, type, epoch, old_type, old_epoch);
+	}
 }
 
 void btcb::mdb_store::block_put (btcb::transaction const & transaction_a, btcb::block_hash const & hash_a, btcb::block const & block_a, btcb::block_hash const & successor_a, btcb::epoch epoch_a)
 {
 	assert (successor_a.is_zero () || block_exists (transaction_a, successor_a));
+	assert (block_a.type () == btcb::block_type::state || epoch_a == btcb::epoch::epoch_0);
 	std::vector<uint8_t> vector;
 	{
 		btcb::vectorstream stream (vector);
+		btcb::write (stream, block_a.type ());
+		btcb::write (stream, epoch_a);
 		block_a.serialize (stream);
 		btcb::write (stream, successor_a.bytes);
 	}
-	block_raw_put (transaction_a, block_database (block_a.type (), epoch_a), hash_a, { vector.size (), vector.data () });
+	block_raw_put (transaction_a, hash_a, btcb::mdb_val (vector.size (), vector.data ()));
 	btcb::block_predecessor_set predecessor (transaction_a, *this);
 	block_a.visit (predecessor);
 	assert (block_a.previous ().is_zero () || block_successor (transaction_a, block_a.previous ()) == hash_a);
 }
 
-MDB_val btcb::mdb_store::block_raw_get (btcb::transaction const & transaction_a, btcb::block_hash const & hash_a, btcb::block_type & type_a)
+void btcb::mdb_store::block_put (btcb::transaction const & transaction_a, btcb::block_hash const & hash_a, btcb::block const & block_a, btcb::block_sideband const & sideband_a, btcb::epoch epoch_a)
 {
-	btcb::mdb_val result;
-	auto status (mdb_get (env.tx (transaction_a), send_blocks, btcb::mdb_val (hash_a), result));
-	release_assert (status == 0 || status == MDB_NOTFOUND);
-	if (status != 0)
+	assert (sideband_a.successor.is_zero () || block_exists (transaction_a, sideband_a.successor));
+	assert (block_a.type () == btcb::block_type::state || epoch_a == btcb::epoch::epoch_0);
+	std::vector<uint8_t> vector;
 	{
-		auto status (mdb_get (env.tx (transaction_a), receive_blocks, btcb::mdb_val (hash_a), result));
-		release_assert (status == 0 || status == MDB_NOTFOUND);
-		if (status != 0)
-		{
-			auto status (mdb_get (env.tx (transaction_a), open_blocks, btcb::mdb_val (hash_a), result));
-			release_assert (status == 0 || status == MDB_NOTFOUND);
-			if (status != 0)
-			{
-				auto status (mdb_get (env.tx (transaction_a), change_blocks, btcb::mdb_val (hash_a), result));
-				release_assert (status == 0 || status == MDB_NOTFOUND);
-				if (status != 0)
-				{
-					auto status (mdb_get (env.tx (transaction_a), state_blocks_v0, btcb::mdb_val (hash_a), result));
-					release_assert (status == 0 || status == MDB_NOTFOUND);
-					if (status != 0)
-					{
-						auto status (mdb_get (env.tx (transaction_a), state_blocks_v1, btcb::mdb_val (hash_a), result));
-						release_assert (status == 0 || status == MDB_NOTFOUND);
-						if (status != 0)
-						{
-							// Block not found
-						}
-						else
-						{
-							type_a = btcb::block_type::state;
-						}
-					}
-					else
-					{
-						type_a = btcb::block_type::state;
-					}
-				}
-				else
-				{
-					type_a = btcb::block_type::change;
-				}
-			}
-			else
-			{
-				type_a = btcb::block_type::open;
-			}
-		}
-		else
-		{
-			type_a = btcb::block_type::receive;
-		}
+		btcb::vectorstream stream (vector);
+		btcb::write (stream, block_a.type ());
+		btcb::write (stream, epoch_a);
+		block_a.serialize (stream);
+		sideband_a.serialize (stream);
 	}
-	else
+	block_raw_put (transaction_a, hash_a, btcb::mdb_val (vector.size (), vector.data ()));
+	btcb::block_predecessor_set predecessor (transaction_a, *this);
+	block_a.visit (predecessor);
+	assert (block_a.previous ().is_zero () || block_successor (transaction_a, block_a.previous ()) == hash_a);
+}
+
+bool btcb::mdb_store::block_sideband_get (btcb::transaction const & transaction_a, btcb::block_hash const & hash_a, btcb::block_sideband & sideband_a)
+{
+	btcb::block_type type;
+	btcb::epoch epoch;
+	auto value (block_raw_get (transaction_a, hash_a, type, epoch));
+	auto result (true);
+	if (value.size () != 0)
 	{
-		type_a = btcb::block_type::send;
+		auto offset (block_successor_offset (value, type));
+		if (value.size () == offset + btcb::block_sideband::size)
+		{
+			btcb::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()) + offset, btcb::block_sideband::size);
+			result = sideband_a.deserialize (stream);
+			assert (!result);
+		}
 	}
 	return result;
 }
 
-template <typename T>
-std::shared_ptr<btcb::block> btcb::mdb_store::block_random (btcb::transaction const & transaction_a, MDB_dbi database)
+void btcb::mdb_store::block_sideband_set (btcb::transaction const & transaction_a, btcb::block_hash const & hash_a, btcb::block_sideband const & sideband_a)
 {
-	btcb::block_hash hash;
-	btcb::random_pool.GenerateBlock (hash.bytes.data (), hash.bytes.size ());
-	btcb::store_iterator<btcb::block_hash, std::shared_ptr<T>> existing (std::make_unique<btcb::mdb_iterator<btcb::block_hash, std::shared_ptr<T>>> (transaction_a, database, btcb::mdb_val (hash)));
-	if (existing == btcb::store_iterator<btcb::block_hash, std::shared_ptr<T>> (nullptr))
+	btcb::block_type type;
+	btcb::epoch epoch;
+	auto value (block_raw_get (transaction_a, hash_a, type, epoch));
+	assert (value.size () != 0);
+	// Keep the prefix and block, replacing the successor or sideband after them
+	std::vector<uint8_t> data (static_cast<uint8_t *> (value.data ()), static_cast<uint8_t *> (value.data ()) + block_successor_offset (value, type));
 	{
-		existing = btcb::store_iterator<btcb::block_hash, std::shared_ptr<T>> (std::make_unique<btcb::mdb_iterator<btcb::block_hash, std::shared_ptr<T>>> (transaction_a, database));
+		btcb::vectorstream stream (data);
+		sideband_a.serialize (stream);
 	}
-	auto end (btcb::store_iterator<btcb::block_hash, std::shared_ptr<T>> (nullptr));
-	assert (existing != end);
-	return block_get (transaction_a, btcb::block_hash (existing->first));
+	block_raw_put (transaction_a, hash_a, btcb::mdb_val (data.size (), data.data ()));
 }
 
-std::shared_ptr<btcb::block> btcb::mdb_store::block_random (btcb::transaction const & transaction_a)
+size_t btcb::mdb_store::block_successor_offset (btcb::mdb_val const & value_a, btcb::block_type type_a)
 {
-	auto count (block_count (transaction_a));
-	auto region (btcb::random_pool.GenerateWord32 (0, count.sum () - 1));
-	std::shared_ptr<btcb::block> result;
-	if (region < count.send)
+	auto result (block_prefix_size + btcb::block_size (type_a));
+	assert (value_a.size () == result + sizeof (btcb::block_hash) || value_a.size () == result + btcb::block_sideband::size);
+	return result;
+}
+
+btcb::mdb_val btcb::mdb_store::block_raw_get (btcb::transaction const & transaction_a, btcb::block_hash const & hash_a, btcb::block_type & type_a, btcb::epoch & epoch_a)
+{
+	btcb::mdb_val result;
+	auto status (mdb_get (env.tx (transaction_a), blocks, btcb::mdb_val (hash_a), result));
+	release_assert (status == 0 || status == MDB_NOTFOUND);
+	if (status != 0 && legacy_blocks)
 	{
-		result = block_random<btcb::send_block> (transaction_a, send_blocks);
+		result = block_raw_get_legacy (transaction_a, hash_a);
 	}
-	else
+	if (result.size () != 0)
 	{
-		region -= count.send;
-		if (region < count.receive)
-		{
-			result = block_random<btcb::receive_block> (transaction_a, receive_blocks);
-		}
-		else
+		assert (result.size () > block_prefix_size);
+		type_a = static_cast<btcb::block_type> (reinterpret_cast<uint8_t const *> (result.data ())[0]);
+		epoch_a = static_cast<btcb::epoch> (reinterpret_cast<uint8_t const *> (result.data ())[1]);
+	}
+	return result;
+}
+
+btcb::mdb_val btcb::mdb_store::block_raw_get_legacy (btcb::transaction const & transaction_a, btcb::block_hash const & hash_a)
+{
+	assert (legacy_blocks);
+	std::array<std::tuple<MDB_dbi, btcb::block_type, btcb::epoch>, 6> tables{ { std::make_tuple (send_blocks, btcb::block_type::send, btcb::epoch::epoch_0),
+	std::make_tuple (receive_blocks, btcb::block_type::receive, btcb::epoch::epoch_0),
+	std::make_tuple (open_blocks, btcb::block_type::open, btcb::epoch::epoch_0),
+	std::make_tuple (change_blocks, btcb::block_type::change, btcb::epoch::epoch_0),
+	std::make_tuple (state_blocks_v0, btcb::block_type::state, btcb::epoch::epoch_0),
+	std::make_tuple (state_blocks_v1, btcb::block_type::state, btcb::epoch::epoch_1) } };
+	btcb::mdb_val result;
+	for (auto & table : tables)
+	{
+		btcb::mdb_val value;
+		auto status (mdb_get (env.tx (transaction_a), std::get<0> (table), btcb::mdb_val (hash_a), value));
+		release_assert (status == 0 || status == MDB_NOTFOUND);
+		if (status == 0)
 		{
-			region -= count.receive;
-			if (region < count.open)
-			{
-				result = block_random<btcb::open_block> (transaction_a, open_blocks);
-			}
-			else
-			{
-				region -= count.open;
-				if (region < count.change)
-				{
-					result = block_random<btcb::change_block> (transaction_a, change_blocks);
-				}
-				else
-				{
-					region -= count.change;
-					if (region < count.state_v0)
-					{
-						result = block_random<btcb::state_block> (transaction_a, state_blocks_v0);
-					}
-					else
-					{
-						result = block_random<btcb::state_block> (transaction_a, state_blocks_v1);
-					}
-				}
-			}
+			// Present the entry in the same layout as the blocks table
+			result.buffer = std::make_shared<std::vector<uint8_t>> ();
+			result.buffer->reserve (block_prefix_size + value.size ());
+			result.buffer->push_back (static_cast<uint8_t> (std::get<1> (table)));
+			result.buffer->push_back (static_cast<uint8_t> (std::get<2> (table)));
+			result.buffer->insert (result.buffer->end (), reinterpret_cast<uint8_t const *> (value.data ()), reinterpret_cast<uint8_t const *> (value.data ()) + value.size ());
+			result.value = { result.buffer->size (), result.buffer->data () };
+			break;
 		}
 	}
+	return result;
+}
+
+void btcb::mdb_store::block_del_legacy (btcb::transaction const & transaction_a, btcb::block_hash const & hash_a)
+{
+	assert (legacy_blocks);
+	for (auto table : { send_blocks, receive_blocks, open_blocks, change_blocks, state_blocks_v0, state_blocks_v1 })
+	{
+		auto status (mdb_del (env.tx (transaction_a), table, btcb::mdb_val (hash_a), nullptr));
+		release_assert (status == 0 || status == MDB_NOTFOUND);
+	}
+}
+
+void btcb::mdb_store::block_successor_set (btcb::transaction const & transaction_a, btcb::block_hash const & hash_a, btcb::block_hash const & successor_a)
+{
+	btcb::block_type type;
+	btcb::epoch epoch;
+	auto value (block_raw_get (transaction_a, hash_a, type, epoch));
+	assert (value.size () != 0);
+	std::vector<uint8_t> data (static_cast<uint8_t *> (value.data ()), static_cast<uint8_t *> (value.data ()) + value.size ());
+	std::copy (successor_a.bytes.begin (), successor_a.bytes.end (), data.begin () + block_successor_offset (value, type));
+	block_raw_put (transaction_a, hash_a, btcb::mdb_val (data.size (), data.data ()));
+}
+
+std::shared_ptr<btcb::block> btcb::mdb_store::block_random (btcb::transaction const & transaction_a)
+{
+	btcb::block_hash hash;
+	btcb::random_pool.GenerateBlock (hash.bytes.data (), hash.bytes.size ());
+	btcb::store_iterator<btcb::block_hash, btcb::mdb_val::no_value> existing (std::make_unique<btcb::mdb_iterator<btcb::block_hash, btcb::mdb_val::no_value>> (transaction_a, blocks, btcb::mdb_val (hash)));
+	if (existing == btcb::store_iterator<btcb::block_hash, btcb::mdb_val::no_value> (nullptr))
+	{
+		existing = btcb::store_iterator<btcb::block_hash, btcb::mdb_val::no_value> (std::make_unique<btcb::mdb_iterator<btcb::block_hash, btcb::mdb_val::no_value>> (transaction_a, blocks));
+	}
+	auto end (btcb::store_iterator<btcb::block_hash, btcb::mdb_val::no_value> (nullptr));
+	assert (existing != end);
+	auto result (block_get (transaction_a, btcb::block_hash (existing->first)));
 	assert (result != nullptr);
 	return result;
 }
@@ -1301,12 +1608,12 @@ std::shared_ptr<btcb::block> btcb::mdb_store::block_random (btcb::transaction co
 btcb::block_hash btcb::mdb_store::block_successor (btcb::transaction const & transaction_a, btcb::block_hash const & hash_a)
 {
 	btcb::block_type type;
-	auto value (block_raw_get (transaction_a, hash_a, type));
+	btcb::epoch epoch;
+	auto value (block_raw_get (transaction_a, hash_a, type, epoch));
 	btcb::block_hash result;
-	if (value.mv_size != 0)
+	if (value.size () != 0)
 	{
-		assert (value.mv_size >= result.bytes.size ());
-		btcb::bufferstream stream (reinterpret_cast<uint8_t const *> (value.mv_data) + value.mv_size - result.bytes.size (), result.bytes.size ());
+		btcb::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()) + block_successor_offset (value, type), result.bytes.size ());
 		auto error (btcb::read (stream, result.bytes));
 		assert (!error);
 	}
@@ -1319,19 +1626,18 @@ btcb::block_hash btcb::mdb_store::block_successor (btcb::transaction const & tra
 
 void btcb::mdb_store::block_successor_clear (btcb::transaction const & transaction_a, btcb::block_hash const & hash_a)
 {
-	auto block (block_get (transaction_a, hash_a));
-	auto version (block_version (transaction_a, hash_a));
-	block_put (transaction_a, hash_a, *block, 0, version);
+	block_successor_set (transaction_a, hash_a, 0);
 }
 
 std::shared_ptr<btcb::block> btcb::mdb_store::block_get (btcb::transaction const & transaction_a, btcb::block_hash const & hash_a)
 {
 	btcb::block_type type;
-	auto value (block_raw_get (transaction_a, hash_a, type));
+	btcb::epoch epoch;
+	auto value (block_raw_get (transaction_a, hash_a, type, epoch));
 	std::shared_ptr<btcb::block> result;
-	if (value.mv_size != 0)
+	if (value.size () != 0)
 	{
-		btcb::bufferstream stream (reinterpret_cast<uint8_t const *> (value.mv_data), value.mv_size);
+		btcb::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()) + block_prefix_size, value.size () - block_prefix_size);
 		result = btcb::deserialize_block (stream, type);
 		assert (result != nullptr);
 	}
@@ -1340,130 +1646,64 @@ std::shared_ptr<btcb::block> btcb::mdb_store::block_get (btcb::transaction const
 
 void btcb::mdb_store::block_del (btcb::transaction const & transaction_a, btcb::block_hash const & hash_a)
 {
-	auto status (mdb_del (env.tx (transaction_a), state_blocks_v1, btcb::mdb_val (hash_a), nullptr));
-	release_assert (status == 0 || status == MDB_NOTFOUND);
-	if (status != 0)
+	MDB_cursor * cursor;
+	auto status1 (mdb_cursor_open (env.tx (transaction_a), blocks, &cursor));
+	release_assert (status1 == 0);
+	btcb::mdb_val key (hash_a);
+	btcb::mdb_val existing;
+	auto status2 (mdb_cursor_get (cursor, key, existing, MDB_SET_KEY));
+	release_assert (status2 == 0 || status2 == MDB_NOTFOUND);
+	if (status2 == 0)
 	{
-		auto status (mdb_del (env.tx (transaction_a), state_blocks_v0, btcb::mdb_val (hash_a), nullptr));
-		release_assert (status == 0 || status == MDB_NOTFOUND);
-		if (status != 0)
-		{
-			auto status (mdb_del (env.tx (transaction_a), send_blocks, btcb::mdb_val (hash_a), nullptr));
-			release_assert (status == 0 || status == MDB_NOTFOUND);
-			if (status != 0)
-			{
-				auto status (mdb_del (env.tx (transaction_a), receive_blocks, btcb::mdb_val (hash_a), nullptr));
-				release_assert (status == 0 || status == MDB_NOTFOUND);
-				if (status != 0)
-				{
-					auto status (mdb_del (env.tx (transaction_a), open_blocks, btcb::mdb_val (hash_a), nullptr));
-					release_assert (status == 0 || status == MDB_NOTFOUND);
-					if (status != 0)
-					{
-						auto status (mdb_del (env.tx (transaction_a), change_blocks, btcb::mdb_val (hash_a), nullptr));
-						release_assert (status == 0);
-					}
-				}
-			}
-		}
+		auto type (static_cast<btcb::block_type> (reinterpret_cast<uint8_t const *> (existing.data ())[0]));
+		auto epoch (static_cast<btcb::epoch> (reinterpret_cast<uint8_t const *> (existing.data ())[1]));
+		auto status3 (mdb_cursor_del (cursor, 0));
+		release_assert (status3 == 0);
+		block_counts_update (transaction_a, btcb::block_type::invalid, btcb::epoch::invalid, type, epoch);
 	}
+	mdb_cursor_close (cursor);
+	if (status2 != 0)
+	{
+		release_assert (legacy_blocks);
+		block_del_legacy (transaction_a, hash_a);
+	}
+}
+
+bool btcb::mdb_store::block_exists (btcb::transaction const & transaction_a, btcb::block_type type_a, btcb::block_hash const & hash_a)
+{
+	btcb::block_type type (btcb::block_type::invalid);
+	btcb::epoch epoch;
+	auto value (block_raw_get (transaction_a, hash_a, type, epoch));
+	return value.size () != 0 && type == type_a;
 }
 
-bool btcb::mdb_store::block_exists (btcb::transaction const & transaction_a, btcb::block_type type, btcb::block_hash const & hash_a)
+bool btcb::mdb_store::block_exists (btcb::transaction const & transaction_a, btcb::block_hash const & hash_a)
 {
 	auto exists (false);
 	btcb::mdb_val junk;
-
-	switch (type)
+	auto status (mdb_get (env.tx (transaction_a), blocks, btcb::mdb_val (hash_a), junk));
+	release_assert (status == 0 || status == MDB_NOTFOUND);
+	exists = status == 0;
+	if (!exists && legacy_blocks)
 	{
-		case btcb::block_type::send:
-		{
-			auto status (mdb_get (env.tx (transaction_a), send_blocks, btcb::mdb_val (hash_a), junk));
-			assert (status == 0 || status == MDB_NOTFOUND);
-			exists = status == 0;
-			break;
-		}
-		case btcb::block_type::receive:
-		{
-			auto status (mdb_get (env.tx (transaction_a), receive_blocks, btcb::mdb_val (hash_a), junk));
-			release_assert (status == 0 || status == MDB_NOTFOUND);
-			exists = status == 0;
-			break;
-		}
-		case btcb::block_type::open:
-		{
-			auto status (mdb_get (env.tx (transaction_a), open_blocks, btcb::mdb_val (hash_a), junk));
-			release_assert (status == 0 || status == MDB_NOTFOUND);
-			exists = status == 0;
-			break;
-		}
-		case btcb::block_type::change:
-		{
-			auto status (mdb_get (env.tx (transaction_a), change_blocks, btcb::mdb_val (hash_a), junk));
-			release_assert (status == 0 || status == MDB_NOTFOUND);
-			exists = status == 0;
-			break;
-		}
-		case btcb::block_type::state:
-		{
-			auto status (mdb_get (env.tx (transaction_a), state_blocks_v0, btcb::mdb_val (hash_a), junk));
-			release_assert (status == 0 || status == MDB_NOTFOUND);
-			exists = status == 0;
-			if (!exists)
-			{
-				auto status (mdb_get (env.tx (transaction_a), state_blocks_v1, btcb::mdb_val (hash_a), junk));
-				release_assert (status == 0 || status == MDB_NOTFOUND);
-				exists = status == 0;
-			}
-			break;
-		}
-		case btcb::block_type::invalid:
-		case btcb::block_type::not_a_block:
-			break;
+		exists = block_raw_get_legacy (transaction_a, hash_a).size () != 0;
 	}
-
 	return exists;
 }
 
-bool btcb::mdb_store::block_exists (btcb::transaction const & tx_a, btcb::block_hash const & hash_a)
-{
-	// clang-format off
-	return
-		block_exists (tx_a, btcb::block_type::send, hash_a) ||
-		block_exists (tx_a, btcb::block_type::receive, hash_a) ||
-		block_exists (tx_a, btcb::block_type::open, hash_a) ||
-		block_exists (tx_a, btcb::block_type::change, hash_a) ||
-		block_exists (tx_a, btcb::block_type::state, hash_a);
-	// clang-format on
-}
-
 btcb::block_counts btcb::mdb_store::block_count (btcb::transaction const & transaction_a)
 {
-	btcb::block_counts result;
-	MDB_stat send_stats;
-	auto status1 (mdb_stat (env.tx (transaction_a), send_blocks, &send_stats));
-	release_assert (status1 == 0);
-	MDB_stat receive_stats;
-	auto status2 (mdb_stat (env.tx (transaction_a), receive_blocks, &receive_stats));
-	release_assert (status2 == 0);
-	MDB_stat open_stats;
-	auto status3 (mdb_stat (env.tx (transaction_a), open_blocks, &open_stats));
-	release_assert (status3 == 0);
-	MDB_stat change_stats;
-	auto status4 (mdb_stat (env.tx (transaction_a), change_blocks, &change_stats));
-	release_assert (status4 == 0);
-	MDB_stat state_v0_stats;
-	auto status5 (mdb_stat (env.tx (transaction_a), state_blocks_v0, &state_v0_stats));
-	release_assert (status5 == 0);
-	MDB_stat state_v1_stats;
-	auto status6 (mdb_stat (env.tx (transaction_a), state_blocks_v1, &state_v1_stats));
-	release_assert (status6 == 0);
-	result.send = send_stats.ms_entries;
-	result.receive = receive_stats.ms_entries;
-	result.open = open_stats.ms_entries;
-	result.change = change_stats.ms_entries;
-	result.state_v0 = state_v0_stats.ms_entries;
-	result.state_v1 = state_v1_stats.ms_entries;
+	auto result (block_counts_get (transaction_a));
+	if (legacy_blocks)
+	{
+		for (auto table : { std::make_pair (send_blocks, &result.send), std::make_pair (receive_blocks, &result.receive), std::make_pair (open_blocks, &result.open), std::make_pair (change_blocks, &result.change), std::make_pair (state_blocks_v0, &result.state_v0), std::make_pair (state_blocks_v1, &result.state_v1) })
+		{
+			MDB_stat stats;
+			auto status (mdb_stat (env.tx (transaction_a), table.first, &stats));
+			release_assert (status == 0);
+			*table.second += stats.ms_entries;
+		}
+	}
 	return result;
 }
 
@@ -1740,17 +1980,44 @@ bool btcb::mdb_store::block_info_get (btcb::transaction const & transaction_a, b
 
 btcb::uint128_t btcb::mdb_store::representation_get (btcb::transaction const & transaction_a, btcb::account const & account_a)
 {
-	btcb::mdb_val value;
-	auto status (mdb_get (env.tx (transaction_a), representation, btcb::mdb_val (account_a), value));
-	release_assert (status == 0 || status == MDB_NOTFOUND);
 	btcb::uint128_t result = 0;
-	if (status == 0)
+	std::unique_lock<std::mutex> lock (rep_weights_mutex);
+	if (rep_weights_loaded)
 	{
-		btcb::uint128_union rep;
-		btcb::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
-		auto error (btcb::read (stream, rep));
-		assert (!error);
-		result = rep.number ();
+		auto found (false);
+		auto weights (rep_weights_pending.find (boost::polymorphic_downcast<btcb::mdb_txn const *> (transaction_a.impl.get ())));
+		if (weights != rep_weights_pending.end ())
+		{
+			auto pending (weights->second.find (account_a));
+			found = pending != weights->second.end ();
+			if (found)
+			{
+				result = pending->second;
+			}
+		}
+		if (!found)
+		{
+			auto existing (rep_weights.find (account_a));
+			if (existing != rep_weights.end ())
+			{
+				result = existing->second;
+			}
+		}
+	}
+	else
+	{
+		lock.unlock ();
+		btcb::mdb_val value;
+		auto status (mdb_get (env.tx (transaction_a), representation, btcb::mdb_val (account_a), value));
+		release_assert (status == 0 || status == MDB_NOTFOUND);
+		if (status == 0)
+		{
+			btcb::uint128_union rep;
+			btcb::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
+			auto error (btcb::read (stream, rep));
+			assert (!error);
+			result = rep.number ();
+		}
 	}
 	return result;
 }
@@ -1760,6 +2027,122 @@ void btcb::mdb_store::representation_put (btcb::transaction const & transaction_
 	btcb::uint128_union rep (representation_a);
 	auto status (mdb_put (env.tx (transaction_a), representation, btcb::mdb_val (account_a), btcb::mdb_val (rep), 0));
 	release_assert (status == 0);
+	std::lock_guard<std::mutex> lock (rep_weights_mutex);
+	if (rep_weights_loaded)
+	{
+		// Other transactions keep seeing the committed weights until this one commits
+		auto txn (boost::polymorphic_downcast<btcb::mdb_txn *> (transaction_a.impl.get ()));
+		auto weights (rep_weights_pending.find (txn));
+		if (weights == rep_weights_pending.end ())
+		{
+			weights = rep_weights_pending.emplace (txn, std::unordered_map<btcb::account, btcb::uint128_t> ()).first;
+			txn->commit_actions.push_back ([this, txn]() {
+				rep_weights_commit (txn);
+			});
+		}
+		weights->second[account_a] = representation_a;
+	}
+}
+
+void btcb::mdb_store::rep_weights_commit (btcb::mdb_txn const * txn_a)
+{
+	std::lock_guard<std::mutex> lock (rep_weights_mutex);
+	auto weights (rep_weights_pending.find (txn_a));
+	assert (weights != rep_weights_pending.end ());
+	for (auto & i : weights->second)
+	{
+		if (i.second.is_zero ())
+		{
+			rep_weights.erase (i.first);
+		}
+		else
+		{
+			rep_weights[i.first] = i.second;
+		}
+	}
+	rep_weights_pending.erase (weights);
+}
+
+void btcb::mdb_store::delegator_put (btcb::transaction const & transaction_a, btcb::account const & representative_a, btcb::account const & delegator_a)
+{
+	auto status (mdb_put (env.tx (transaction_a), delegators, btcb::mdb_val (btcb::delegator_key (representative_a, delegator_a)), btcb::mdb_val (0, nullptr), 0));
+	release_assert (status == 0);
+}
+
+void btcb::mdb_store::delegator_del (btcb::transaction const & transaction_a, btcb::account const & representative_a, btcb::account const & delegator_a)
+{
+	auto status (mdb_del (env.tx (transaction_a), delegators, btcb::mdb_val (btcb::delegator_key (representative_a, delegator_a)), nullptr));
+	release_assert (status == 0 || status == MDB_NOTFOUND);
+}
+
+std::vector<btcb::account> btcb::mdb_store::delegators_get (btcb::transaction const & transaction_a, btcb::account const & representative_a, btcb::account const & start_a, size_t count_a)
+{
+	std::vector<btcb::account> result;
+	for (btcb::mdb_iterator<btcb::delegator_key, btcb::mdb_val::no_value> i (transaction_a, delegators, btcb::mdb_val (btcb::delegator_key (representative_a, start_a))), n (nullptr); i != n && result.size () < count_a; ++i)
+	{
+		btcb::delegator_key key (i->first);
+		if (key.account != representative_a)
+		{
+			break;
+		}
+		result.push_back (key.hash);
+	}
+	return result;
+}
+
+uint64_t btcb::mdb_store::delegators_count (btcb::transaction const & transaction_a, btcb::account const & representative_a)
+{
+	uint64_t result (0);
+	for (btcb::mdb_iterator<btcb::delegator_key, btcb::mdb_val::no_value> i (transaction_a, delegators, btcb::mdb_val (btcb::delegator_key (representative_a, 0))), n (nullptr); i != n; ++i)
+	{
+		btcb::delegator_key key (i->first);
+		if (key.account != representative_a)
+		{
+			break;
+		}
+		++result;
+	}
+	return result;
+}
+
+void btcb::mdb_store::account_height_put (btcb::transaction const & transaction_a, btcb::account const & account_a, uint64_t height_a, btcb::block_hash const & hash_a)
+{
+	auto status (mdb_put (env.tx (transaction_a), account_heights, btcb::mdb_val (btcb::account_height_key (account_a, btcb::uint256_union (height_a))), btcb::mdb_val (hash_a), 0));
+	release_assert (status == 0);
+}
+
+void btcb::mdb_store::account_height_del (btcb::transaction const & transaction_a, btcb::account const & account_a, uint64_t height_a)
+{
+	auto status (mdb_del (env.tx (transaction_a), account_heights, btcb::mdb_val (btcb::account_height_key (account_a, btcb::uint256_union (height_a))), nullptr));
+	release_assert (status == 0 || status == MDB_NOTFOUND);
+}
+
+bool btcb::mdb_store::account_height_get (btcb::transaction const & transaction_a, btcb::account const & account_a, uint64_t height_a, btcb::block_hash & hash_a)
+{
+	btcb::mdb_val value;
+	auto status (mdb_get (env.tx (transaction_a), account_heights, btcb::mdb_val (btcb::account_height_key (account_a, btcb::uint256_union (height_a))), value));
+	release_assert (status == 0 || status == MDB_NOTFOUND);
+	bool result (status == MDB_NOTFOUND);
+	if (!result)
+	{
+		hash_a = btcb::uint256_union (value);
+	}
+	return result;
+}
+
+void btcb::mdb_store::rep_weights_load (btcb::transaction const & transaction_a)
+{
+	std::lock_guard<std::mutex> lock (rep_weights_mutex);
+	rep_weights.clear ();
+	for (auto i (representation_begin (transaction_a)), n (representation_end ()); i != n; ++i)
+	{
+		auto weight (i->second.number ());
+		if (!weight.is_zero ())
+		{
+			rep_weights[i->first] = weight;
+		}
+	}
+	rep_weights_loaded = true;
 }
 
 void btcb::mdb_store::unchecked_clear (btcb::transaction const & transaction_a)
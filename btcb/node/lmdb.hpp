@@ -2,6 +2,9 @@
 
 #include <boost/filesystem.hpp>
 
+#include <atomic>
+#include <functional>
+
 #include <lmdb/libraries/liblmdb/lmdb.h>
 
 #include <btcb/lib/numbers.hpp>
@@ -22,6 +25,10 @@ public:
 	btcb::mdb_txn & operator= (btcb::mdb_txn &&) = default;
 	operator MDB_txn * () const;
 	MDB_txn * handle;
+	/** Run just before the transaction commits, to write state that was batched in memory */
+	std::vector<std::function<void()>> flush_actions;
+	/** Run once the transaction has committed, for in-memory state that must not be seen before the data it mirrors */
+	std::vector<std::function<void()>> commit_actions;
 };
 /**
  * RAII wrapper for MDB_env
@@ -153,6 +160,9 @@ public:
 
 	void initialize (btcb::transaction const &, btcb::genesis const &) override;
 	void block_put (btcb::transaction const &, btcb::block_hash const &, btcb::block const &, btcb::block_hash const & = btcb::block_hash (0), btcb::epoch version = btcb::epoch::epoch_0) override;
+	void block_put (btcb::transaction const &, btcb::block_hash const &, btcb::block const &, btcb::block_sideband const &, btcb::epoch version = btcb::epoch::epoch_0) override;
+	bool block_sideband_get (btcb::transaction const &, btcb::block_hash const &, btcb::block_sideband &) override;
+	bool sideband_upgrade (btcb::transaction const &, size_t) override;
 	btcb::block_hash block_successor (btcb::transaction const &, btcb::block_hash const &) override;
 	void block_successor_clear (btcb::transaction const &, btcb::block_hash const &) override;
 	std::shared_ptr<btcb::block> block_get (btcb::transaction const &, btcb::block_hash const &) override;
@@ -212,6 +222,15 @@ public:
 	btcb::store_iterator<btcb::account, btcb::uint128_union> representation_begin (btcb::transaction const &) override;
 	btcb::store_iterator<btcb::account, btcb::uint128_union> representation_end () override;
 
+	void delegator_put (btcb::transaction const &, btcb::account const &, btcb::account const &) override;
+	void delegator_del (btcb::transaction const &, btcb::account const &, btcb::account const &) override;
+	std::vector<btcb::account> delegators_get (btcb::transaction const &, btcb::account const &, btcb::account const &, size_t) override;
+	uint64_t delegators_count (btcb::transaction const &, btcb::account const &) override;
+
+	void account_height_put (btcb::transaction const &, btcb::account const &, uint64_t, btcb::block_hash const &) override;
+	void account_height_del (btcb::transaction const &, btcb::account const &, uint64_t) override;
+	bool account_height_get (btcb::transaction const &, btcb::account const &, uint64_t, btcb::block_hash &) override;
+
 	void unchecked_clear (btcb::transaction const &) override;
 	void unchecked_put (btcb::transaction const &, btcb::unchecked_key const &, std::shared_ptr<btcb::block> const &) override;
 	void unchecked_put (btcb::transaction const &, btcb::block_hash const &, std::shared_ptr<btcb::block> const &) override;
@@ -257,6 +276,10 @@ public:
 	void upgrade_v9_to_v10 (btcb::transaction const &);
 	void upgrade_v10_to_v11 (btcb::transaction const &);
 	void upgrade_v11_to_v12 (btcb::transaction const &);
+	void upgrade_v12_to_v13 (btcb::transaction const &);
+	void upgrade_v13_to_v14 (btcb::transaction const &);
+	void upgrade_v14_to_v15 (btcb::transaction const &);
+	void upgrade_v15_to_v16 (btcb::transaction const &);
 
 	// Requires a write transaction
 	btcb::raw_key get_node_id (btcb::transaction const &) override;
@@ -285,37 +308,43 @@ public:
 	MDB_dbi accounts_v1;
 
 	/**
-	 * Maps block hash to send block.
+	 * Maps block hash to block type, epoch, block and successor. Replaces the per-type tables below as of v13.
+	 * btcb::block_hash -> btcb::block_type, btcb::epoch, btcb::block, btcb::block_hash
+	 */
+	MDB_dbi blocks;
+
+	/**
+	 * Maps block hash to send block. Only present in ledgers before v13.
 	 * btcb::block_hash -> btcb::send_block
 	 */
 	MDB_dbi send_blocks;
 
 	/**
-	 * Maps block hash to receive block.
+	 * Maps block hash to receive block. Only present in ledgers before v13.
 	 * btcb::block_hash -> btcb::receive_block
 	 */
 	MDB_dbi receive_blocks;
 
 	/**
-	 * Maps block hash to open block.
+	 * Maps block hash to open block. Only present in ledgers before v13.
 	 * btcb::block_hash -> btcb::open_block
 	 */
 	MDB_dbi open_blocks;
 
 	/**
-	 * Maps block hash to change block.
+	 * Maps block hash to change block. Only present in ledgers before v13.
 	 * btcb::block_hash -> btcb::change_block
 	 */
 	MDB_dbi change_blocks;
 
 	/**
-	 * Maps block hash to v0 state block.
+	 * Maps block hash to v0 state block. Only present in ledgers before v13.
 	 * btcb::block_hash -> btcb::state_block
 	 */
 	MDB_dbi state_blocks_v0;
 
 	/**
-	 * Maps block hash to v1 state block.
+	 * Maps block hash to v1 state block. Only present in ledgers before v13.
 	 * btcb::block_hash -> btcb::state_block
 	 */
 	MDB_dbi state_blocks_v1;
@@ -344,6 +373,18 @@ public:
 	 */
 	MDB_dbi representation;
 
+	/**
+	 * Accounts by their current representative.
+	 * btcb::account, btcb::account -> nil
+	 */
+	MDB_dbi delegators;
+
+	/**
+	 * Blocks of each account chain by their height, the open block is at height 1.
+	 * btcb::account, uint64_t -> btcb::block_hash
+	 */
+	MDB_dbi account_heights;
+
 	/**
 	 * Unchecked bootstrap blocks.
 	 * btcb::block_hash -> btcb::block
@@ -368,13 +409,40 @@ public:
 	 */
 	MDB_dbi meta;
 
+	/** Size of the type and epoch prefix of values in the blocks table */
+	static size_t constexpr block_prefix_size = 2;
+
 private:
-	MDB_dbi block_database (btcb::block_type, btcb::epoch);
-	template <typename T>
-	std::shared_ptr<btcb::block> block_random (btcb::transaction const &, MDB_dbi);
-	MDB_val block_raw_get (btcb::transaction const &, btcb::block_hash const &, btcb::block_type &);
-	void block_raw_put (btcb::transaction const &, MDB_dbi, btcb::block_hash const &, MDB_val);
+	btcb::mdb_val block_raw_get (btcb::transaction const &, btcb::block_hash const &, btcb::block_type &, btcb::epoch &);
+	btcb::mdb_val block_raw_get_legacy (btcb::transaction const &, btcb::block_hash const &);
+	void block_raw_put (btcb::transaction const &, btcb::block_hash const &, btcb::mdb_val const &);
+	void block_del_legacy (btcb::transaction const &, btcb::block_hash const &);
+	void block_successor_set (btcb::transaction const &, btcb::block_hash const &, btcb::block_hash const &);
+	void block_sideband_set (btcb::transaction const &, btcb::block_hash const &, btcb::block_sideband const &);
+	/** Offset of the successor, which is also the start of the sideband if the entry has one */
+	static size_t block_successor_offset (btcb::mdb_val const &, btcb::block_type);
+	static size_t & block_count_entry (btcb::block_counts &, btcb::block_type, btcb::epoch);
+	btcb::block_counts block_counts_get (btcb::transaction const &);
+	void block_counts_put (btcb::transaction const &, btcb::block_counts const &);
+	void block_counts_update (btcb::transaction const &, btcb::block_type, btcb::epoch, btcb::block_type, btcb::epoch);
+	void block_counts_write (MDB_txn *, btcb::block_counts const &);
+	void block_counts_flush ();
 	void clear (MDB_dbi);
+	void rep_weights_load (btcb::transaction const &);
+	// True while the per-type block tables still hold entries which haven't been merged in to the blocks table
+	bool legacy_blocks;
+	void rep_weights_commit (btcb::mdb_txn const *);
+	// Non-zero entries of the committed representation table, so weights are read without touching the database
+	std::unordered_map<btcb::account, btcb::uint128_t> rep_weights;
+	// Weights written by each write transaction, which alone reads them until they're merged in to rep_weights once it commits.
+	// Keyed by the transaction object since LMDB hands the same handle to the next writer before the commit actions of the last one have run
+	std::unordered_map<btcb::mdb_txn const *, std::unordered_map<btcb::account, btcb::uint128_t>> rep_weights_pending;
+	// Block counts of the open write transaction block_counts_txn, which reads them from here. They're written to the meta table once just before it commits
+	btcb::block_counts block_counts_pending;
+	std::atomic<MDB_txn *> block_counts_txn;
+	// Set once rep_weights holds the whole table, until then upgrades read and write the database only
+	bool rep_weights_loaded;
+	std::mutex rep_weights_mutex;
 };
 class wallet_value
 {
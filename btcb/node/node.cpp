@@ -23,7 +23,14 @@ std::chrono::seconds constexpr btcb::node::search_pending_interval;
 int constexpr btcb::port_mapping::mapping_timeout;
 int constexpr btcb::port_mapping::check_timeout;
 unsigned constexpr btcb::active_transactions::announce_interval_ms;
+size_t constexpr btcb::signature_checker::batch_size;
+size_t constexpr btcb::block_processor::verification_batch_size;
+size_t constexpr btcb::block_processor::verified_max;
 size_t constexpr btcb::active_transactions::max_broadcast_queue;
+size_t constexpr btcb::active_transactions::election_shards;
+unsigned constexpr btcb::active_transactions::announce_slices;
+size_t constexpr btcb::vote_processor::max_batch;
+size_t constexpr btcb::node::sideband_upgrade_batch;
 size_t constexpr btcb::block_arrival::arrival_size_min;
 std::chrono::seconds constexpr btcb::block_arrival::arrival_time_min;
 
@@ -39,6 +46,7 @@ btcb::network::network (btcb::node & node_a, uint16_t port) :
 buffer_container (node_a.stats, btcb::network::buffer_size, 4096), // 2Mb receive buffer
 socket (node_a.io_ctx, btcb::endpoint (boost::asio::ip::address_v6::any (), port)),
 resolver (node_a.io_ctx),
+filter (node_a.config.network_filter_size),
 node (node_a),
 on (true)
 {
@@ -255,9 +263,9 @@ bool confirm_block (btcb::transaction const & transaction_a, btcb::node & node_a
 		node_a.wallets.foreach_representative (transaction_a, [&result, &block_a, &list_a, &node_a, &transaction_a, also_publish](btcb::public_key const & pub_a, btcb::raw_key const & prv_a) {
 			result = true;
 			auto hash (block_a->hash ());
-			auto vote (node_a.store.vote_generate (transaction_a, pub_a, prv_a, std::vector<btcb::block_hash> (1, hash)));
-			btcb::confirm_ack confirm (vote);
-			auto vote_bytes = confirm.to_bytes ();
+			auto vote (node_a.local_votes.vote (transaction_a, pub_a, prv_a, hash));
+			btcb::confirm_ack confirm (vote.first);
+			auto vote_bytes (vote.second);
 			btcb::publish publish (block_a);
 			std::shared_ptr<std::vector<uint8_t>> publish_bytes;
 			if (also_publish)
@@ -338,8 +346,9 @@ void btcb::network::republish_vote (std::shared_ptr<btcb::vote> vote_a)
 
 void btcb::network::broadcast_confirm_req (std::shared_ptr<btcb::block> block_a)
 {
-	auto list (std::make_shared<std::vector<btcb::peer_information>> (node.peers.representatives (std::numeric_limits<size_t>::max ())));
-	if (list->empty () || node.peers.total_weight () < node.config.online_weight_minimum.number ())
+	auto peers_l (node.peers.snapshot ());
+	auto list (std::make_shared<std::vector<btcb::peer_information>> (peers_l->representatives));
+	if (list->empty () || peers_l->total_weight < node.config.online_weight_minimum.number ())
 	{
 		// broadcast request to all peers
 		list = std::make_shared<std::vector<btcb::peer_information>> (node.peers.list_vector (100));
@@ -620,63 +629,66 @@ void btcb::network::receive_action (btcb::udp_data * data_a)
 	}
 	if (allowed_sender)
 	{
-		network_message_visitor visitor (node, data_a->endpoint);
-		btcb::message_parser parser (node.block_uniquer, node.vote_uniquer, visitor, node.work);
-		parser.deserialize_buffer (data_a->buffer, data_a->size);
-		if (parser.status != btcb::message_parser::parse_status::success)
+		if (!duplicate (data_a))
 		{
-			node.stats.inc (btcb::stat::type::error);
-
-			switch (parser.status)
+			network_message_visitor visitor (node, data_a->endpoint);
+			btcb::message_parser parser (node.block_uniquer, node.vote_uniquer, visitor, node.work);
+			parser.deserialize_buffer (data_a->buffer, data_a->size);
+			if (parser.status != btcb::message_parser::parse_status::success)
 			{
-				case btcb::message_parser::parse_status::insufficient_work:
-					// We've already increment error count, update detail only
-					node.stats.inc_detail_only (btcb::stat::type::error, btcb::stat::detail::insufficient_work);
-					break;
-				case btcb::message_parser::parse_status::invalid_magic:
-					node.stats.inc (btcb::stat::type::udp, btcb::stat::detail::invalid_magic);
-					break;
-				case btcb::message_parser::parse_status::invalid_network:
-					node.stats.inc (btcb::stat::type::udp, btcb::stat::detail::invalid_network);
-					break;
-				case btcb::message_parser::parse_status::invalid_header:
-					node.stats.inc (btcb::stat::type::udp, btcb::stat::detail::invalid_header);
-					break;
-				case btcb::message_parser::parse_status::invalid_message_type:
-					node.stats.inc (btcb::stat::type::udp, btcb::stat::detail::invalid_message_type);
-					break;
-				case btcb::message_parser::parse_status::invalid_keepalive_message:
-					node.stats.inc (btcb::stat::type::udp, btcb::stat::detail::invalid_keepalive_message);
-					break;
-				case btcb::message_parser::parse_status::invalid_publish_message:
-					node.stats.inc (btcb::stat::type::udp, btcb::stat::detail::invalid_publish_message);
-					break;
-				case btcb::message_parser::parse_status::invalid_confirm_req_message:
-					node.stats.inc (btcb::stat::type::udp, btcb::stat::detail::invalid_confirm_req_message);
-					break;
-				case btcb::message_parser::parse_status::invalid_confirm_ack_message:
-					node.stats.inc (btcb::stat::type::udp, btcb::stat::detail::invalid_confirm_ack_message);
-					break;
-				case btcb::message_parser::parse_status::invalid_node_id_handshake_message:
-					node.stats.inc (btcb::stat::type::udp, btcb::stat::detail::invalid_node_id_handshake_message);
-					break;
-				case btcb::message_parser::parse_status::outdated_version:
-					node.stats.inc (btcb::stat::type::udp, btcb::stat::detail::outdated_version);
-					break;
-				case btcb::message_parser::parse_status::success:
-					/* Already checked, unreachable */
-					break;
-			}
+				node.stats.inc (btcb::stat::type::error);
 
-			if (node.config.logging.network_logging ())
+				switch (parser.status)
+				{
+					case btcb::message_parser::parse_status::insufficient_work:
+						// We've already increment error count, update detail only
+						node.stats.inc_detail_only (btcb::stat::type::error, btcb::stat::detail::insufficient_work);
+						break;
+					case btcb::message_parser::parse_status::invalid_magic:
+						node.stats.inc (btcb::stat::type::udp, btcb::stat::detail::invalid_magic);
+						break;
+					case btcb::message_parser::parse_status::invalid_network:
+						node.stats.inc (btcb::stat::type::udp, btcb::stat::detail::invalid_network);
+						break;
+					case btcb::message_parser::parse_status::invalid_header:
+						node.stats.inc (btcb::stat::type::udp, btcb::stat::detail::invalid_header);
+						break;
+					case btcb::message_parser::parse_status::invalid_message_type:
+						node.stats.inc (btcb::stat::type::udp, btcb::stat::detail::invalid_message_type);
+						break;
+					case btcb::message_parser::parse_status::invalid_keepalive_message:
+						node.stats.inc (btcb::stat::type::udp, btcb::stat::detail::invalid_keepalive_message);
+						break;
+					case btcb::message_parser::parse_status::invalid_publish_message:
+						node.stats.inc (btcb::stat::type::udp, btcb::stat::detail::invalid_publish_message);
+						break;
+					case btcb::message_parser::parse_status::invalid_confirm_req_message:
+						node.stats.inc (btcb::stat::type::udp, btcb::stat::detail::invalid_confirm_req_message);
+						break;
+					case btcb::message_parser::parse_status::invalid_confirm_ack_message:
+						node.stats.inc (btcb::stat::type::udp, btcb::stat::detail::invalid_confirm_ack_message);
+						break;
+					case btcb::message_parser::parse_status::invalid_node_id_handshake_message:
+						node.stats.inc (btcb::stat::type::udp, btcb::stat::detail::invalid_node_id_handshake_message);
+						break;
+					case btcb::message_parser::parse_status::outdated_version:
+						node.stats.inc (btcb::stat::type::udp, btcb::stat::detail::outdated_version);
+						break;
+					case btcb::message_parser::parse_status::success:
+						/* Already checked, unreachable */
+						break;
+				}
+
+				if (node.config.logging.network_logging ())
+				{
+					BOOST_LOG (node.log) << "Could not parse message.  Error: " << parser.status_string ();
+				}
+			}
+			else
 			{
-				BOOST_LOG (node.log) << "Could not parse message.  Error: " << parser.status_string ();
+				node.stats.add (btcb::stat::type::traffic, btcb::stat::dir::in, data_a->size);
 			}
 		}
-		else
-		{
-			node.stats.add (btcb::stat::type::traffic, btcb::stat::dir::in, data_a->size);
-		}
 	}
 	else
 	{
@@ -689,6 +701,25 @@ void btcb::network::receive_action (btcb::udp_data * data_a)
 	}
 }
 
+bool btcb::network::duplicate (btcb::udp_data const * data_a)
+{
+	auto result (false);
+	// Only publish and confirm_ack are filtered, other messages are cheap to parse or are expected to repeat
+	if (data_a->size > btcb::network_filter::hash_offset)
+	{
+		auto type (static_cast<btcb::message_type> (data_a->buffer[btcb::network_filter::hash_offset]));
+		if (type == btcb::message_type::publish || type == btcb::message_type::confirm_ack)
+		{
+			result = filter.apply (data_a->buffer, data_a->size);
+			if (result)
+			{
+				node.stats.inc (btcb::stat::type::udp, type == btcb::message_type::publish ? btcb::stat::detail::duplicate_publish : btcb::stat::detail::duplicate_confirm_ack);
+			}
+		}
+	}
+	return result;
+}
+
 // Send keepalives to all the peers we've been notified of
 void btcb::network::merge_peers (std::array<btcb::endpoint, 8> const & peers_a)
 {
@@ -777,16 +808,20 @@ bool btcb::node_init::error ()
 
 btcb::vote_processor::vote_processor (btcb::node & node_a) :
 node (node_a),
-started (false),
+started (0),
 stopped (false),
-active (false),
-thread ([this]() {
-	btcb::thread_role::set (btcb::thread_role::name::vote_processing);
-	process_loop ();
-})
+active (0)
 {
+	auto count (std::max<unsigned> (1, node.config.vote_processor_threads));
+	for (unsigned i (0); i < count; ++i)
+	{
+		threads.push_back (boost::thread ([this]() {
+			btcb::thread_role::set (btcb::thread_role::name::vote_processing);
+			process_loop ();
+		}));
+	}
 	std::unique_lock<std::mutex> lock (mutex);
-	while (!started)
+	while (started < threads.size ())
 	{
 		condition.wait (lock);
 	}
@@ -801,7 +836,7 @@ void btcb::vote_processor::process_loop ()
 	bool log_this_iteration;
 
 	std::unique_lock<std::mutex> lock (mutex);
-	started = true;
+	++started;
 
 	lock.unlock ();
 	condition.notify_all ();
@@ -811,8 +846,17 @@ void btcb::vote_processor::process_loop ()
 	{
 		if (!votes.empty ())
 		{
+			// Each worker takes its own batch so verification and application run on several threads at once
 			std::deque<std::pair<std::shared_ptr<btcb::vote>, btcb::endpoint>> votes_l;
-			votes_l.swap (votes);
+			if (votes.size () <= max_batch)
+			{
+				votes_l.swap (votes);
+			}
+			else
+			{
+				votes_l.assign (std::make_move_iterator (votes.begin ()), std::make_move_iterator (votes.begin () + max_batch));
+				votes.erase (votes.begin (), votes.begin () + max_batch);
+			}
 
 			log_this_iteration = false;
 			if (node.config.logging.network_logging () && votes_l.size () > 50)
@@ -824,27 +868,18 @@ void btcb::vote_processor::process_loop ()
 				log_this_iteration = true;
 				start_time = std::chrono::steady_clock::now ();
 			}
-			active = true;
+			++active;
 			lock.unlock ();
 			verify_votes (votes_l);
 			{
-				std::unique_lock<std::mutex> active_single_lock (node.active.mutex);
 				auto transaction (node.store.tx_begin_read ());
-				uint64_t count (1);
 				for (auto & i : votes_l)
 				{
 					vote_blocking (transaction, i.first, i.second, true);
-					// Free active_transactions mutex each 100 processed votes
-					if (count % 100 == 0)
-					{
-						active_single_lock.unlock ();
-						active_single_lock.lock ();
-					}
-					count++;
 				}
 			}
 			lock.lock ();
-			active = false;
+			--active;
 
 			lock.unlock ();
 			condition.notify_all ();
@@ -878,62 +913,92 @@ void btcb::vote_processor::process_loop ()
 void btcb::vote_processor::vote (std::shared_ptr<btcb::vote> vote_a, btcb::endpoint endpoint_a)
 {
 	assert (endpoint_a.address ().is_v6 ());
-	std::unique_lock<std::mutex> lock (mutex);
-	if (!stopped)
+	// Republished copies of a vote we already verified don't take up room in the queue
+	if (!verified.exists (vote_a->full_hash ()))
 	{
-		bool process (false);
-		/* Random early delection levels
-		Always process votes for test network (process = true)
-		Stop processing with max 144 * 1024 votes */
-		if (btcb::btcb_network != btcb::btcb_networks::btcb_test_network)
+		std::unique_lock<std::mutex> lock (mutex);
+		if (!stopped)
 		{
-			// Level 0 (< 0.1%)
-			if (votes.size () < 96 * 1024)
+			bool process (false);
+			/* Random early delection levels
+			Always process votes for test network (process = true)
+			Stop processing with max 144 * 1024 votes */
+			if (btcb::btcb_network != btcb::btcb_networks::btcb_test_network)
 			{
-				process = true;
+				// Level 0 (< 0.1%)
+				if (votes.size () < 96 * 1024)
+				{
+					process = true;
+				}
+				// Level 1 (0.1-1%)
+				else if (votes.size () < 112 * 1024)
+				{
+					process = (representatives_1.find (vote_a->account) != representatives_1.end ());
+				}
+				// Level 2 (1-5%)
+				else if (votes.size () < 128 * 1024)
+				{
+					process = (representatives_2.find (vote_a->account) != representatives_2.end ());
+				}
+				// Level 3 (> 5%)
+				else if (votes.size () < 144 * 1024)
+				{
+					process = (representatives_3.find (vote_a->account) != representatives_3.end ());
+				}
 			}
-			// Level 1 (0.1-1%)
-			else if (votes.size () < 112 * 1024)
+			else
 			{
-				process = (representatives_1.find (vote_a->account) != representatives_1.end ());
+				// Process for test network
+				process = true;
 			}
-			// Level 2 (1-5%)
-			else if (votes.size () < 128 * 1024)
+			if (process)
 			{
-				process = (representatives_2.find (vote_a->account) != representatives_2.end ());
+				votes.push_back (std::make_pair (vote_a, endpoint_a));
+
+				lock.unlock ();
+				condition.notify_all ();
+				lock.lock ();
 			}
-			// Level 3 (> 5%)
-			else if (votes.size () < 144 * 1024)
+			else
 			{
-				process = (representatives_3.find (vote_a->account) != representatives_3.end ());
+				node.stats.inc (btcb::stat::type::vote, btcb::stat::detail::vote_overflow);
+				if (node.config.logging.vote_logging ())
+				{
+					BOOST_LOG (node.log) << "Votes overflow";
+				}
 			}
 		}
-		else
-		{
-			// Process for test network
-			process = true;
-		}
-		if (process)
-		{
-			votes.push_back (std::make_pair (vote_a, endpoint_a));
+	}
+	else
+	{
+		node.stats.inc (btcb::stat::type::vote_cache, btcb::stat::detail::hit);
+	}
+}
 
-			lock.unlock ();
-			condition.notify_all ();
-			lock.lock ();
-		}
-		else
+void btcb::vote_processor::verify_votes (std::deque<std::pair<std::shared_ptr<btcb::vote>, btcb::endpoint>> & votes_a)
+{
+	// Drop copies queued before the first one was verified, either in an earlier batch or in this one
+	std::vector<btcb::uint256_union> full_hashes;
+	full_hashes.reserve (votes_a.size ());
+	{
+		std::unordered_set<btcb::uint256_union> batch;
+		std::remove_reference_t<decltype (votes_a)> unique;
+		for (auto & vote : votes_a)
 		{
-			node.stats.inc (btcb::stat::type::vote, btcb::stat::detail::vote_overflow);
-			if (node.config.logging.vote_logging ())
+			auto full_hash (vote.first->full_hash ());
+			if (!verified.exists (full_hash) && batch.insert (full_hash).second)
 			{
-				BOOST_LOG (node.log) << "Votes overflow";
+				node.stats.inc (btcb::stat::type::vote_cache, btcb::stat::detail::miss);
+				unique.push_back (vote);
+				full_hashes.push_back (full_hash);
+			}
+			else
+			{
+				node.stats.inc (btcb::stat::type::vote_cache, btcb::stat::detail::hit);
 			}
 		}
+		votes_a.swap (unique);
 	}
-}
-
-void btcb::vote_processor::verify_votes (std::deque<std::pair<std::shared_ptr<btcb::vote>, btcb::endpoint>> & votes_a)
-{
 	auto size (votes_a.size ());
 	std::vector<unsigned char const *> messages;
 	messages.reserve (size);
@@ -964,6 +1029,7 @@ void btcb::vote_processor::verify_votes (std::deque<std::pair<std::shared_ptr<bt
 		assert (verifications[i] == 1 || verifications[i] == 0);
 		if (verifications[i] == 1)
 		{
+			verified.insert (full_hashes[i]);
 			result.push_back (vote);
 		}
 		++i;
@@ -971,17 +1037,15 @@ void btcb::vote_processor::verify_votes (std::deque<std::pair<std::shared_ptr<bt
 	votes_a.swap (result);
 }
 
-// node.active.mutex lock required
 btcb::vote_code btcb::vote_processor::vote_blocking (btcb::transaction const & transaction_a, std::shared_ptr<btcb::vote> vote_a, btcb::endpoint endpoint_a, bool validated)
 {
 	assert (endpoint_a.address ().is_v6 ());
-	assert (!node.active.mutex.try_lock ());
 	auto result (btcb::vote_code::invalid);
 	if (validated || !vote_a->validate ())
 	{
 		auto max_vote (node.store.vote_max (transaction_a, vote_a));
 		result = btcb::vote_code::replay;
-		if (!node.active.vote (vote_a, true))
+		if (!node.active.vote (vote_a))
 		{
 			result = btcb::vote_code::vote;
 		}
@@ -1034,16 +1098,19 @@ void btcb::vote_processor::stop ()
 		stopped = true;
 	}
 	condition.notify_all ();
-	if (thread.joinable ())
+	for (auto & i : threads)
 	{
-		thread.join ();
+		if (i.joinable ())
+		{
+			i.join ();
+		}
 	}
 }
 
 void btcb::vote_processor::flush ()
 {
 	std::unique_lock<std::mutex> lock (mutex);
-	while (active || !votes.empty ())
+	while (active > 0 || !votes.empty ())
 	{
 		condition.wait (lock);
 	}
@@ -1097,13 +1164,18 @@ bool btcb::rep_crawler::exists (btcb::block_hash const & hash_a)
 	return active.count (hash_a) != 0;
 }
 
-btcb::signature_checker::signature_checker () :
-started (false),
-stopped (false),
-thread ([this]() { run (); })
+btcb::signature_checker::signature_checker (unsigned num_threads_a) :
+started (0),
+active (0),
+stopped (false)
 {
+	auto num_threads (std::max<unsigned> (1, num_threads_a));
+	for (auto i (0u); i < num_threads; ++i)
+	{
+		threads.push_back (std::thread ([this]() { run (); }));
+	}
 	std::unique_lock<std::mutex> lock (mutex);
-	while (!started)
+	while (started < threads.size ())
 	{
 		condition.wait (lock);
 	}
@@ -1116,9 +1188,20 @@ btcb::signature_checker::~signature_checker ()
 
 void btcb::signature_checker::add (btcb::signature_check_set & check_a)
 {
+	auto chunks ((check_a.size + batch_size - 1) / batch_size);
+	auto pending (std::make_shared<std::atomic<size_t>> (std::max<size_t> (1, chunks)));
 	{
 		std::lock_guard<std::mutex> lock (mutex);
-		checks.push_back (check_a);
+		if (chunks == 0)
+		{
+			checks.push_back ({ check_a, pending });
+		}
+		for (size_t i (0); i < chunks; ++i)
+		{
+			auto offset (i * batch_size);
+			btcb::signature_check_set check = { std::min (batch_size, check_a.size - offset), check_a.messages + offset, check_a.message_lengths + offset, check_a.pub_keys + offset, check_a.signatures + offset, check_a.verifications + offset, check_a.promise };
+			checks.push_back ({ check, pending });
+		}
 	}
 	condition.notify_all ();
 }
@@ -1129,36 +1212,44 @@ void btcb::signature_checker::stop ()
 	stopped = true;
 	lock.unlock ();
 	condition.notify_all ();
-	if (thread.joinable ())
+	for (auto & thread : threads)
 	{
-		thread.join ();
+		if (thread.joinable ())
+		{
+			thread.join ();
+		}
 	}
 }
 
 void btcb::signature_checker::flush ()
 {
 	std::unique_lock<std::mutex> lock (mutex);
-	while (!stopped && !checks.empty ())
+	while (!stopped && (!checks.empty () || active > 0))
 	{
 		condition.wait (lock);
 	}
 }
 
-void btcb::signature_checker::verify (btcb::signature_check_set & check_a)
+void btcb::signature_checker::verify (btcb::signature_checker::chunk & chunk_a)
 {
+	auto & check (chunk_a.check);
 	/* Verifications is vector if signatures check results
 	 validate_message_batch returing "true" if there are at least 1 invalid signature */
-	auto code (btcb::validate_message_batch (check_a.messages, check_a.message_lengths, check_a.pub_keys, check_a.signatures, check_a.size, check_a.verifications));
+	auto code (btcb::validate_message_batch (check.messages, check.message_lengths, check.pub_keys, check.signatures, check.size, check.verifications));
 	(void)code;
-	release_assert (std::all_of (check_a.verifications, check_a.verifications + check_a.size, [](int verification) { return verification == 0 || verification == 1; }));
-	check_a.promise->set_value ();
+	release_assert (std::all_of (check.verifications, check.verifications + check.size, [](int verification) { return verification == 0 || verification == 1; }));
+	// The last chunk of a set to finish completes the caller's promise
+	if (--(*chunk_a.pending) == 0)
+	{
+		check.promise->set_value ();
+	}
 }
 
 void btcb::signature_checker::run ()
 {
 	btcb::thread_role::set (btcb::thread_role::name::signature_checking);
 	std::unique_lock<std::mutex> lock (mutex);
-	started = true;
+	++started;
 
 	lock.unlock ();
 	condition.notify_all ();
@@ -1168,10 +1259,14 @@ void btcb::signature_checker::run ()
 	{
 		if (!checks.empty ())
 		{
-			auto check (checks.front ());
+			auto chunk (checks.front ());
 			checks.pop_front ();
+			++active;
+			lock.unlock ();
+			verify (chunk);
+			lock.lock ();
+			--active;
 			lock.unlock ();
-			verify (check);
 			condition.notify_all ();
 			lock.lock ();
 		}
@@ -1185,6 +1280,7 @@ void btcb::signature_checker::run ()
 btcb::block_processor::block_processor (btcb::node & node_a) :
 stopped (false),
 active (false),
+verifying (false),
 next_log (std::chrono::steady_clock::now ()),
 node (node_a),
 generator (node_a, btcb::btcb_network == btcb::btcb_networks::btcb_test_network ? std::chrono::milliseconds (10) : std::chrono::milliseconds (500))
@@ -1210,7 +1306,7 @@ void btcb::block_processor::flush ()
 {
 	node.checker.flush ();
 	std::unique_lock<std::mutex> lock (mutex);
-	while (!stopped && (have_blocks () || active))
+	while (!stopped && (have_blocks () || active || verifying))
 	{
 		condition.wait (lock);
 	}
@@ -1224,29 +1320,65 @@ bool btcb::block_processor::full ()
 
 void btcb::block_processor::add (std::shared_ptr<btcb::block> block_a, std::chrono::steady_clock::time_point origination)
 {
-	if (!btcb::work_validate (block_a->root (), block_a->block_work ()))
+	if (work_valid (*block_a))
+	{
+		{
+			std::lock_guard<std::mutex> lock (mutex);
+			queue (block_a, origination);
+		}
+		condition.notify_all ();
+	}
+}
+
+void btcb::block_processor::add (std::vector<std::shared_ptr<btcb::block>> const & blocks_a, std::chrono::steady_clock::time_point origination)
+{
+	// Work is checked before taking the lock so the processing thread isn't held up by a whole batch of checks
+	std::vector<std::shared_ptr<btcb::block>> valid;
+	valid.reserve (blocks_a.size ());
+	for (auto & block : blocks_a)
+	{
+		if (work_valid (*block))
+		{
+			valid.push_back (block);
+		}
+	}
+	if (!valid.empty ())
 	{
 		{
 			std::lock_guard<std::mutex> lock (mutex);
-			if (blocks_hashes.find (block_a->hash ()) == blocks_hashes.end ())
+			for (auto & block : valid)
 			{
-				if (block_a->type () == btcb::block_type::state && !node.ledger.is_epoch_link (block_a->link ()))
-				{
-					state_blocks.push_back (std::make_pair (block_a, origination));
-				}
-				else
-				{
-					blocks.push_back (std::make_pair (block_a, origination));
-				}
+				queue (block, origination);
 			}
-			condition.notify_all ();
 		}
+		condition.notify_all ();
 	}
-	else
+}
+
+bool btcb::block_processor::work_valid (btcb::block const & block_a)
+{
+	auto result (!btcb::work_validate (block_a.root (), block_a.block_work ()));
+	if (!result)
 	{
-		BOOST_LOG (node.log) << "btcb::block_processor::add called for hash " << block_a->hash ().to_string () << " with invalid work " << btcb::to_string_hex (block_a->block_work ());
+		BOOST_LOG (node.log) << "btcb::block_processor::add called for hash " << block_a.hash ().to_string () << " with invalid work " << btcb::to_string_hex (block_a.block_work ());
 		assert (false && "btcb::block_processor::add called with invalid work");
 	}
+	return result;
+}
+
+void btcb::block_processor::queue (std::shared_ptr<btcb::block> block_a, std::chrono::steady_clock::time_point origination)
+{
+	if (blocks_hashes.find (block_a->hash ()) == blocks_hashes.end ())
+	{
+		if (block_a->type () == btcb::block_type::state && !node.ledger.is_epoch_link (block_a->link ()))
+		{
+			state_blocks.push_back (std::make_pair (block_a, origination));
+		}
+		else
+		{
+			blocks.push_back (std::make_pair (block_a, origination));
+		}
+	}
 }
 
 void btcb::block_processor::force (std::shared_ptr<btcb::block> block_a)
@@ -1263,7 +1395,7 @@ void btcb::block_processor::process_blocks ()
 	std::unique_lock<std::mutex> lock (mutex);
 	while (!stopped)
 	{
-		if (have_blocks ())
+		if (!blocks.empty () || !forced.empty ())
 		{
 			active = true;
 			lock.unlock ();
@@ -1282,6 +1414,27 @@ void btcb::block_processor::process_blocks ()
 	}
 }
 
+void btcb::block_processor::verify_blocks ()
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	while (!stopped)
+	{
+		if (!state_blocks.empty () && blocks.size () < verified_max)
+		{
+			verifying = true;
+			verify_state_blocks (lock, verification_batch_size);
+			verifying = false;
+			lock.unlock ();
+			condition.notify_all ();
+			lock.lock ();
+		}
+		else
+		{
+			condition.wait (lock);
+		}
+	}
+}
+
 bool btcb::block_processor::should_log (bool first_time)
 {
 	auto result (false);
@@ -1354,9 +1507,14 @@ void btcb::block_processor::verify_state_blocks (std::unique_lock<std::mutex> &
 		}
 		items.pop_front ();
 	}
+	auto end_time (std::chrono::steady_clock::now ());
+	node.stats.inc (btcb::stat::type::block_processor, btcb::stat::detail::verification_batches);
+	node.stats.add (btcb::stat::type::block_processor, btcb::stat::detail::verified_blocks, btcb::stat::dir::in, size);
+	node.stats.add (btcb::stat::type::block_processor, btcb::stat::detail::verification_time, btcb::stat::dir::in, std::chrono::duration_cast<std::chrono::microseconds> (end_time - start_time).count ());
+	// Summed on every hand-off, divide by verification_batches for the average depth
+	node.stats.add (btcb::stat::type::block_processor, btcb::stat::detail::verified_queue_depth, btcb::stat::dir::in, blocks.size ());
 	if (node.config.logging.timing_logging ())
 	{
-		auto end_time (std::chrono::steady_clock::now ());
 		auto elapsed_time_ms (std::chrono::duration_cast<std::chrono::milliseconds> (end_time - start_time));
 		auto elapsed_time_ms_int (elapsed_time_ms.count ());
 
@@ -1366,89 +1524,85 @@ void btcb::block_processor::verify_state_blocks (std::unique_lock<std::mutex> &
 
 void btcb::block_processor::process_receive_many (std::unique_lock<std::mutex> & lock_a)
 {
-	lock_a.lock ();
 	auto start_time (std::chrono::steady_clock::now ());
-	// Limit state blocks verification time
-	while (!state_blocks.empty () && std::chrono::steady_clock::now () - start_time < std::chrono::seconds (2))
-	{
-		verify_state_blocks (lock_a, 2048);
-	}
-	lock_a.unlock ();
-	auto transaction (node.store.tx_begin_write ());
-	start_time = std::chrono::steady_clock::now ();
-	lock_a.lock ();
-	// Processing blocks
-	auto first_time (true);
 	unsigned number_of_blocks_processed (0), number_of_forced_processed (0);
-	while ((!blocks.empty () || !forced.empty ()) && std::chrono::steady_clock::now () - start_time < node.config.block_processor_batch_max_time)
 	{
-		auto log_this_record (false);
-		if (node.config.logging.timing_logging ())
+		auto transaction (node.store.tx_begin_write ());
+		auto batch_start_time (std::chrono::steady_clock::now ());
+		lock_a.lock ();
+		// Processing blocks
+		auto first_time (true);
+		while ((!blocks.empty () || !forced.empty ()) && std::chrono::steady_clock::now () - batch_start_time < node.config.block_processor_batch_max_time)
 		{
-			if (should_log (first_time))
+			auto log_this_record (false);
+			if (node.config.logging.timing_logging ())
 			{
-				log_this_record = true;
+				if (should_log (first_time))
+				{
+					log_this_record = true;
+				}
 			}
-		}
-		else
-		{
-			if (((blocks.size () + state_blocks.size () + forced.size ()) > 64 && should_log (false)))
+			else
 			{
-				log_this_record = true;
+				if (((blocks.size () + state_blocks.size () + forced.size ()) > 64 && should_log (false)))
+				{
+					log_this_record = true;
+				}
 			}
-		}
 
-		if (log_this_record)
-		{
-			first_time = false;
-			BOOST_LOG (node.log) << boost::str (boost::format ("%1% blocks (+ %2% state blocks) (+ %3% forced) in processing queue") % blocks.size () % state_blocks.size () % forced.size ());
-		}
-		std::pair<std::shared_ptr<btcb::block>, std::chrono::steady_clock::time_point> block;
-		bool force (false);
-		if (forced.empty ())
-		{
-			block = blocks.front ();
-			blocks.pop_front ();
-			blocks_hashes.erase (block.first->hash ());
-		}
-		else
-		{
-			block = std::make_pair (forced.front (), std::chrono::steady_clock::now ());
-			forced.pop_front ();
-			force = true;
-			number_of_forced_processed++;
-		}
-		lock_a.unlock ();
-		auto hash (block.first->hash ());
-		if (force)
-		{
-			auto successor (node.ledger.successor (transaction, block.first->root ()));
-			if (successor != nullptr && successor->hash () != hash)
+			if (log_this_record)
 			{
-				// Replace our block with the winner and roll back any dependent blocks
-				BOOST_LOG (node.log) << boost::str (boost::format ("Rolling back %1% and replacing with %2%") % successor->hash ().to_string () % hash.to_string ());
-				node.ledger.rollback (transaction, successor->hash ());
+				first_time = false;
+				BOOST_LOG (node.log) << boost::str (boost::format ("%1% blocks (+ %2% state blocks) (+ %3% forced) in processing queue") % blocks.size () % state_blocks.size () % forced.size ());
 			}
+			std::pair<std::shared_ptr<btcb::block>, std::chrono::steady_clock::time_point> block;
+			bool force (false);
+			if (forced.empty ())
+			{
+				block = blocks.front ();
+				blocks.pop_front ();
+				blocks_hashes.erase (block.first->hash ());
+				if (blocks.size () + 1 == verified_max)
+				{
+					// Room for another verified batch
+					condition.notify_all ();
+				}
+			}
+			else
+			{
+				block = std::make_pair (forced.front (), std::chrono::steady_clock::now ());
+				forced.pop_front ();
+				force = true;
+				number_of_forced_processed++;
+			}
+			lock_a.unlock ();
+			auto hash (block.first->hash ());
+			if (force)
+			{
+				auto successor (node.ledger.successor (transaction, block.first->root ()));
+				if (successor != nullptr && successor->hash () != hash)
+				{
+					// Replace our block with the winner and roll back any dependent blocks
+					BOOST_LOG (node.log) << boost::str (boost::format ("Rolling back %1% and replacing with %2%") % successor->hash ().to_string () % hash.to_string ());
+					node.ledger.rollback (transaction, successor->hash ());
+				}
+			}
+			/* Forced state blocks are not validated in verify_state_blocks () function
+			Because of that we should set set validated_state_block as "false" for forced state blocks (!force) */
+			bool validated_state_block (!force && block.first->type () == btcb::block_type::state);
+			auto process_result (process_receive_one (transaction, block.first, block.second, validated_state_block));
+			number_of_blocks_processed++;
+			(void)process_result;
+			lock_a.lock ();
 		}
-		/* Forced state blocks are not validated in verify_state_blocks () function
-		Because of that we should set set validated_state_block as "false" for forced state blocks (!force) */
-		bool validated_state_block (!force && block.first->type () == btcb::block_type::state);
-		auto process_result (process_receive_one (transaction, block.first, block.second, validated_state_block));
-		number_of_blocks_processed++;
-		(void)process_result;
-		lock_a.lock ();
-		/* Verify more state blocks if blocks deque is empty
-		Because verification is long process, avoid large deque verification inside of write transaction */
-		if (blocks.empty () && !state_blocks.empty ())
-		{
-			verify_state_blocks (lock_a, 256);
-		}
+		lock_a.unlock ();
 	}
-	lock_a.unlock ();
-
+	auto end_time (std::chrono::steady_clock::now ());
+	node.stats.inc (btcb::stat::type::block_processor, btcb::stat::detail::write_batches);
+	node.stats.add (btcb::stat::type::block_processor, btcb::stat::detail::written_blocks, btcb::stat::dir::in, number_of_blocks_processed);
+	node.stats.add (btcb::stat::type::block_processor, btcb::stat::detail::write_time, btcb::stat::dir::in, std::chrono::duration_cast<std::chrono::microseconds> (end_time - start_time).count ());
 	if (node.config.logging.timing_logging ())
 	{
-		auto end_time (std::chrono::steady_clock::now ());
 		auto elapsed_time_ms (std::chrono::duration_cast<std::chrono::milliseconds> (end_time - start_time));
 		auto elapsed_time_ms_int (elapsed_time_ms.count ());
 
@@ -1488,7 +1642,7 @@ btcb::process_return btcb::block_processor::process_receive_one (btcb::transacti
 			{
 				BOOST_LOG (node.log) << boost::str (boost::format ("Gap previous for: %1%") % hash.to_string ());
 			}
-			node.store.unchecked_put (transaction_a, block_a->previous (), block_a);
+			node.unchecked.put (transaction_a, block_a->previous (), block_a);
 			node.gap_cache.add (transaction_a, block_a);
 			break;
 		}
@@ -1498,7 +1652,7 @@ btcb::process_return btcb::block_processor::process_receive_one (btcb::transacti
 			{
 				BOOST_LOG (node.log) << boost::str (boost::format ("Gap source for: %1%") % hash.to_string ());
 			}
-			node.store.unchecked_put (transaction_a, node.ledger.block_source (transaction_a, *block_a), block_a);
+			node.unchecked.put (transaction_a, node.ledger.block_source (transaction_a, *block_a), block_a);
 			node.gap_cache.add (transaction_a, block_a);
 			break;
 		}
@@ -1584,10 +1738,9 @@ btcb::process_return btcb::block_processor::process_receive_one (btcb::transacti
 
 void btcb::block_processor::queue_unchecked (btcb::transaction const & transaction_a, btcb::block_hash const & hash_a)
 {
-	auto cached (node.store.unchecked_get (transaction_a, hash_a));
+	auto cached (node.unchecked.pop (transaction_a, hash_a));
 	for (auto i (cached.begin ()), n (cached.end ()); i != n; ++i)
 	{
-		node.store.unchecked_del (transaction_a, btcb::unchecked_key (hash_a, (*i)->hash ()));
 		add (*i, std::chrono::steady_clock::time_point ());
 	}
 	std::lock_guard<std::mutex> lock (node.gap_cache.mutex);
@@ -1607,6 +1760,7 @@ work (work_a),
 store_impl (std::make_unique<btcb::mdb_store> (init_a.block_store_init, application_path_a / "data.ldb", config_a.lmdb_max_dbs)),
 store (*store_impl),
 gap_cache (*this),
+unchecked (*this),
 ledger (store, stats, config.epoch_block_link, config.epoch_block_signer),
 active (*this),
 network (*this, config.peering_port),
@@ -1616,6 +1770,7 @@ peers (network.endpoint ()),
 application_path (application_path_a),
 wallets (init_a.block_store_init, *this),
 port_mapping (*this),
+checker (config.signature_checker_threads),
 vote_processor (*this),
 warmed_up (0),
 block_processor (*this),
@@ -1623,9 +1778,15 @@ block_processor_thread ([this]() {
 	btcb::thread_role::set (btcb::thread_role::name::block_processing);
 	this->block_processor.process_blocks ();
 }),
+block_verification_thread ([this]() {
+	btcb::thread_role::set (btcb::thread_role::name::block_verification);
+	this->block_processor.verify_blocks ();
+}),
 online_reps (*this),
 stats (config.stat_config),
-vote_uniquer (block_uniquer)
+http_callbacks (*this),
+vote_uniquer (block_uniquer),
+local_votes (*this)
 {
 	wallets.observer = [this](bool active) {
 		observers.wallet.notify (active);
@@ -1657,91 +1818,7 @@ vote_uniquer (block_uniquer)
 					std::stringstream ostream;
 					boost::property_tree::write_json (ostream, event);
 					ostream.flush ();
-					auto body (std::make_shared<std::string> (ostream.str ()));
-					auto address (node_l->config.callback_address);
-					auto port (node_l->config.callback_port);
-					auto target (std::make_shared<std::string> (node_l->config.callback_target));
-					auto resolver (std::make_shared<boost::asio::ip::tcp::resolver> (node_l->io_ctx));
-					resolver->async_resolve (boost::asio::ip::tcp::resolver::query (address, std::to_string (port)), [node_l, address, port, target, body, resolver](boost::system::error_code const & ec, boost::asio::ip::tcp::resolver::iterator i_a) {
-						if (!ec)
-						{
-							for (auto i (i_a), n (boost::asio::ip::tcp::resolver::iterator{}); i != n; ++i)
-							{
-								auto sock (std::make_shared<boost::asio::ip::tcp::socket> (node_l->io_ctx));
-								sock->async_connect (i->endpoint (), [node_l, target, body, sock, address, port](boost::system::error_code const & ec) {
-									if (!ec)
-									{
-										auto req (std::make_shared<boost::beast::http::request<boost::beast::http::string_body>> ());
-										req->method (boost::beast::http::verb::post);
-										req->target (*target);
-										req->version (11);
-										req->insert (boost::beast::http::field::host, address);
-										req->insert (boost::beast::http::field::content_type, "application/json");
-										req->body () = *body;
-										//req->prepare (*req);
-										//boost::beast::http::prepare(req);
-										req->prepare_payload ();
-										boost::beast::http::async_write (*sock, *req, [node_l, sock, address, port, req](boost::system::error_code const & ec, size_t bytes_transferred) {
-											if (!ec)
-											{
-												auto sb (std::make_shared<boost::beast::flat_buffer> ());
-												auto resp (std::make_shared<boost::beast::http::response<boost::beast::http::string_body>> ());
-												boost::beast::http::async_read (*sock, *sb, *resp, [node_l, sb, resp, sock, address, port](boost::system::error_code const & ec, size_t bytes_transferred) {
-													if (!ec)
-													{
-														if (resp->result () == boost::beast::http::status::ok)
-														{
-															node_l->stats.inc (btcb::stat::type::http_callback, btcb::stat::detail::initiate, btcb::stat::dir::out);
-														}
-														else
-														{
-															if (node_l->config.logging.callback_logging ())
-															{
-																BOOST_LOG (node_l->log) << boost::str (boost::format ("Callback to %1%:%2% failed with status: %3%") % address % port % resp->result ());
-															}
-															node_l->stats.inc (btcb::stat::type::error, btcb::stat::detail::http_callback, btcb::stat::dir::out);
-														}
-													}
-													else
-													{
-														if (node_l->config.logging.callback_logging ())
-														{
-															BOOST_LOG (node_l->log) << boost::str (boost::format ("Unable complete callback: %1%:%2%: %3%") % address % port % ec.message ());
-														}
-														node_l->stats.inc (btcb::stat::type::error, btcb::stat::detail::http_callback, btcb::stat::dir::out);
-													};
-												});
-											}
-											else
-											{
-												if (node_l->config.logging.callback_logging ())
-												{
-													BOOST_LOG (node_l->log) << boost::str (boost::format ("Unable to send callback: %1%:%2%: %3%") % address % port % ec.message ());
-												}
-												node_l->stats.inc (btcb::stat::type::error, btcb::stat::detail::http_callback, btcb::stat::dir::out);
-											}
-										});
-									}
-									else
-									{
-										if (node_l->config.logging.callback_logging ())
-										{
-											BOOST_LOG (node_l->log) << boost::str (boost::format ("Unable to connect to callback address: %1%:%2%: %3%") % address % port % ec.message ());
-										}
-										node_l->stats.inc (btcb::stat::type::error, btcb::stat::detail::http_callback, btcb::stat::dir::out);
-									}
-								});
-							}
-						}
-						else
-						{
-							if (node_l->config.logging.callback_logging ())
-							{
-								BOOST_LOG (node_l->log) << boost::str (boost::format ("Error resolving callback: %1%:%2%: %3%") % address % port % ec.message ());
-							}
-							node_l->stats.inc (btcb::stat::type::error, btcb::stat::detail::http_callback, btcb::stat::dir::out);
-						}
-					});
+					node_l->http_callbacks.add (ostream.str ());
 				});
 			}
 		});
@@ -1778,7 +1855,7 @@ vote_uniquer (block_uniquer)
 				{
 					BOOST_LOG (log) << boost::str (boost::format ("Found a representative at %1%") % endpoint_a);
 					// Rebroadcasting all active votes to new representative
-					auto blocks (this->active.list_blocks (true));
+					auto blocks (this->active.list_blocks ());
 					for (auto i (blocks.begin ()), n (blocks.end ()); i != n; ++i)
 					{
 						if (*i != nullptr)
@@ -2031,11 +2108,14 @@ void btcb::node::start ()
 	network.start ();
 	ongoing_keepalive ();
 	ongoing_syn_cookie_cleanup ();
+	ongoing_network_filter_rotation ();
+	ongoing_unchecked_cleanup ();
 	if (!flags.disable_legacy_bootstrap)
 	{
 		ongoing_bootstrap ();
 	}
 	ongoing_store_flush ();
+	ongoing_sideband_upgrade ();
 	ongoing_rep_crawl ();
 	ongoing_rep_calculation ();
 	if (!flags.disable_bootstrap_listener)
@@ -2060,6 +2140,15 @@ void btcb::node::stop ()
 	{
 		block_processor_thread.join ();
 	}
+	if (block_verification_thread.joinable ())
+	{
+		block_verification_thread.join ();
+	}
+	if (unchecked.size () > 0)
+	{
+		auto transaction (store.tx_begin_write ());
+		unchecked.flush (transaction);
+	}
 	vote_processor.stop ();
 	active.stop ();
 	network.stop ();
@@ -2067,6 +2156,7 @@ void btcb::node::stop ()
 	bootstrap.stop ();
 	port_mapping.stop ();
 	checker.stop ();
+	http_callbacks.stop ();
 	wallets.stop ();
 }
 
@@ -2152,6 +2242,30 @@ void btcb::node::ongoing_syn_cookie_cleanup ()
 	});
 }
 
+void btcb::node::ongoing_network_filter_rotation ()
+{
+	network.filter.rotate ();
+	std::weak_ptr<btcb::node> node_w (shared_from_this ());
+	alarm.add (std::chrono::steady_clock::now () + config.network_filter_expiry, [node_w]() {
+		if (auto node_l = node_w.lock ())
+		{
+			node_l->ongoing_network_filter_rotation ();
+		}
+	});
+}
+
+void btcb::node::ongoing_unchecked_cleanup ()
+{
+	unchecked.expire (std::chrono::steady_clock::now () - config.unchecked_cache_cutoff);
+	std::weak_ptr<btcb::node> node_w (shared_from_this ());
+	alarm.add (std::chrono::steady_clock::now () + btcb::unchecked_cache::cleanup_interval, [node_w]() {
+		if (auto node_l = node_w.lock ())
+		{
+			node_l->ongoing_unchecked_cleanup ();
+		}
+	});
+}
+
 void btcb::node::ongoing_rep_crawl ()
 {
 	auto now (std::chrono::steady_clock::now ());
@@ -2219,6 +2333,26 @@ void btcb::node::ongoing_store_flush ()
 	});
 }
 
+void btcb::node::ongoing_sideband_upgrade ()
+{
+	auto done (false);
+	{
+		auto transaction (store.tx_begin_write ());
+		done = store.sideband_upgrade (transaction, sideband_upgrade_batch);
+	}
+	if (!done)
+	{
+		// Short batches with a pause between them so block processing isn't held up by the upgrade's write transaction
+		std::weak_ptr<btcb::node> node_w (shared_from_this ());
+		alarm.add (std::chrono::steady_clock::now () + std::chrono::milliseconds (50), [node_w]() {
+			if (auto node_l = node_w.lock ())
+			{
+				node_l->ongoing_sideband_upgrade ();
+			}
+		});
+	}
+}
+
 void btcb::node::backup_wallet ()
 {
 	auto transaction (store.tx_begin_read ());
@@ -2282,18 +2416,19 @@ public:
 class distributed_work : public std::enable_shared_from_this<distributed_work>
 {
 public:
-	distributed_work (std::shared_ptr<btcb::node> const & node_a, btcb::block_hash const & root_a, std::function<void(uint64_t)> callback_a, uint64_t difficulty_a) :
-	distributed_work (1, node_a, root_a, callback_a, difficulty_a)
+	distributed_work (std::shared_ptr<btcb::node> const & node_a, btcb::block_hash const & root_a, std::function<void(uint64_t)> callback_a, uint64_t difficulty_a, btcb::work_priority priority_a) :
+	distributed_work (1, node_a, root_a, callback_a, difficulty_a, priority_a)
 	{
 		assert (node_a != nullptr);
 	}
-	distributed_work (unsigned int backoff_a, std::shared_ptr<btcb::node> const & node_a, btcb::block_hash const & root_a, std::function<void(uint64_t)> callback_a, uint64_t difficulty_a) :
+	distributed_work (unsigned int backoff_a, std::shared_ptr<btcb::node> const & node_a, btcb::block_hash const & root_a, std::function<void(uint64_t)> callback_a, uint64_t difficulty_a, btcb::work_priority priority_a) :
 	callback (callback_a),
 	backoff (backoff_a),
 	node (node_a),
 	root (root_a),
 	need_resolve (node_a->config.work_peers),
-	difficulty (difficulty_a)
+	difficulty (difficulty_a),
+	priority (priority_a)
 	{
 		assert (node_a != nullptr);
 		completed.clear ();
@@ -2499,7 +2634,7 @@ public:
 					node->work.generate (root, [callback_l](boost::optional<uint64_t> const & work_a) {
 						callback_l (work_a.value ());
 					},
-					difficulty);
+					difficulty, priority);
 				}
 				else
 				{
@@ -2512,10 +2647,10 @@ public:
 					auto callback_l (callback);
 					std::weak_ptr<btcb::node> node_w (node);
 					auto next_backoff (std::min (backoff * 2, (unsigned int)60 * 5));
-					node->alarm.add (now + std::chrono::seconds (backoff), [node_w, root_l, callback_l, next_backoff, difficulty = difficulty] {
+					node->alarm.add (now + std::chrono::seconds (backoff), [node_w, root_l, callback_l, next_backoff, difficulty = difficulty, priority = priority] {
 						if (auto node_l = node_w.lock ())
 						{
-							auto work_generation (std::make_shared<distributed_work> (next_backoff, node_l, root_l, callback_l, difficulty));
+							auto work_generation (std::make_shared<distributed_work> (next_backoff, node_l, root_l, callback_l, difficulty, priority));
 							work_generation->start ();
 						}
 					});
@@ -2538,6 +2673,7 @@ public:
 	std::vector<std::pair<std::string, uint16_t>> need_resolve;
 	std::atomic_flag completed;
 	uint64_t difficulty;
+	btcb::work_priority priority;
 };
 }
 
@@ -2546,19 +2682,19 @@ void btcb::node::work_generate_blocking (btcb::block & block_a, uint64_t difficu
 	block_a.block_work_set (work_generate_blocking (block_a.root (), difficulty_a));
 }
 
-void btcb::node::work_generate (btcb::uint256_union const & hash_a, std::function<void(uint64_t)> callback_a, uint64_t difficulty_a)
+void btcb::node::work_generate (btcb::uint256_union const & hash_a, std::function<void(uint64_t)> callback_a, uint64_t difficulty_a, btcb::work_priority priority_a)
 {
-	auto work_generation (std::make_shared<distributed_work> (shared (), hash_a, callback_a, difficulty_a));
+	auto work_generation (std::make_shared<distributed_work> (shared (), hash_a, callback_a, difficulty_a, priority_a));
 	work_generation->start ();
 }
 
-uint64_t btcb::node::work_generate_blocking (btcb::uint256_union const & hash_a, uint64_t difficulty_a)
+uint64_t btcb::node::work_generate_blocking (btcb::uint256_union const & hash_a, uint64_t difficulty_a, btcb::work_priority priority_a)
 {
 	std::promise<uint64_t> promise;
 	work_generate (hash_a, [&promise](uint64_t work_a) {
 		promise.set_value (work_a);
 	},
-	difficulty_a);
+	difficulty_a, priority_a);
 	return promise.get_future ().get ();
 }
 
@@ -2979,7 +3115,7 @@ void btcb::election::compute_rep_votes (btcb::transaction const & transaction_a)
 	}
 }
 
-void btcb::election::confirm_once (btcb::transaction const & transaction_a)
+void btcb::election::confirm_once ()
 {
 	if (!confirmed.exchange (true))
 	{
@@ -2992,24 +3128,28 @@ void btcb::election::confirm_once (btcb::transaction const & transaction_a)
 			node_l->process_confirmed (winner_l);
 			confirmation_action_l (winner_l);
 		});
-		confirm_back (transaction_a);
+		confirm_back ();
 	}
 }
 
-void btcb::election::confirm_back (btcb::transaction const & transaction_a)
+void btcb::election::confirm_back ()
 {
-	std::vector<btcb::block_hash> hashes = { status.winner->previous (), status.winner->source (), status.winner->link () };
-	for (auto & hash : hashes)
+	std::vector<btcb::block_hash> hashes;
+	for (auto & hash : { status.winner->previous (), status.winner->source (), status.winner->link () })
 	{
 		if (!hash.is_zero () && !node.ledger.is_epoch_link (hash))
 		{
-			auto existing (node.active.blocks.find (hash));
-			if (existing != node.active.blocks.end () && !existing->second->confirmed && !existing->second->stopped && existing->second->blocks.size () == 1)
-			{
-				existing->second->confirm_once (transaction_a);
-			}
+			hashes.push_back (hash);
 		}
 	}
+	if (!hashes.empty ())
+	{
+		// Dependencies may be in other shards, confirming them here while holding this election's shard lock could deadlock
+		auto node_l (node.shared ());
+		node.background ([node_l, hashes]() {
+			node_l->active.confirm_back (hashes);
+		});
+	}
 }
 
 void btcb::election::stop ()
@@ -3076,7 +3216,7 @@ void btcb::election::confirm_if_quorum (btcb::transaction const & transaction_a)
 		{
 			log_votes (tally_l);
 		}
-		confirm_once (transaction_a);
+		confirm_once ();
 	}
 }
 
@@ -3226,145 +3366,159 @@ bool btcb::election::publish (std::shared_ptr<btcb::block> block_a)
 	return result;
 }
 
+namespace
+{
+btcb::uint128_t backlog_balance (btcb::block const & block_a)
+{
+	btcb::uint128_t result (0);
+	switch (block_a.type ())
+	{
+		case btcb::block_type::send:
+			result = static_cast<btcb::send_block const &> (block_a).hashables.balance.number ();
+			break;
+		case btcb::block_type::state:
+			result = static_cast<btcb::state_block const &> (block_a).hashables.balance.number ();
+			break;
+		default:
+			break;
+	}
+	return result;
+}
+}
+
 void btcb::active_transactions::announce_votes (std::unique_lock<std::mutex> & lock_a)
 {
-	std::unordered_set<btcb::block_hash> inactive;
-	auto transaction (node.store.tx_begin_read ());
-	unsigned unconfirmed_count (0);
-	unsigned unconfirmed_announcements (0);
+	// Take the elections last announced at least an interval ago from the front of the announcement order and move them to the back.
+	// A pass takes at most 1/announce_slices of the active set so a full cycle is spread over the interval.
+	std::vector<std::shared_ptr<btcb::election>> slice;
+	auto roots_size (roots.size ());
+	auto slice_size ((roots_size + announce_slices - 1) / announce_slices);
+	auto now (std::chrono::steady_clock::now ());
+	auto cutoff (now - announce_interval ());
+	auto & sequenced (roots.get<2> ());
+	while (slice.size () < slice_size && sequenced.begin ()->announced <= cutoff)
+	{
+		auto i (sequenced.begin ());
+		slice.push_back (i->election);
+		sequenced.modify (i, [now](btcb::conflict_info & info_a) {
+			info_a.announced = now;
+		});
+		sequenced.relocate (sequenced.end (), i);
+	}
+	lock_a.unlock ();
+	std::vector<std::shared_ptr<btcb::election>> inactive;
+	std::vector<btcb::election_status> confirmed_l;
+	std::vector<std::shared_ptr<btcb::block>> escalated;
 	std::deque<std::shared_ptr<btcb::block>> rebroadcast_bundle;
 	std::deque<std::pair<std::shared_ptr<btcb::block>, std::shared_ptr<std::vector<btcb::peer_information>>>> confirm_req_bundle;
-
-	auto roots_size (roots.size ());
-	for (auto i (roots.get<1> ().begin ()), n (roots.get<1> ().end ()); i != n; ++i)
+	// One peer snapshot for the whole slice, the representative list is sorted by weight when the snapshot is built
+	auto peers_l (node.peers.snapshot ());
 	{
-		lock_a.unlock ();
-		auto election_l (i->election);
-		if ((election_l->confirmed || election_l->stopped) && i->election->announcements >= announcement_min - 1)
+		auto transaction (node.store.tx_begin_read ());
+		for (auto & election_l : slice)
 		{
-			if (election_l->confirmed)
+			auto election_lock (lock_election (election_l->root));
+			if ((election_l->confirmed || election_l->stopped) && election_l->announcements >= announcement_min - 1)
 			{
-				confirmed.push_back (i->election->status);
-				if (confirmed.size () > election_history_size)
+				if (election_l->confirmed)
 				{
-					confirmed.pop_front ();
+					confirmed_l.push_back (election_l->status);
 				}
+				inactive.push_back (election_l);
 			}
-			inactive.insert (election_l->root);
-		}
-		else
-		{
-			if (i->election->announcements > announcement_long)
+			else
 			{
-				++unconfirmed_count;
-				unconfirmed_announcements += i->election->announcements;
-				// Log votes for very long unconfirmed elections
-				if (i->election->announcements % 50 == 1)
-				{
-					auto tally_l (election_l->tally (transaction));
-					election_l->log_votes (tally_l);
-				}
-				/* Escalation for long unconfirmed elections
-				Start new elections for previous block & source
-				if there are less than 100 active elections */
-				if (i->election->announcements % announcement_long == 1 && roots_size < 100 && btcb::btcb_network != btcb::btcb_networks::btcb_test_network)
+				if (election_l->announcements > announcement_long)
 				{
-					std::shared_ptr<btcb::block> previous;
-					auto previous_hash (election_l->status.winner->previous ());
-					if (!previous_hash.is_zero ())
+					++unconfirmed_count;
+					unconfirmed_announcements += election_l->announcements;
+					// Log votes for very long unconfirmed elections
+					if (election_l->announcements % 50 == 1)
 					{
-						previous = node.store.block_get (transaction, previous_hash);
-						if (previous != nullptr)
-						{
-							add (std::move (previous));
-						}
+						auto tally_l (election_l->tally (transaction));
+						election_l->log_votes (tally_l);
 					}
-					/* If previous block not existing/not commited yet, block_source can cause segfault for state blocks
-					So source check can be done only if previous != nullptr or previous is 0 (open account) */
-					if (previous_hash.is_zero () || previous != nullptr)
+					/* Escalation for long unconfirmed elections
+					Start new elections for previous block & source
+					if there are less than 100 active elections */
+					if (election_l->announcements % announcement_long == 1 && roots_size < 100 && btcb::btcb_network != btcb::btcb_networks::btcb_test_network)
 					{
-						auto source_hash (node.ledger.block_source (transaction, *election_l->status.winner));
-						if (!source_hash.is_zero ())
+						std::shared_ptr<btcb::block> previous;
+						auto previous_hash (election_l->status.winner->previous ());
+						if (!previous_hash.is_zero ())
 						{
-							auto source (node.store.block_get (transaction, source_hash));
-							if (source != nullptr)
+							previous = node.store.block_get (transaction, previous_hash);
+							if (previous != nullptr)
 							{
-								add (std::move (source));
+								escalated.push_back (previous);
+							}
+						}
+						/* If previous block not existing/not commited yet, block_source can cause segfault for state blocks
+						So source check can be done only if previous != nullptr or previous is 0 (open account) */
+						if (previous_hash.is_zero () || previous != nullptr)
+						{
+							auto source_hash (node.ledger.block_source (transaction, *election_l->status.winner));
+							if (!source_hash.is_zero ())
+							{
+								auto source (node.store.block_get (transaction, source_hash));
+								if (source != nullptr)
+								{
+									escalated.push_back (source);
+								}
 							}
 						}
 					}
 				}
-			}
-			if (i->election->announcements < announcement_long || i->election->announcements % announcement_long == 1)
-			{
-				if (node.ledger.could_fit (transaction, *election_l->status.winner))
+				if (election_l->announcements < announcement_long || election_l->announcements % announcement_long == 1)
 				{
-					// Broadcast winner
-					if (rebroadcast_bundle.size () < max_broadcast_queue)
+					if (node.ledger.could_fit (transaction, *election_l->status.winner))
 					{
-						rebroadcast_bundle.push_back (election_l->status.winner);
+						// Broadcast winner
+						if (rebroadcast_bundle.size () < max_broadcast_queue)
+						{
+							rebroadcast_bundle.push_back (election_l->status.winner);
+						}
 					}
-				}
-				else
-				{
-					if (i->election->announcements != 0)
+					else
 					{
-						election_l->stop ();
+						if (election_l->announcements != 0)
+						{
+							election_l->stop ();
+						}
 					}
 				}
-			}
-			if (i->election->announcements % 4 == 1)
-			{
-				auto reps (std::make_shared<std::vector<btcb::peer_information>> (node.peers.representatives (std::numeric_limits<size_t>::max ())));
-				std::unordered_set<btcb::account> probable_reps;
-				btcb::uint128_t total_weight (0);
-				for (auto j (reps->begin ()), m (reps->end ()); j != m;)
+				if (election_l->announcements % 4 == 1)
 				{
-					auto & rep_votes (i->election->last_votes);
-					auto rep_acct (j->probable_rep_account);
-					// Calculate if representative isn't recorded for several IP addresses
-					if (probable_reps.find (rep_acct) == probable_reps.end ())
-					{
-						total_weight = total_weight + j->rep_weight.number ();
-						probable_reps.insert (rep_acct);
-					}
-					if (rep_votes.find (rep_acct) != rep_votes.end ())
+					// Only copy the representatives which haven't voted on this election yet
+					auto reps (std::make_shared<std::vector<btcb::peer_information>> ());
+					auto & rep_votes (election_l->last_votes);
+					for (auto & rep : peers_l->representatives)
 					{
-						if (j + 1 == reps->end ())
+						if (rep_votes.find (rep.probable_rep_account) == rep_votes.end ())
 						{
-							reps->pop_back ();
-							break;
+							reps->push_back (rep);
+							if (node.config.logging.vote_logging ())
+							{
+								BOOST_LOG (node.log) << "Representative did not respond to confirm_req, retrying: " << rep.probable_rep_account.to_account ();
+							}
 						}
-
-						std::swap (*j, reps->back ());
-						reps->pop_back ();
-						m = reps->end ();
 					}
-					else
+					if ((!reps->empty () && peers_l->total_weight > node.config.online_weight_minimum.number ()) || roots_size > 5)
 					{
-						++j;
-						if (node.config.logging.vote_logging ())
+						if (confirm_req_bundle.size () < max_broadcast_queue)
 						{
-							BOOST_LOG (node.log) << "Representative did not respond to confirm_req, retrying: " << rep_acct.to_account ();
+							confirm_req_bundle.push_back (std::make_pair (election_l->status.winner, reps));
 						}
 					}
-				}
-				if ((!reps->empty () && total_weight > node.config.online_weight_minimum.number ()) || roots_size > 5)
-				{
-					if (confirm_req_bundle.size () < max_broadcast_queue)
+					else
 					{
-						confirm_req_bundle.push_back (std::make_pair (i->election->status.winner, reps));
+						// broadcast request to all peers
+						confirm_req_bundle.push_back (std::make_pair (election_l->status.winner, std::make_shared<std::vector<btcb::peer_information>> (node.peers.list_vector (100))));
 					}
 				}
-				else
-				{
-					// broadcast request to all peers
-					confirm_req_bundle.push_back (std::make_pair (i->election->status.winner, std::make_shared<std::vector<btcb::peer_information>> (node.peers.list_vector (100))));
-				}
 			}
+			++election_l->announcements;
 		}
-		++election_l->announcements;
-		lock_a.lock ();
 	}
 	// Rebroadcast unconfirmed blocks
 	if (!rebroadcast_bundle.empty ())
@@ -3376,21 +3530,43 @@ void btcb::active_transactions::announce_votes (std::unique_lock<std::mutex> & l
 	{
 		node.network.broadcast_confirm_req_batch (confirm_req_bundle);
 	}
-	for (auto i (inactive.begin ()), n (inactive.end ()); i != n; ++i)
+	lock_a.lock ();
+	for (auto & status : confirmed_l)
 	{
-		auto root_it (roots.find (*i));
-		assert (root_it != roots.end ());
-		for (auto & block : root_it->election->blocks)
+		confirmed.push_back (status);
+		if (confirmed.size () > election_history_size)
 		{
-			auto erased (blocks.erase (block.first));
-			(void)erased;
-			assert (erased == 1);
+			confirmed.pop_front ();
 		}
-		roots.erase (*i);
 	}
-	if (unconfirmed_count > 0)
+	for (auto & election_l : inactive)
+	{
+		// The election may have been erased, and another one started for the same root, while mutex was released
+		auto root_it (roots.find (election_l->root));
+		if (root_it != roots.end () && root_it->election == election_l)
+		{
+			for (auto & block : root_it->election->blocks)
+			{
+				auto erased (blocks.erase (block.first));
+				(void)erased;
+				assert (erased == 1);
+			}
+			roots.erase (root_it);
+		}
+	}
+	for (auto & block : escalated)
+	{
+		add (std::move (block));
+	}
+	admit ();
+	if (++announce_pass % announce_slices == 0)
 	{
-		BOOST_LOG (node.log) << boost::str (boost::format ("%1% blocks have been unconfirmed averaging %2% announcements") % unconfirmed_count % (unconfirmed_announcements / unconfirmed_count));
+		if (unconfirmed_count > 0)
+		{
+			BOOST_LOG (node.log) << boost::str (boost::format ("%1% blocks have been unconfirmed averaging %2% announcements") % unconfirmed_count % (unconfirmed_announcements / unconfirmed_count));
+		}
+		unconfirmed_count = 0;
+		unconfirmed_announcements = 0;
 	}
 }
 
@@ -3406,11 +3582,16 @@ void btcb::active_transactions::announce_loop ()
 	while (!stopped)
 	{
 		announce_votes (lock);
-		unsigned extra_delay (std::min (roots.size (), max_broadcast_queue) * node.network.broadcast_interval_ms * 2);
-		condition.wait_for (lock, std::chrono::milliseconds (announce_interval_ms + extra_delay));
+		condition.wait_for (lock, std::chrono::duration_cast<std::chrono::microseconds> (announce_interval ()) / announce_slices);
 	}
 }
 
+std::chrono::milliseconds btcb::active_transactions::announce_interval () const
+{
+	unsigned extra_delay (std::min (roots.size (), max_broadcast_queue) * node.network.broadcast_interval_ms * 2);
+	return std::chrono::milliseconds (announce_interval_ms + extra_delay);
+}
+
 void btcb::active_transactions::stop ()
 {
 	std::unique_lock<std::mutex> lock (mutex);
@@ -3427,6 +3608,7 @@ void btcb::active_transactions::stop ()
 	}
 	lock.lock ();
 	roots.clear ();
+	backlog.clear ();
 }
 
 bool btcb::active_transactions::start (std::shared_ptr<btcb::block> block_a, std::function<void(std::shared_ptr<btcb::block>)> const & confirmation_action_a)
@@ -3441,43 +3623,82 @@ bool btcb::active_transactions::add (std::shared_ptr<btcb::block> block_a, std::
 	if (!stopped)
 	{
 		auto root (block_a->root ());
-		auto existing (roots.find (root));
-		if (existing == roots.end ())
+		if (roots.find (root) == roots.end ())
 		{
-			auto election (std::make_shared<btcb::election> (node, block_a, confirmation_action_a));
 			uint64_t difficulty (0);
-			auto error (btcb::work_validate (*block_a, &difficulty));
-			release_assert (!error);
-			roots.insert (btcb::conflict_info{ root, difficulty, election });
-			blocks.insert (std::make_pair (block_a->hash (), election));
+			auto work_error (btcb::work_validate (*block_a, &difficulty));
+			release_assert (!work_error);
+			if (roots.size () < node.config.active_elections_size)
+			{
+				insert (block_a, difficulty, confirmation_action_a);
+				error = false;
+			}
+			else if (backlog.find (root) == backlog.end ())
+			{
+				backlog.insert (btcb::backlog_info{ root, difficulty, backlog_balance (*block_a), std::chrono::steady_clock::now (), block_a, confirmation_action_a });
+				node.stats.inc (btcb::stat::type::active, btcb::stat::detail::backlogged);
+				if (backlog.size () > node.config.active_backlog_size)
+				{
+					// Drop the lowest priority block, which may be the one just queued
+					auto & index (backlog.get<1> ());
+					index.erase (std::prev (index.end ()));
+					node.stats.inc (btcb::stat::type::active, btcb::stat::detail::backlog_dropped);
+				}
+			}
 		}
-		error = existing != roots.end ();
 	}
 	return error;
 }
 
+void btcb::active_transactions::insert (std::shared_ptr<btcb::block> block_a, uint64_t difficulty_a, std::function<void(std::shared_ptr<btcb::block>)> const & confirmation_action_a)
+{
+	auto election (std::make_shared<btcb::election> (node, block_a, confirmation_action_a));
+	roots.insert (btcb::conflict_info{ block_a->root (), difficulty_a, election, std::chrono::steady_clock::time_point::min () });
+	blocks.insert (std::make_pair (block_a->hash (), election));
+}
+
+void btcb::active_transactions::admit ()
+{
+	auto & index (backlog.get<1> ());
+	while (!stopped && roots.size () < node.config.active_elections_size && !index.empty ())
+	{
+		auto i (index.begin ());
+		if (roots.find (i->root) == roots.end ())
+		{
+			insert (i->block, i->difficulty, i->confirmation_action);
+			node.stats.inc (btcb::stat::type::active, btcb::stat::detail::admitted);
+		}
+		index.erase (i);
+	}
+}
+
+size_t btcb::active_transactions::backlog_size ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	return backlog.size ();
+}
+
 // Validate a vote and apply it to the current election if one exists
-bool btcb::active_transactions::vote (std::shared_ptr<btcb::vote> vote_a, bool single_lock)
+bool btcb::active_transactions::vote (std::shared_ptr<btcb::vote> vote_a)
 {
-	std::shared_ptr<btcb::election> election;
-	bool replay (false);
-	bool processed (false);
+	// Find the elections first so mutex isn't held while the votes are tallied
+	std::vector<std::pair<std::shared_ptr<btcb::election>, btcb::block_hash>> elections;
 	{
-		std::unique_lock<std::mutex> lock;
-		if (!single_lock)
+		std::unique_lock<std::mutex> lock (mutex, std::try_to_lock);
+		if (!lock.owns_lock ())
 		{
-			lock = std::unique_lock<std::mutex> (mutex);
+			node.stats.inc (btcb::stat::type::active, btcb::stat::detail::lock_contended);
+			lock.lock ();
 		}
 		for (auto vote_block : vote_a->blocks)
 		{
-			btcb::election_vote_result result;
 			if (vote_block.which ())
 			{
 				auto block_hash (boost::get<btcb::block_hash> (vote_block));
 				auto existing (blocks.find (block_hash));
 				if (existing != blocks.end ())
 				{
-					result = existing->second->vote (vote_a->account, vote_a->sequence, block_hash);
+					elections.push_back (std::make_pair (existing->second, block_hash));
 				}
 			}
 			else
@@ -3486,13 +3707,20 @@ bool btcb::active_transactions::vote (std::shared_ptr<btcb::vote> vote_a, bool s
 				auto existing (roots.find (block->root ()));
 				if (existing != roots.end ())
 				{
-					result = existing->election->vote (vote_a->account, vote_a->sequence, block->hash ());
+					elections.push_back (std::make_pair (existing->election, block->hash ()));
 				}
 			}
-			replay = replay || result.replay;
-			processed = processed || result.processed;
 		}
 	}
+	bool replay (false);
+	bool processed (false);
+	for (auto & i : elections)
+	{
+		auto election_lock (lock_election (i.first->root));
+		auto result (i.first->vote (vote_a->account, vote_a->sequence, i.second));
+		replay = replay || result.replay;
+		processed = processed || result.processed;
+	}
 	if (processed)
 	{
 		node.network.republish_vote (vote_a);
@@ -3500,10 +3728,46 @@ bool btcb::active_transactions::vote (std::shared_ptr<btcb::vote> vote_a, bool s
 	return replay;
 }
 
+std::unique_lock<std::mutex> btcb::active_transactions::lock_election (btcb::block_hash const & root_a)
+{
+	std::unique_lock<std::mutex> result (election_mutexes[root_a.qwords[0] % election_shards], std::try_to_lock);
+	if (!result.owns_lock ())
+	{
+		node.stats.inc (btcb::stat::type::active, btcb::stat::detail::shard_contended);
+		result.lock ();
+	}
+	return result;
+}
+
+void btcb::active_transactions::confirm_back (std::vector<btcb::block_hash> const & hashes_a)
+{
+	for (auto & hash : hashes_a)
+	{
+		std::shared_ptr<btcb::election> election;
+		{
+			std::lock_guard<std::mutex> lock (mutex);
+			auto existing (blocks.find (hash));
+			if (existing != blocks.end ())
+			{
+				election = existing->second;
+			}
+		}
+		if (election != nullptr)
+		{
+			auto election_lock (lock_election (election->root));
+			if (!election->confirmed && !election->stopped && election->blocks.size () == 1)
+			{
+				election->confirm_once ();
+			}
+		}
+	}
+}
+
 bool btcb::active_transactions::active (btcb::block const & block_a)
 {
 	std::lock_guard<std::mutex> lock (mutex);
-	return roots.find (block_a.root ()) != roots.end ();
+	auto root (block_a.root ());
+	return roots.find (root) != roots.end () || backlog.find (root) != backlog.end ();
 }
 
 void btcb::active_transactions::update_difficulty (btcb::block const & block_a)
@@ -3519,6 +3783,19 @@ void btcb::active_transactions::update_difficulty (btcb::block const & block_a)
 			info_a.difficulty = difficulty;
 		});
 	}
+	else
+	{
+		auto backlogged (backlog.find (block_a.root ()));
+		if (backlogged != backlog.end () && backlogged->block->hash () == block_a.hash ())
+		{
+			uint64_t difficulty;
+			auto error (btcb::work_validate (block_a, &difficulty));
+			assert (!error);
+			backlog.modify (backlogged, [difficulty](btcb::backlog_info & info_a) {
+				info_a.difficulty = difficulty;
+			});
+		}
+	}
 }
 
 // List of active blocks in elections
@@ -3532,6 +3809,7 @@ std::deque<std::shared_ptr<btcb::block>> btcb::active_transactions::list_blocks
 	}
 	for (auto i (roots.begin ()), n (roots.end ()); i != n; ++i)
 	{
+		auto election_lock (lock_election (i->root));
 		result.push_back (i->election->status.winner);
 	}
 	return result;
@@ -3540,15 +3818,29 @@ std::deque<std::shared_ptr<btcb::block>> btcb::active_transactions::list_blocks
 void btcb::active_transactions::erase (btcb::block const & block_a)
 {
 	std::lock_guard<std::mutex> lock (mutex);
-	if (roots.find (block_a.root ()) != roots.end ())
+	// Removed first so the erased root isn't admitted again below
+	backlog.erase (block_a.root ());
+	auto existing (roots.find (block_a.root ()));
+	if (existing != roots.end ())
 	{
-		roots.erase (block_a.root ());
+		{
+			auto election_lock (lock_election (existing->root));
+			for (auto & block : existing->election->blocks)
+			{
+				blocks.erase (block.first);
+			}
+		}
+		roots.erase (existing);
 		BOOST_LOG (node.log) << boost::str (boost::format ("Election erased for block block %1% root %2%") % block_a.hash ().to_string () % block_a.root ().to_string ());
+		admit ();
 	}
 }
 
 btcb::active_transactions::active_transactions (btcb::node & node_a) :
 node (node_a),
+announce_pass (0),
+unconfirmed_count (0),
+unconfirmed_announcements (0),
 started (false),
 stopped (false),
 thread ([this]() {
@@ -3575,6 +3867,7 @@ bool btcb::active_transactions::publish (std::shared_ptr<btcb::block> block_a)
 	auto result (true);
 	if (existing != roots.end ())
 	{
+		auto election_lock (lock_election (existing->root));
 		result = existing->election->publish (block_a);
 		if (!result)
 		{
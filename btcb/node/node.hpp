@@ -2,11 +2,13 @@
 
 #include <btcb/lib/work.hpp>
 #include <btcb/node/bootstrap.hpp>
+#include <btcb/node/callback.hpp>
 #include <btcb/node/logging.hpp>
 #include <btcb/node/nodeconfig.hpp>
 #include <btcb/node/peers.hpp>
 #include <btcb/node/portmapping.hpp>
 #include <btcb/node/stats.hpp>
+#include <btcb/node/unchecked.hpp>
 #include <btcb/node/voting.hpp>
 #include <btcb/node/wallet.hpp>
 #include <btcb/secure/ledger.hpp>
@@ -14,10 +16,12 @@
 #include <condition_variable>
 
 #include <boost/iostreams/device/array.hpp>
+#include <boost/multi_index/composite_key.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/member.hpp>
 #include <boost/multi_index/ordered_index.hpp>
 #include <boost/multi_index/random_access_index.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
 #include <boost/multi_index_container.hpp>
 #include <boost/thread/thread.hpp>
 
@@ -47,11 +51,14 @@ public:
 	bool replay;
 	bool processed;
 };
+class active_transactions;
+// The state of an election is guarded by its shard lock, see active_transactions::lock_election
 class election : public std::enable_shared_from_this<btcb::election>
 {
+	friend class btcb::active_transactions;
 	std::function<void(std::shared_ptr<btcb::block>)> confirmation_action;
-	void confirm_once (btcb::transaction const &);
-	void confirm_back (btcb::transaction const &);
+	void confirm_once ();
+	void confirm_back ();
 
 public:
 	election (btcb::node &, std::shared_ptr<btcb::block>, std::function<void(std::shared_ptr<btcb::block>)> const &);
@@ -83,27 +90,57 @@ public:
 	btcb::block_hash root;
 	uint64_t difficulty;
 	std::shared_ptr<btcb::election> election;
+	// Last time the election was announced, elections are announced at most once per announce interval
+	std::chrono::steady_clock::time_point announced;
+};
+// A block waiting for a free election slot
+class backlog_info
+{
+public:
+	btcb::block_hash root;
+	uint64_t difficulty;
+	// Balance after the block for send and state blocks, zero for the other types
+	btcb::uint128_t balance;
+	std::chrono::steady_clock::time_point arrival;
+	std::shared_ptr<btcb::block> block;
+	std::function<void(std::shared_ptr<btcb::block>)> confirmation_action;
 };
 // Core class for determining consensus
 // Holds all active blocks i.e. recently added blocks that need confirmation
+// At most node_config::active_elections_size elections run at once, further blocks wait in a backlog ordered by
+// difficulty, then balance, then age, and are admitted as elections finish.
+// mutex guards the containers, the state of each election is guarded by the lock of the shard its root falls in.
+// When both are needed mutex is taken first.
 class active_transactions
 {
 public:
 	active_transactions (btcb::node &);
 	~active_transactions ();
-	// Start an election for a block
+	// Start an election for a block, or queue it in the backlog if the active set is full
+	// Returns false if an election was started, true if one already existed or the block was queued
 	// Call action with confirmed block, may be different than what we started with
 	bool start (std::shared_ptr<btcb::block>, std::function<void(std::shared_ptr<btcb::block>)> const & = [](std::shared_ptr<btcb::block>) {});
 	// If this returns true, the vote is a replay
 	// If this returns false, the vote may or may not be a replay
-	bool vote (std::shared_ptr<btcb::vote>, bool = false);
-	// Is the root of this block in the roots container
+	// mutex is only held to find the elections, votes are applied under their shard locks so they can be applied from several threads
+	bool vote (std::shared_ptr<btcb::vote>);
+	// Lock guarding the state of elections with roots in the same shard as root_a
+	std::unique_lock<std::mutex> lock_election (btcb::block_hash const & root_a);
+	// Confirm the elections for the dependencies of a confirmed block if they have a single candidate
+	void confirm_back (std::vector<btcb::block_hash> const &);
+	// Is the root of this block in the roots container or the backlog
 	bool active (btcb::block const &);
 	void update_difficulty (btcb::block const &);
 	std::deque<std::shared_ptr<btcb::block>> list_blocks (bool = false);
 	void erase (btcb::block const &);
 	void stop ();
 	bool publish (std::shared_ptr<btcb::block> block_a);
+	// Blocks waiting for an election slot
+	size_t backlog_size ();
+	// Announce interval including the time to broadcast the active set, requires mutex
+	std::chrono::milliseconds announce_interval () const;
+	// Indexed by root, by difficulty, and in announcement order. Each announcement slice takes the elections which are due
+	// from the front of the sequenced index and moves them to the back.
 	boost::multi_index_container<
 	btcb::conflict_info,
 	boost::multi_index::indexed_by<
@@ -111,8 +148,26 @@ public:
 	boost::multi_index::member<btcb::conflict_info, btcb::block_hash, &btcb::conflict_info::root>>,
 	boost::multi_index::ordered_non_unique<
 	boost::multi_index::member<btcb::conflict_info, uint64_t, &btcb::conflict_info::difficulty>,
-	std::greater<uint64_t>>>>
+	std::greater<uint64_t>>,
+	boost::multi_index::sequenced<>>>
 	roots;
+	// Indexed by root and by admission priority, highest first
+	boost::multi_index_container<
+	btcb::backlog_info,
+	boost::multi_index::indexed_by<
+	boost::multi_index::hashed_unique<
+	boost::multi_index::member<btcb::backlog_info, btcb::block_hash, &btcb::backlog_info::root>>,
+	boost::multi_index::ordered_non_unique<
+	boost::multi_index::composite_key<
+	btcb::backlog_info,
+	boost::multi_index::member<btcb::backlog_info, uint64_t, &btcb::backlog_info::difficulty>,
+	boost::multi_index::member<btcb::backlog_info, btcb::uint128_t, &btcb::backlog_info::balance>,
+	boost::multi_index::member<btcb::backlog_info, std::chrono::steady_clock::time_point, &btcb::backlog_info::arrival>>,
+	boost::multi_index::composite_key_compare<
+	std::greater<uint64_t>,
+	std::greater<btcb::uint128_t>,
+	std::less<std::chrono::steady_clock::time_point>>>>>
+	backlog;
 	std::unordered_map<btcb::block_hash, std::shared_ptr<btcb::election>> blocks;
 	std::deque<btcb::election_status> confirmed;
 	btcb::node & node;
@@ -126,12 +181,24 @@ public:
 	static unsigned constexpr announce_interval_ms = (btcb::btcb_network == btcb::btcb_networks::btcb_test_network) ? 10 : 16000;
 	static size_t constexpr election_history_size = 2048;
 	static size_t constexpr max_broadcast_queue = 1000;
+	static size_t constexpr election_shards = 64;
+	// Every election is announced once per interval, the announcements are spread over this many passes
+	static unsigned constexpr announce_slices = 16;
 
 private:
 	// Call action with confirmed block, may be different than what we started with
 	bool add (std::shared_ptr<btcb::block>, std::function<void(std::shared_ptr<btcb::block>)> const & = [](std::shared_ptr<btcb::block>) {});
+	void insert (std::shared_ptr<btcb::block>, uint64_t, std::function<void(std::shared_ptr<btcb::block>)> const &);
+	// Starts elections from the backlog while there are free slots
+	void admit ();
 	void announce_loop ();
+	// Announces the next slice of elections, mutex is only held to pick the slice and to update the containers afterwards
 	void announce_votes (std::unique_lock<std::mutex> &);
+	std::array<std::mutex, election_shards> election_mutexes;
+	// Passes since start, elections unconfirmed for a long time are logged once every announce_slices passes
+	unsigned announce_pass;
+	unsigned unconfirmed_count;
+	uint64_t unconfirmed_announcements;
 	std::condition_variable condition;
 	bool started;
 	bool stopped;
@@ -297,6 +364,8 @@ public:
 	void start ();
 	void stop ();
 	void receive_action (btcb::udp_data *);
+	/** Returns true if \p data_a is a publish or confirm_ack that was recently received, these are dropped without parsing */
+	bool duplicate (btcb::udp_data const * data_a);
 	void rpc_action (boost::system::error_code const &, size_t);
 	void republish_vote (std::shared_ptr<btcb::vote>);
 	void republish_block (std::shared_ptr<btcb::block>);
@@ -317,6 +386,7 @@ public:
 	boost::asio::ip::udp::socket socket;
 	std::mutex socket_mutex;
 	boost::asio::ip::udp::resolver resolver;
+	btcb::network_filter filter;
 	std::vector<boost::thread> packet_processing_threads;
 	btcb::node & node;
 	bool on;
@@ -347,13 +417,16 @@ class vote_processor
 public:
 	vote_processor (btcb::node &);
 	void vote (std::shared_ptr<btcb::vote>, btcb::endpoint);
-	// node.active.mutex lock required
 	btcb::vote_code vote_blocking (btcb::transaction const &, std::shared_ptr<btcb::vote>, btcb::endpoint, bool = false);
 	void verify_votes (std::deque<std::pair<std::shared_ptr<btcb::vote>, btcb::endpoint>> &);
 	void flush ();
 	void calculate_weights ();
 	btcb::node & node;
 	void stop ();
+	// Votes with a valid signature, copies of them are dropped on arrival
+	btcb::verified_vote_cache verified;
+	// Most votes a worker takes from the queue at once, verified together in one batch
+	static size_t constexpr max_batch = 4096;
 
 private:
 	void process_loop ();
@@ -364,10 +437,11 @@ private:
 	std::unordered_set<btcb::account> representatives_3;
 	std::condition_variable condition;
 	std::mutex mutex;
-	bool started;
+	unsigned started;
 	bool stopped;
-	bool active;
-	boost::thread thread;
+	// Workers busy with a batch taken from the queue
+	unsigned active;
+	std::vector<boost::thread> threads;
 };
 // The network is crawled for representatives by occasionally sending a unicast confirm_req for a specific block and watching to see if it's acknowledged with a vote.
 class rep_crawler
@@ -391,27 +465,38 @@ public:
 	int * verifications;
 	std::promise<void> * promise;
 };
+// Verifies signature check sets on a pool of threads
+// Large sets are split into chunks of batch_size which are verified in parallel, the caller's promise is set once every chunk has finished
 class signature_checker
 {
 public:
-	signature_checker ();
+	signature_checker (unsigned = 1);
 	~signature_checker ();
 	void add (signature_check_set &);
 	void stop ();
 	void flush ();
+	static size_t constexpr batch_size = 256;
 
 private:
+	class chunk
+	{
+	public:
+		btcb::signature_check_set check;
+		std::shared_ptr<std::atomic<size_t>> pending;
+	};
 	void run ();
-	void verify (btcb::signature_check_set & check_a);
-	std::deque<btcb::signature_check_set> checks;
-	bool started;
+	void verify (btcb::signature_checker::chunk &);
+	std::deque<btcb::signature_checker::chunk> checks;
+	unsigned started;
+	unsigned active;
 	bool stopped;
 	std::mutex mutex;
 	std::condition_variable condition;
-	std::thread thread;
+	std::vector<std::thread> threads;
 };
 // Processing blocks is a potentially long IO operation
 // This class isolates block insertion from other operations like servicing network operations
+// Insertion is pipelined: verify_blocks checks state block signatures for the next batch while process_blocks commits the current batch to the ledger
 class block_processor
 {
 public:
@@ -421,18 +506,30 @@ public:
 	void flush ();
 	bool full ();
 	void add (std::shared_ptr<btcb::block>, std::chrono::steady_clock::time_point);
+	/** Queues several blocks taking the lock once */
+	void add (std::vector<std::shared_ptr<btcb::block>> const &, std::chrono::steady_clock::time_point);
 	void force (std::shared_ptr<btcb::block>);
 	bool should_log (bool);
 	bool have_blocks ();
 	void process_blocks ();
+	void verify_blocks ();
 	btcb::process_return process_receive_one (btcb::transaction const &, std::shared_ptr<btcb::block>, std::chrono::steady_clock::time_point = std::chrono::steady_clock::now (), bool = false);
+	// Number of state blocks verified in one pass of the verification stage
+	static size_t constexpr verification_batch_size = 2048;
+	// Verification stalls once this many blocks are waiting to be written
+	static size_t constexpr verified_max = 2 * verification_batch_size;
 
 private:
+	// Checks the work without holding mutex, invalid work is logged
+	bool work_valid (btcb::block const &);
+	// Appends to the state or the other queue, requires mutex
+	void queue (std::shared_ptr<btcb::block>, std::chrono::steady_clock::time_point);
 	void queue_unchecked (btcb::transaction const &, btcb::block_hash const &);
 	void verify_state_blocks (std::unique_lock<std::mutex> &, size_t = std::numeric_limits<size_t>::max ());
 	void process_receive_many (std::unique_lock<std::mutex> &);
 	bool stopped;
 	bool active;
+	bool verifying;
 	std::chrono::steady_clock::time_point next_log;
 	std::deque<std::pair<std::shared_ptr<btcb::block>, std::chrono::steady_clock::time_point>> state_blocks;
 	std::deque<std::pair<std::shared_ptr<btcb::block>, std::chrono::steady_clock::time_point>> blocks;
@@ -474,16 +571,20 @@ public:
 	btcb::account representative (btcb::account const &);
 	void ongoing_keepalive ();
 	void ongoing_syn_cookie_cleanup ();
+	void ongoing_network_filter_rotation ();
+	void ongoing_unchecked_cleanup ();
 	void ongoing_rep_crawl ();
 	void ongoing_rep_calculation ();
 	void ongoing_bootstrap ();
 	void ongoing_store_flush ();
+	/** Adds sidebands to blocks stored by an earlier version, a batch at a time until every block has one */
+	void ongoing_sideband_upgrade ();
 	void backup_wallet ();
 	void search_pending ();
 	int price (btcb::uint128_t const &, int);
 	void work_generate_blocking (btcb::block &, uint64_t = btcb::work_pool::publish_threshold);
-	uint64_t work_generate_blocking (btcb::uint256_union const &, uint64_t = btcb::work_pool::publish_threshold);
-	void work_generate (btcb::uint256_union const &, std::function<void(uint64_t)>, uint64_t = btcb::work_pool::publish_threshold);
+	uint64_t work_generate_blocking (btcb::uint256_union const &, uint64_t = btcb::work_pool::publish_threshold, btcb::work_priority = btcb::work_priority::interactive);
+	void work_generate (btcb::uint256_union const &, std::function<void(uint64_t)>, uint64_t = btcb::work_pool::publish_threshold, btcb::work_priority = btcb::work_priority::interactive);
 	void add_initial_peers ();
 	void block_confirm (std::shared_ptr<btcb::block>);
 	void process_fork (btcb::transaction const &, std::shared_ptr<btcb::block>);
@@ -498,6 +599,7 @@ public:
 	std::unique_ptr<btcb::block_store> store_impl;
 	btcb::block_store & store;
 	btcb::gap_cache gap_cache;
+	btcb::unchecked_cache unchecked;
 	btcb::ledger ledger;
 	btcb::active_transactions active;
 	btcb::network network;
@@ -514,18 +616,22 @@ public:
 	unsigned warmed_up;
 	btcb::block_processor block_processor;
 	boost::thread block_processor_thread;
+	boost::thread block_verification_thread;
 	btcb::block_arrival block_arrival;
 	btcb::online_reps online_reps;
 	btcb::stat stats;
+	btcb::http_callback http_callbacks;
 	btcb::keypair node_id;
 	btcb::block_uniquer block_uniquer;
 	btcb::vote_uniquer vote_uniquer;
+	btcb::local_vote_cache local_votes;
 	static double constexpr price_max = 16.0;
 	static double constexpr free_cutoff = 1024.0;
 	static std::chrono::seconds constexpr period = std::chrono::seconds (60);
 	static std::chrono::seconds constexpr cutoff = period * 5;
 	static std::chrono::seconds constexpr syn_cookie_cutoff = std::chrono::seconds (5);
 	static std::chrono::minutes constexpr backup_interval = std::chrono::minutes (5);
+	static size_t constexpr sideband_upgrade_batch = 4096;
 	static std::chrono::seconds constexpr search_pending_interval = (btcb::btcb_network == btcb::btcb_networks::btcb_test_network) ? std::chrono::seconds (1) : std::chrono::seconds (5 * 60);
 };
 class thread_runner
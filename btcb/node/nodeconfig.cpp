@@ -20,10 +20,20 @@ password_fanout (1024),
 io_threads (std::max<unsigned> (4, boost::thread::hardware_concurrency ())),
 network_threads (std::max<unsigned> (4, boost::thread::hardware_concurrency ())),
 work_threads (std::max<unsigned> (4, boost::thread::hardware_concurrency ())),
+signature_checker_threads (std::max<unsigned> (1, boost::thread::hardware_concurrency () / 2)),
+vote_processor_threads (std::max<unsigned> (1, boost::thread::hardware_concurrency () / 2)),
 enable_voting (true),
 bootstrap_connections (4),
 bootstrap_connections_max (64),
 callback_port (0),
+callback_connections (4),
+callback_batch_max (1),
+network_filter_size (256 * 1024),
+network_filter_expiry (std::chrono::seconds (5)),
+unchecked_cache_mb (64),
+unchecked_cache_cutoff (std::chrono::hours (4)),
+active_elections_size (8000),
+active_backlog_size (64 * 1024),
 lmdb_max_dbs (128),
 allow_local_peers (false),
 block_processor_batch_max_time (std::chrono::milliseconds (5000))
@@ -110,12 +120,22 @@ void btcb::node_config::serialize_json (boost::property_tree::ptree & tree_a) co
 	tree_a.put ("io_threads", std::to_string (io_threads));
 	tree_a.put ("network_threads", std::to_string (network_threads));
 	tree_a.put ("work_threads", std::to_string (work_threads));
+	tree_a.put ("signature_checker_threads", std::to_string (signature_checker_threads));
+	tree_a.put ("vote_processor_threads", std::to_string (vote_processor_threads));
 	tree_a.put ("enable_voting", enable_voting);
 	tree_a.put ("bootstrap_connections", bootstrap_connections);
 	tree_a.put ("bootstrap_connections_max", bootstrap_connections_max);
 	tree_a.put ("callback_address", callback_address);
 	tree_a.put ("callback_port", std::to_string (callback_port));
 	tree_a.put ("callback_target", callback_target);
+	tree_a.put ("callback_connections", callback_connections);
+	tree_a.put ("callback_batch_max", callback_batch_max);
+	tree_a.put ("network_filter_size", network_filter_size);
+	tree_a.put ("network_filter_expiry", network_filter_expiry.count ());
+	tree_a.put ("unchecked_cache_mb", unchecked_cache_mb);
+	tree_a.put ("unchecked_cache_cutoff", unchecked_cache_cutoff.count ());
+	tree_a.put ("active_elections_size", active_elections_size);
+	tree_a.put ("active_backlog_size", active_backlog_size);
 	tree_a.put ("lmdb_max_dbs", lmdb_max_dbs);
 	tree_a.put ("block_processor_batch_max_time", block_processor_batch_max_time.count ());
 	tree_a.put ("allow_local_peers", allow_local_peers);
@@ -209,6 +229,28 @@ bool btcb::node_config::upgrade_json (unsigned version_a, boost::property_tree::
 			tree_a.put ("allow_local_peers", allow_local_peers);
 			result = true;
 		case 16:
+			tree_a.put ("signature_checker_threads", std::to_string (signature_checker_threads));
+			result = true;
+		case 17:
+			tree_a.put ("callback_connections", callback_connections);
+			tree_a.put ("callback_batch_max", callback_batch_max);
+			result = true;
+		case 18:
+			tree_a.put ("network_filter_size", network_filter_size);
+			tree_a.put ("network_filter_expiry", network_filter_expiry.count ());
+			result = true;
+		case 19:
+			tree_a.put ("unchecked_cache_mb", unchecked_cache_mb);
+			tree_a.put ("unchecked_cache_cutoff", unchecked_cache_cutoff.count ());
+			result = true;
+		case 20:
+			tree_a.put ("vote_processor_threads", std::to_string (vote_processor_threads));
+			result = true;
+		case 21:
+			tree_a.put ("active_elections_size", active_elections_size);
+			tree_a.put ("active_backlog_size", active_backlog_size);
+			result = true;
+		case 22:
 			break;
 		default:
 			throw std::runtime_error ("Unknown node_config version");
@@ -304,6 +346,16 @@ bool btcb::node_config::deserialize_json (bool & upgraded_a, boost::property_tre
 			io_threads = std::stoul (io_threads_l);
 			network_threads = tree_a.get<unsigned> ("network_threads", network_threads);
 			work_threads = std::stoul (work_threads_l);
+			signature_checker_threads = tree_a.get<unsigned> ("signature_checker_threads", signature_checker_threads);
+			vote_processor_threads = tree_a.get<unsigned> ("vote_processor_threads", vote_processor_threads);
+			callback_connections = tree_a.get<unsigned> ("callback_connections", callback_connections);
+			callback_batch_max = tree_a.get<unsigned> ("callback_batch_max", callback_batch_max);
+			network_filter_size = tree_a.get<unsigned> ("network_filter_size", network_filter_size);
+			network_filter_expiry = std::chrono::seconds (tree_a.get<unsigned> ("network_filter_expiry", network_filter_expiry.count ()));
+			unchecked_cache_mb = tree_a.get<unsigned> ("unchecked_cache_mb", unchecked_cache_mb);
+			unchecked_cache_cutoff = std::chrono::seconds (tree_a.get<unsigned> ("unchecked_cache_cutoff", unchecked_cache_cutoff.count ()));
+			active_elections_size = tree_a.get<unsigned> ("active_elections_size", active_elections_size);
+			active_backlog_size = tree_a.get<unsigned> ("active_backlog_size", active_backlog_size);
 			bootstrap_connections = std::stoul (bootstrap_connections_l);
 			bootstrap_connections_max = std::stoul (bootstrap_connections_max_l);
 			lmdb_max_dbs = std::stoi (lmdb_max_dbs_l);
@@ -317,6 +369,13 @@ bool btcb::node_config::deserialize_json (bool & upgraded_a, boost::property_tre
 			result |= password_fanout < 16;
 			result |= password_fanout > 1024 * 1024;
 			result |= io_threads == 0;
+			result |= signature_checker_threads == 0;
+			result |= vote_processor_threads == 0;
+			result |= callback_connections == 0;
+			result |= callback_batch_max == 0;
+			result |= network_filter_expiry.count () == 0;
+			result |= unchecked_cache_cutoff.count () == 0;
+			result |= active_elections_size == 0;
 		}
 		catch (std::logic_error const &)
 		{
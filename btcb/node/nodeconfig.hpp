@@ -34,12 +34,29 @@ public:
 	unsigned io_threads;
 	unsigned network_threads;
 	unsigned work_threads;
+	unsigned signature_checker_threads;
+	/** Threads verifying votes and applying them to elections */
+	unsigned vote_processor_threads;
 	bool enable_voting;
 	unsigned bootstrap_connections;
 	unsigned bootstrap_connections_max;
 	std::string callback_address;
 	uint16_t callback_port;
 	std::string callback_target;
+	unsigned callback_connections;
+	unsigned callback_batch_max;
+	/** Slots in the filter for duplicate publish and confirm_ack datagrams, 0 disables it */
+	unsigned network_filter_size;
+	/** Datagrams are recognised as duplicates for between one and two times this period */
+	std::chrono::seconds network_filter_expiry;
+	/** Memory for blocks waiting on a dependency before the oldest spill to the unchecked table, 0 writes them all to the table */
+	unsigned unchecked_cache_mb;
+	/** Blocks waiting on a dependency in memory are dropped after this long */
+	std::chrono::seconds unchecked_cache_cutoff;
+	/** Elections running at once, further blocks wait in the election backlog */
+	unsigned active_elections_size;
+	/** Blocks waiting for an election, the lowest priority ones are dropped beyond this */
+	unsigned active_backlog_size;
 	int lmdb_max_dbs;
 	bool allow_local_peers;
 	btcb::stat_config stat_config;
@@ -49,7 +66,7 @@ public:
 	static std::chrono::seconds constexpr keepalive_period = std::chrono::seconds (60);
 	static std::chrono::seconds constexpr keepalive_cutoff = keepalive_period * 5;
 	static std::chrono::minutes constexpr wallet_backup_interval = std::chrono::minutes (5);
-	static constexpr int json_version = 16;
+	static constexpr int json_version = 22;
 };
 
 class node_flags
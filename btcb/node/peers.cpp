@@ -1,5 +1,22 @@
 #include <btcb/node/peers.hpp>
 
+#include <btcb/node/xorshift.hpp>
+
+namespace
+{
+// Peer sampling only spreads traffic around so a per-thread xorshift generator is used rather than contending on the crypto pool
+uint64_t sample_random ()
+{
+	static thread_local std::unique_ptr<btcb::xorshift1024star> rng;
+	if (rng == nullptr)
+	{
+		rng = std::make_unique<btcb::xorshift1024star> ();
+		btcb::random_pool.GenerateBlock (reinterpret_cast<uint8_t *> (rng->s.data ()), rng->s.size () * sizeof (decltype (rng->s)::value_type));
+	}
+	return rng->next ();
+}
+}
+
 btcb::endpoint btcb::map_endpoint_to_v6 (btcb::endpoint const & endpoint_a)
 {
 	auto endpoint_l (endpoint_a);
@@ -41,10 +58,41 @@ node_id ()
 btcb::peer_container::peer_container (btcb::endpoint const & self_a) :
 self (self_a),
 peer_observer ([](btcb::endpoint const &) {}),
-disconnect_observer ([]() {})
+disconnect_observer ([]() {}),
+snapshot_m (std::make_shared<btcb::peer_snapshot> ()),
+snapshot_stale (false)
 {
 }
 
+std::shared_ptr<btcb::peer_snapshot const> btcb::peer_container::snapshot ()
+{
+	if (snapshot_stale)
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		// Another reader may have rebuilt it while this one waited for the lock
+		if (snapshot_stale)
+		{
+			auto snapshot_l (std::make_shared<btcb::peer_snapshot> ());
+			snapshot_l->peers.assign (peers.get<1> ().begin (), peers.get<1> ().end ());
+			std::unordered_set<btcb::account> probable_reps;
+			btcb::uint128_t total_weight (0);
+			for (auto i (peers.get<6> ().begin ()), n (peers.get<6> ().end ()); i != n && !i->rep_weight.is_zero (); ++i)
+			{
+				snapshot_l->representatives.push_back (*i);
+				// Count representatives recorded for several IP addresses once
+				if (probable_reps.insert (i->probable_rep_account).second)
+				{
+					total_weight += i->rep_weight.number ();
+				}
+			}
+			snapshot_l->total_weight = total_weight;
+			std::atomic_store (&snapshot_m, std::shared_ptr<btcb::peer_snapshot const> (snapshot_l));
+			snapshot_stale = false;
+		}
+	}
+	return std::atomic_load (&snapshot_m);
+}
+
 bool btcb::peer_container::contacted (btcb::endpoint const & endpoint_a, unsigned version_a)
 {
 	auto endpoint_l (btcb::map_endpoint_to_v6 (endpoint_a));
@@ -109,17 +157,15 @@ std::map<btcb::endpoint, unsigned> btcb::peer_container::list_version ()
 
 std::vector<btcb::peer_information> btcb::peer_container::list_vector (size_t count_a)
 {
-	std::vector<peer_information> result;
-	std::lock_guard<std::mutex> lock (mutex);
-	for (auto i (peers.begin ()), j (peers.end ()); i != j; ++i)
-	{
-		result.push_back (*i);
-	}
-	std::random_shuffle (result.begin (), result.end ());
-	if (result.size () > count_a)
+	auto snapshot_l (snapshot ());
+	std::vector<peer_information> result (snapshot_l->peers);
+	// Only the first count_a positions need shuffling
+	auto count (std::min (count_a, result.size ()));
+	for (size_t i (0); i < count; ++i)
 	{
-		result.resize (count_a, btcb::peer_information (btcb::endpoint{}, 0));
+		std::swap (result[i], result[i + sample_random () % (result.size () - i)]);
 	}
+	result.resize (count, btcb::peer_information (btcb::endpoint{}, 0));
 	return result;
 }
 
@@ -196,22 +242,21 @@ std::unordered_set<btcb::endpoint> btcb::peer_container::random_set (size_t coun
 {
 	std::unordered_set<btcb::endpoint> result;
 	result.reserve (count_a);
-	std::lock_guard<std::mutex> lock (mutex);
+	auto snapshot_l (snapshot ());
+	auto & peers_l (snapshot_l->peers);
 	// Stop trying to fill result with random samples after this many attempts
 	auto random_cutoff (count_a * 2);
-	auto peers_size (peers.size ());
 	// Usually count_a will be much smaller than peers.size()
 	// Otherwise make sure we have a cutoff on attempting to randomly fill
-	if (!peers.empty ())
+	if (!peers_l.empty ())
 	{
-		for (auto i (0); i < random_cutoff && result.size () < count_a; ++i)
+		for (size_t i (0); i < random_cutoff && result.size () < count_a; ++i)
 		{
-			auto index (random_pool.GenerateWord32 (0, peers_size - 1));
-			result.insert (peers.get<3> ()[index].endpoint);
+			result.insert (peers_l[sample_random () % peers_l.size ()].endpoint);
 		}
 	}
 	// Fill the remainder with most recent contact
-	for (auto i (peers.get<1> ().begin ()), n (peers.get<1> ().end ()); i != n && result.size () < count_a; ++i)
+	for (auto i (peers_l.begin ()), n (peers_l.end ()); i != n && result.size () < count_a; ++i)
 	{
 		result.insert (i->endpoint);
 	}
@@ -237,16 +282,9 @@ void btcb::peer_container::random_fill (std::array<btcb::endpoint, 8> & target_a
 // Request a list of the top known representatives
 std::vector<btcb::peer_information> btcb::peer_container::representatives (size_t count_a)
 {
-	std::vector<peer_information> result;
-	result.reserve (std::min (count_a, size_t (16)));
-	std::lock_guard<std::mutex> lock (mutex);
-	for (auto i (peers.get<6> ().begin ()), n (peers.get<6> ().end ()); i != n && result.size () < count_a; ++i)
-	{
-		if (!i->rep_weight.is_zero ())
-		{
-			result.push_back (*i);
-		}
-	}
+	auto snapshot_l (snapshot ());
+	auto & representatives_l (snapshot_l->representatives);
+	std::vector<peer_information> result (representatives_l.begin (), representatives_l.begin () + std::min (count_a, representatives_l.size ()));
 	return result;
 }
 
@@ -294,6 +332,7 @@ std::vector<btcb::peer_information> btcb::peer_container::purge_list (std::chron
 		// Remove keepalive attempt tracking for attempts older than cutoff
 		auto attempts_pivot (attempts.get<1> ().lower_bound (cutoff));
 		attempts.get<1> ().erase (attempts.get<1> ().begin (), attempts_pivot);
+		snapshot_stale = true;
 	}
 	if (result.empty ())
 	{
@@ -319,8 +358,7 @@ std::vector<btcb::endpoint> btcb::peer_container::rep_crawl ()
 
 size_t btcb::peer_container::size ()
 {
-	std::lock_guard<std::mutex> lock (mutex);
-	return peers.size ();
+	return snapshot ()->peers.size ();
 }
 
 size_t btcb::peer_container::size_sqrt ()
@@ -333,17 +371,13 @@ std::vector<btcb::peer_information> btcb::peer_container::list_probable_rep_weig
 {
 	std::vector<btcb::peer_information> result;
 	std::unordered_set<btcb::account> probable_reps;
-	std::lock_guard<std::mutex> lock (mutex);
-	for (auto i (peers.get<6> ().begin ()), n (peers.get<6> ().end ()); i != n; ++i)
+	auto snapshot_l (snapshot ());
+	for (auto & i : snapshot_l->representatives)
 	{
 		// Calculate if representative isn't recorded for several IP addresses
-		if (probable_reps.find (i->probable_rep_account) == probable_reps.end ())
+		if (probable_reps.insert (i.probable_rep_account).second)
 		{
-			if (!i->rep_weight.number ().is_zero ())
-			{
-				result.push_back (*i);
-			}
-			probable_reps.insert (i->probable_rep_account);
+			result.push_back (i);
 		}
 	}
 	return result;
@@ -351,12 +385,7 @@ std::vector<btcb::peer_information> btcb::peer_container::list_probable_rep_weig
 
 btcb::uint128_t btcb::peer_container::total_weight ()
 {
-	btcb::uint128_t result (0);
-	for (auto & entry : list_probable_rep_weights ())
-	{
-		result = result + entry.rep_weight.number ();
-	}
-	return result;
+	return snapshot ()->total_weight;
 }
 
 bool btcb::peer_container::empty ()
@@ -399,6 +428,10 @@ bool btcb::peer_container::rep_response (btcb::endpoint const & endpoint_a, btcb
 				info.probable_rep_account = rep_account_a;
 			}
 		});
+		if (updated)
+		{
+			snapshot_stale = true;
+		}
 	}
 	return updated;
 }
@@ -464,6 +497,7 @@ bool btcb::peer_container::insert (btcb::endpoint const & endpoint_a, unsigned v
 				if (!result)
 				{
 					peers.insert (btcb::peer_information (endpoint_a, version_a));
+					snapshot_stale = true;
 				}
 			}
 		}
@@ -7,8 +7,10 @@
 #include <boost/multi_index/random_access_index.hpp>
 #include <boost/multi_index_container.hpp>
 #include <boost/optional.hpp>
+#include <atomic>
 #include <chrono>
 #include <deque>
+#include <memory>
 #include <mutex>
 #include <btcb/lib/numbers.hpp>
 #include <btcb/node/common.hpp>
@@ -59,11 +61,28 @@ public:
 	boost::optional<btcb::account> node_id;
 };
 
+/** Immutable copy of the peer set which can be read without locking the container */
+class peer_snapshot
+{
+public:
+	/** Every peer, in order of last contact at the time the snapshot was taken */
+	std::vector<btcb::peer_information> peers;
+	/** Peers with a non-zero representative weight, heaviest first */
+	std::vector<btcb::peer_information> representatives;
+	/** Total weight of the distinct representative accounts */
+	btcb::uint128_t total_weight{ 0 };
+};
+
 /** Manages a set of disovered peers */
 class peer_container
 {
 public:
 	peer_container (btcb::endpoint const &);
+	/**
+	 * The current snapshot, rebuilt on first use after peers were added or removed or a representative weight changed.
+	 * Contact times in the snapshot aren't updated when a known peer is heard from again.
+	 */
+	std::shared_ptr<btcb::peer_snapshot const> snapshot ();
 	// We were contacted by endpoint, update peers
 	// Returns true if a Node ID handshake should begin
 	bool contacted (btcb::endpoint const &, unsigned);
@@ -136,5 +155,10 @@ public:
 	static size_t constexpr peers_per_crawl = 8;
 	// Maximum number of peers per IP
 	static size_t constexpr max_peers_per_ip = 10;
+
+private:
+	// Read and replaced with the std::atomic_load/atomic_store overloads, set stale with mutex held to have it rebuilt by the next reader
+	std::shared_ptr<btcb::peer_snapshot const> snapshot_m;
+	std::atomic<bool> snapshot_stale;
 };
 }
@@ -2,6 +2,7 @@
 #include <btcb/node/rpc.hpp>
 
 #include <btcb/lib/interface.h>
+#include <btcb/lib/jsonstream.hpp>
 #include <btcb/node/node.hpp>
 
 #ifdef BTCB_SECURE_RPC
@@ -53,7 +54,9 @@ port (btcb::rpc::rpc_port),
 enable_control (false),
 frontier_request_limit (16384),
 chain_request_limit (16384),
-max_json_depth (20)
+max_json_depth (20),
+max_requests_per_connection (1000),
+idle_timeout (std::chrono::seconds (30))
 {
 }
 
@@ -63,7 +66,9 @@ port (btcb::rpc::rpc_port),
 enable_control (enable_control_a),
 frontier_request_limit (16384),
 chain_request_limit (16384),
-max_json_depth (20)
+max_json_depth (20),
+max_requests_per_connection (1000),
+idle_timeout (std::chrono::seconds (30))
 {
 }
 
@@ -75,6 +80,8 @@ void btcb::rpc_config::serialize_json (boost::property_tree::ptree & tree_a) con
 	tree_a.put ("frontier_request_limit", frontier_request_limit);
 	tree_a.put ("chain_request_limit", chain_request_limit);
 	tree_a.put ("max_json_depth", max_json_depth);
+	tree_a.put ("max_requests_per_connection", max_requests_per_connection);
+	tree_a.put ("idle_timeout", idle_timeout.count ());
 }
 
 bool btcb::rpc_config::deserialize_json (boost::property_tree::ptree const & tree_a)
@@ -96,6 +103,8 @@ bool btcb::rpc_config::deserialize_json (boost::property_tree::ptree const & tre
 			auto frontier_request_limit_l (tree_a.get<std::string> ("frontier_request_limit"));
 			auto chain_request_limit_l (tree_a.get<std::string> ("chain_request_limit"));
 			max_json_depth = tree_a.get<uint8_t> ("max_json_depth", max_json_depth);
+			max_requests_per_connection = tree_a.get<uint64_t> ("max_requests_per_connection", max_requests_per_connection);
+			idle_timeout = std::chrono::seconds (tree_a.get<uint64_t> ("idle_timeout", idle_timeout.count ()));
 			try
 			{
 				port = std::stoul (port_l);
@@ -122,11 +131,160 @@ bool btcb::rpc_config::deserialize_json (boost::property_tree::ptree const & tre
 	return result;
 }
 
+namespace
+{
+using rpc_action = std::function<void(btcb::rpc_handler &)>;
+
+/** Every RPC action by name, built on first use and never modified afterwards */
+std::unordered_map<std::string, rpc_action> const & rpc_actions ()
+{
+	static std::unordered_map<std::string, rpc_action> const result{
+		{ "account_balance", &btcb::rpc_handler::account_balance },
+		{ "account_block_count", &btcb::rpc_handler::account_block_count },
+		{ "account_count", &btcb::rpc_handler::account_count },
+		{ "account_create", &btcb::rpc_handler::account_create },
+		{ "account_get", &btcb::rpc_handler::account_get },
+		{ "account_history", &btcb::rpc_handler::account_history },
+		{ "account_info", &btcb::rpc_handler::account_info },
+		{ "account_key", &btcb::rpc_handler::account_key },
+		{ "account_list", &btcb::rpc_handler::account_list },
+		{ "account_move", &btcb::rpc_handler::account_move },
+		{ "account_remove", &btcb::rpc_handler::account_remove },
+		{ "account_representative", &btcb::rpc_handler::account_representative },
+		{ "account_representative_set", &btcb::rpc_handler::account_representative_set },
+		{ "account_weight", &btcb::rpc_handler::account_weight },
+		{ "accounts_balances", &btcb::rpc_handler::accounts_balances },
+		{ "accounts_create", &btcb::rpc_handler::accounts_create },
+		{ "accounts_frontiers", &btcb::rpc_handler::accounts_frontiers },
+		{ "accounts_pending", &btcb::rpc_handler::accounts_pending },
+		{ "available_supply", &btcb::rpc_handler::available_supply },
+		{ "block", &btcb::rpc_handler::block },
+		{ "block_confirm", &btcb::rpc_handler::block_confirm },
+		{ "blocks", &btcb::rpc_handler::blocks },
+		{ "blocks_info", &btcb::rpc_handler::blocks_info },
+		{ "block_account", &btcb::rpc_handler::block_account },
+		{ "block_count", &btcb::rpc_handler::block_count },
+		{ "block_count_type", &btcb::rpc_handler::block_count_type },
+		{ "block_create", &btcb::rpc_handler::block_create },
+		{ "block_hash", &btcb::rpc_handler::block_hash },
+		{ "successors", [](btcb::rpc_handler & handler_a) { handler_a.chain (true); } },
+		{ "bootstrap", &btcb::rpc_handler::bootstrap },
+		{ "bootstrap_any", &btcb::rpc_handler::bootstrap_any },
+		{ "bootstrap_lazy", &btcb::rpc_handler::bootstrap_lazy },
+		{ "bootstrap_status", &btcb::rpc_handler::bootstrap_status },
+		{ "chain", [](btcb::rpc_handler & handler_a) { handler_a.chain (); } },
+		{ "delegators", &btcb::rpc_handler::delegators },
+		{ "delegators_count", &btcb::rpc_handler::delegators_count },
+		{ "deterministic_key", &btcb::rpc_handler::deterministic_key },
+		{ "confirmation_active", &btcb::rpc_handler::confirmation_active },
+		{ "confirmation_history", &btcb::rpc_handler::confirmation_history },
+		{ "confirmation_info", &btcb::rpc_handler::confirmation_info },
+		{ "confirmation_quorum", &btcb::rpc_handler::confirmation_quorum },
+		{ "frontiers", &btcb::rpc_handler::frontiers },
+		{ "frontier_count", [](btcb::rpc_handler & handler_a) { handler_a.account_count (); } },
+		{ "history", [](btcb::rpc_handler & handler_a) {
+			 handler_a.request.put ("head", handler_a.request.get<std::string> ("hash"));
+			 handler_a.account_history ();
+		 } },
+		{ "keepalive", &btcb::rpc_handler::keepalive },
+		{ "key_create", &btcb::rpc_handler::key_create },
+		{ "key_expand", &btcb::rpc_handler::key_expand },
+		{ "krai_from_raw", [](btcb::rpc_handler & handler_a) { handler_a.mrai_from_raw (btcb::kbcb_ratio); } },
+		{ "krai_to_raw", [](btcb::rpc_handler & handler_a) { handler_a.mrai_to_raw (btcb::kbcb_ratio); } },
+		{ "ledger", &btcb::rpc_handler::ledger },
+		{ "mrai_from_raw", [](btcb::rpc_handler & handler_a) { handler_a.mrai_from_raw (); } },
+		{ "mrai_to_raw", [](btcb::rpc_handler & handler_a) { handler_a.mrai_to_raw (); } },
+		{ "node_id", &btcb::rpc_handler::node_id },
+		{ "node_id_delete", &btcb::rpc_handler::node_id_delete },
+		{ "password_change", &btcb::rpc_handler::password_change },
+		{ "password_enter", &btcb::rpc_handler::password_enter },
+		{ "password_valid", [](btcb::rpc_handler & handler_a) { handler_a.password_valid (); } },
+		{ "payment_begin", &btcb::rpc_handler::payment_begin },
+		{ "payment_init", &btcb::rpc_handler::payment_init },
+		{ "payment_end", &btcb::rpc_handler::payment_end },
+		{ "payment_wait", &btcb::rpc_handler::payment_wait },
+		{ "peers", &btcb::rpc_handler::peers },
+		{ "pending", &btcb::rpc_handler::pending },
+		{ "pending_exists", &btcb::rpc_handler::pending_exists },
+		{ "process", &btcb::rpc_handler::process },
+		{ "btcb_from_raw", [](btcb::rpc_handler & handler_a) { handler_a.mrai_from_raw (btcb::bcb_ratio); } },
+		{ "btcb_to_raw", [](btcb::rpc_handler & handler_a) { handler_a.mrai_to_raw (btcb::bcb_ratio); } },
+		{ "receive", &btcb::rpc_handler::receive },
+		{ "receive_minimum", &btcb::rpc_handler::receive_minimum },
+		{ "receive_minimum_set", &btcb::rpc_handler::receive_minimum_set },
+		{ "representatives", &btcb::rpc_handler::representatives },
+		{ "representatives_online", &btcb::rpc_handler::representatives_online },
+		{ "republish", &btcb::rpc_handler::republish },
+		{ "search_pending", &btcb::rpc_handler::search_pending },
+		{ "search_pending_all", &btcb::rpc_handler::search_pending_all },
+		{ "send", &btcb::rpc_handler::send },
+		{ "stats", &btcb::rpc_handler::stats },
+		{ "stop", &btcb::rpc_handler::stop },
+		{ "unchecked", &btcb::rpc_handler::unchecked },
+		{ "unchecked_clear", &btcb::rpc_handler::unchecked_clear },
+		{ "unchecked_get", &btcb::rpc_handler::unchecked_get },
+		{ "unchecked_keys", &btcb::rpc_handler::unchecked_keys },
+		{ "unchecked_cache", &btcb::rpc_handler::unchecked_cache },
+		{ "validate_account_number", &btcb::rpc_handler::validate_account_number },
+		{ "version", &btcb::rpc_handler::version },
+		{ "wallet_add", &btcb::rpc_handler::wallet_add },
+		{ "wallet_add_watch", &btcb::rpc_handler::wallet_add_watch },
+		// Obsolete
+		{ "wallet_balance_total", [](btcb::rpc_handler & handler_a) { handler_a.wallet_info (); } },
+		{ "wallet_balances", &btcb::rpc_handler::wallet_balances },
+		{ "wallet_change_seed", &btcb::rpc_handler::wallet_change_seed },
+		{ "wallet_contains", &btcb::rpc_handler::wallet_contains },
+		{ "wallet_create", &btcb::rpc_handler::wallet_create },
+		{ "wallet_destroy", &btcb::rpc_handler::wallet_destroy },
+		{ "wallet_export", &btcb::rpc_handler::wallet_export },
+		{ "wallet_frontiers", &btcb::rpc_handler::wallet_frontiers },
+		{ "wallet_info", &btcb::rpc_handler::wallet_info },
+		{ "wallet_key_valid", &btcb::rpc_handler::wallet_key_valid },
+		{ "wallet_ledger", &btcb::rpc_handler::wallet_ledger },
+		{ "wallet_lock", &btcb::rpc_handler::wallet_lock },
+		{ "wallet_locked", [](btcb::rpc_handler & handler_a) { handler_a.password_valid (true); } },
+		{ "wallet_pending", &btcb::rpc_handler::wallet_pending },
+		{ "wallet_representative", &btcb::rpc_handler::wallet_representative },
+		{ "wallet_representative_set", &btcb::rpc_handler::wallet_representative_set },
+		{ "wallet_republish", &btcb::rpc_handler::wallet_republish },
+		{ "wallet_unlock", [](btcb::rpc_handler & handler_a) { handler_a.password_enter (); } },
+		{ "wallet_work_get", &btcb::rpc_handler::wallet_work_get },
+		{ "work_generate", &btcb::rpc_handler::work_generate },
+		{ "work_cancel", &btcb::rpc_handler::work_cancel },
+		{ "work_get", &btcb::rpc_handler::work_get },
+		{ "work_set", &btcb::rpc_handler::work_set },
+		{ "work_validate", &btcb::rpc_handler::work_validate },
+		{ "work_peer_add", &btcb::rpc_handler::work_peer_add },
+		{ "work_peers", &btcb::rpc_handler::work_peers },
+		{ "work_peers_clear", &btcb::rpc_handler::work_peers_clear },
+		{ "work_queue", &btcb::rpc_handler::work_queue }
+	};
+	return result;
+}
+
+/** Upper bounds in microseconds of the buckets in each action's latency histogram */
+std::vector<uint64_t> const & rpc_latency_bounds ()
+{
+	static std::vector<uint64_t> const result{ 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 5000000 };
+	return result;
+}
+}
+
 btcb::rpc::rpc (boost::asio::io_context & io_ctx_a, btcb::node & node_a, btcb::rpc_config const & config_a) :
 acceptor (io_ctx_a),
 config (config_a),
-node (node_a)
+node (node_a),
+handlers (std::make_shared<btcb::rpc_handler_pool> (node_a, *this))
+{
+	for (auto & i : rpc_actions ())
+	{
+		action_latency[i.first] = node_a.stats.histogram ("rpc_" + i.first, rpc_latency_bounds ());
+	}
+}
+
+btcb::rpc::~rpc ()
 {
+	stop ();
 }
 
 void btcb::rpc::start ()
@@ -161,6 +319,7 @@ void btcb::rpc::accept ()
 		}
 		if (!ec)
 		{
+			track (connection);
 			connection->parse_connection ();
 		}
 		else
@@ -173,17 +332,104 @@ void btcb::rpc::accept ()
 void btcb::rpc::stop ()
 {
 	acceptor.close ();
+	std::lock_guard<std::mutex> lock (connections_mutex);
+	for (auto & i : connections)
+	{
+		if (auto connection_l = i.lock ())
+		{
+			connection_l->stop ();
+		}
+	}
+	connections.clear ();
 }
 
-btcb::rpc_handler::rpc_handler (btcb::node & node_a, btcb::rpc & rpc_a, std::string const & body_a, std::string const & request_id_a, std::function<void(boost::property_tree::ptree const &)> const & response_a) :
+void btcb::rpc::track (std::shared_ptr<btcb::rpc_connection> connection_a)
+{
+	std::lock_guard<std::mutex> lock (connections_mutex);
+	connections.erase (std::remove_if (connections.begin (), connections.end (), [](std::weak_ptr<btcb::rpc_connection> const & connection_w) { return connection_w.expired (); }), connections.end ());
+	connections.push_back (connection_a);
+}
+
+btcb::rpc_handler::rpc_handler (btcb::node & node_a, btcb::rpc & rpc_a, std::string const & body_a, std::string const & request_id_a, std::function<void(boost::property_tree::ptree const &)> const & response_a, std::function<void(std::string)> const & response_body_a) :
 body (body_a),
 request_id (request_id_a),
 node (node_a),
 rpc (rpc_a),
-response (response_a)
+response (response_a),
+response_body (response_body_a)
+{
+}
+
+void btcb::rpc_handler::reset (std::string const & body_a, std::string const & request_id_a, std::function<void(boost::property_tree::ptree const &)> const & response_a, std::function<void(std::string)> const & response_body_a)
+{
+	body.assign (body_a);
+	request_id.assign (request_id_a);
+	response = response_a;
+	response_body = response_body_a;
+	request.clear ();
+	response_l.clear ();
+	ec = std::error_code ();
+}
+
+size_t constexpr btcb::rpc_handler_pool::max_idle;
+
+btcb::rpc_handler_pool::rpc_handler_pool (btcb::node & node_a, btcb::rpc & rpc_a) :
+node (node_a),
+rpc (rpc_a)
 {
 }
 
+std::shared_ptr<btcb::rpc_handler> btcb::rpc_handler_pool::get (std::string const & body_a, std::string const & request_id_a, std::function<void(boost::property_tree::ptree const &)> const & response_a, std::function<void(std::string)> const & response_body_a)
+{
+	std::unique_ptr<btcb::rpc_handler> handler;
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		if (!idle.empty ())
+		{
+			handler = std::move (idle.back ());
+			idle.pop_back ();
+		}
+	}
+	if (handler != nullptr)
+	{
+		handler->reset (body_a, request_id_a, response_a, response_body_a);
+	}
+	else
+	{
+		handler.reset (new btcb::rpc_handler (node, rpc, body_a, request_id_a, response_a, response_body_a));
+	}
+	// Handlers outliving the pool, such as payment_wait finishing after the RPC server was destroyed, are deleted instead
+	std::weak_ptr<btcb::rpc_handler_pool> pool_w (shared_from_this ());
+	return std::shared_ptr<btcb::rpc_handler> (handler.release (), [pool_w](btcb::rpc_handler * handler_a) {
+		if (auto pool_l = pool_w.lock ())
+		{
+			pool_l->release (handler_a);
+		}
+		else
+		{
+			delete handler_a;
+		}
+	});
+}
+
+void btcb::rpc_handler_pool::release (btcb::rpc_handler * handler_a)
+{
+	std::unique_ptr<btcb::rpc_handler> handler (handler_a);
+	// Drops whatever the response callback captured, usually the connection, so idle handlers don't keep it open
+	handler->reset ("", "", nullptr, nullptr);
+	std::lock_guard<std::mutex> lock (mutex);
+	if (idle.size () < max_idle)
+	{
+		idle.push_back (std::move (handler));
+	}
+}
+
+size_t btcb::rpc_handler_pool::size ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	return idle.size ();
+}
+
 void btcb::rpc::observer_action (btcb::account const & account_a)
 {
 	std::shared_ptr<btcb::payment_observer> observer;
@@ -994,7 +1240,7 @@ void btcb::rpc_handler::block_count ()
 {
 	auto transaction (node.store.tx_begin_read ());
 	response_l.put ("count", std::to_string (node.store.block_count (transaction).sum ()));
-	response_l.put ("unchecked", std::to_string (node.store.unchecked_count (transaction)));
+	response_l.put ("unchecked", std::to_string (node.unchecked.count (transaction)));
 	response_errors ();
 }
 
@@ -1425,20 +1671,30 @@ void btcb::rpc_handler::confirmation_active ()
 	{
 		announcements = strtoul (announcements_text.get ().c_str (), NULL, 10);
 	}
-	boost::property_tree::ptree elections;
+	std::vector<std::shared_ptr<btcb::election>> elections_l;
+	size_t backlog (0);
 	{
 		std::lock_guard<std::mutex> lock (node.active.mutex);
 		for (auto i (node.active.roots.begin ()), n (node.active.roots.end ()); i != n; ++i)
 		{
-			if (i->election->announcements >= announcements && !i->election->confirmed && !i->election->stopped)
-			{
-				boost::property_tree::ptree entry;
-				entry.put ("", i->root.to_string ());
-				elections.push_back (std::make_pair ("", entry));
-			}
+			elections_l.push_back (i->election);
+		}
+		backlog = node.active.backlog.size ();
+	}
+	boost::property_tree::ptree elections;
+	for (auto & election : elections_l)
+	{
+		// The state of each election is guarded by its shard lock rather than active.mutex
+		auto election_lock (node.active.lock_election (election->root));
+		if (election->announcements >= announcements && !election->confirmed && !election->stopped)
+		{
+			boost::property_tree::ptree entry;
+			entry.put ("", election->root.to_string ());
+			elections.push_back (std::make_pair ("", entry));
 		}
 	}
 	response_l.add_child ("confirmations", elections);
+	response_l.put ("backlog", std::to_string (backlog));
 	response_errors ();
 }
 
@@ -1478,12 +1734,20 @@ void btcb::rpc_handler::confirmation_info ()
 	btcb::block_hash root;
 	if (!root.decode_hex (root_text))
 	{
-		std::lock_guard<std::mutex> lock (node.active.mutex);
-		auto conflict_info (node.active.roots.find (root));
-		if (conflict_info != node.active.roots.end ())
+		std::shared_ptr<btcb::election> election;
+		{
+			std::lock_guard<std::mutex> lock (node.active.mutex);
+			auto conflict_info (node.active.roots.find (root));
+			if (conflict_info != node.active.roots.end ())
+			{
+				election = conflict_info->election;
+			}
+		}
+		if (election != nullptr)
 		{
-			response_l.put ("announcements", std::to_string (conflict_info->election->announcements));
-			auto election (conflict_info->election);
+			// Only the shard lock is held while the election is tallied so elections can still be started and found meanwhile
+			auto election_lock (node.active.lock_election (root));
+			response_l.put ("announcements", std::to_string (election->announcements));
 			btcb::uint128_t total (0);
 			response_l.put ("last_winner", election->status.winner->hash ().to_string ());
 			auto transaction (node.store.tx_begin_read ());
@@ -1563,25 +1827,48 @@ void btcb::rpc_handler::confirmation_quorum ()
 void btcb::rpc_handler::delegators ()
 {
 	auto account (account_impl ());
+	auto count (count_optional_impl ());
 	if (!ec)
 	{
-		boost::property_tree::ptree delegators;
-		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.latest_begin (transaction)), n (node.store.latest_end ()); i != n; ++i)
+		btcb::account start (0);
+		boost::optional<std::string> start_text (request.get_optional<std::string> ("start"));
+		if (start_text.is_initialized ())
 		{
-			btcb::account_info info (i->second);
-			auto block (node.store.block_get (transaction, info.rep_block));
-			assert (block != nullptr);
-			if (block->representative () == account)
+			if (start.decode_account (start_text.get ()))
 			{
+				ec = btcb::error_common::bad_account_number;
+			}
+		}
+		if (!ec)
+		{
+			std::string result;
+			btcb::json_stream json (result);
+			json.begin_object ();
+			json.key ("delegators");
+			json.begin_object ();
+			auto transaction (node.store.tx_begin_read ());
+			auto delegators (node.store.delegators_get (transaction, account, start, count));
+			std::string accounts (delegators.size () * btcb::account_text_size, '\0');
+			btcb::encode_accounts (delegators.data (), delegators.size (), &accounts[0]);
+			for (size_t i (0); i < delegators.size (); ++i)
+			{
+				btcb::account_info info;
+				auto error (node.store.account_get (transaction, delegators[i], info));
+				assert (!error);
 				std::string balance;
 				btcb::uint128_union (info.balance).encode_dec (balance);
-				delegators.put (btcb::account (i->first).to_account (), balance);
+				json.key (accounts.data () + i * btcb::account_text_size, btcb::account_text_size);
+				json.value (balance);
 			}
+			json.end_object ();
+			json.end_object ();
+			response_body (std::move (result));
 		}
-		response_l.add_child ("delegators", delegators);
 	}
-	response_errors ();
+	if (ec)
+	{
+		response_errors ();
+	}
 }
 
 void btcb::rpc_handler::delegators_count ()
@@ -1589,18 +1876,8 @@ void btcb::rpc_handler::delegators_count ()
 	auto account (account_impl ());
 	if (!ec)
 	{
-		uint64_t count (0);
 		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.latest_begin (transaction)), n (node.store.latest_end ()); i != n; ++i)
-		{
-			btcb::account_info info (i->second);
-			auto block (node.store.block_get (transaction, info.rep_block));
-			assert (block != nullptr);
-			if (block->representative () == account)
-			{
-				++count;
-			}
-		}
+		auto count (node.store.delegators_count (transaction, account));
 		response_l.put ("count", std::to_string (count));
 	}
 	response_errors ();
@@ -1641,15 +1918,25 @@ void btcb::rpc_handler::frontiers ()
 	auto count (count_impl ());
 	if (!ec)
 	{
-		boost::property_tree::ptree frontiers;
+		std::string result;
+		btcb::json_stream json (result);
+		json.begin_object ();
+		json.key ("frontiers");
+		json.begin_object ();
+		uint64_t written (0);
 		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.latest_begin (transaction, start)), n (node.store.latest_end ()); i != n && frontiers.size () < count; ++i)
+		for (auto i (node.store.latest_begin (transaction, start)), n (node.store.latest_end ()); i != n && written < count; ++i, ++written)
 		{
-			frontiers.put (btcb::account (i->first).to_account (), btcb::account_info (i->second).head.to_string ());
+			json.put (btcb::account (i->first).to_account (), btcb::account_info (i->second).head.to_string ());
 		}
-		response_l.add_child ("frontiers", frontiers);
+		json.end_object ();
+		json.end_object ();
+		response_body (std::move (result));
+	}
+	else
+	{
+		response_errors ();
 	}
-	response_errors ();
 }
 
 void btcb::rpc_handler::account_count ()
@@ -1804,6 +2091,7 @@ void btcb::rpc_handler::account_history ()
 {
 	btcb::account account;
 	bool output_raw (request.get_optional<bool> ("raw") == true);
+	bool reverse (request.get_optional<bool> ("reverse") == true);
 	btcb::block_hash hash;
 	auto head_str (request.get_optional<std::string> ("head"));
 	auto transaction (node.store.tx_begin_read ());
@@ -1840,8 +2128,24 @@ void btcb::rpc_handler::account_history ()
 		auto offset_text (request.get_optional<std::string> ("offset"));
 		if (!offset_text || !decode_unsigned (*offset_text, offset))
 		{
-			boost::property_tree::ptree history;
-			response_l.put ("account", account.to_account ());
+			if (!head_str && (offset > 0 || reverse))
+			{
+				// Seek straight to the requested position through the height index instead of walking the chain from its head
+				btcb::account_info info;
+				hash.clear ();
+				if (!node.store.account_get (transaction, account, info) && offset < info.block_count)
+				{
+					auto error (node.store.account_height_get (transaction, account, reverse ? 1 + offset : info.block_count - offset, hash));
+					assert (!error);
+				}
+				offset = 0;
+			}
+			std::string result;
+			btcb::json_stream json (result);
+			json.begin_object ();
+			json.put ("account", account.to_account ());
+			json.key ("history");
+			json.begin_array ();
 			auto block (node.store.block_get (transaction, hash));
 			while (block != nullptr && count > 0)
 			{
@@ -1862,25 +2166,30 @@ void btcb::rpc_handler::account_history ()
 							entry.put ("work", btcb::to_string_hex (block->block_work ()));
 							entry.put ("signature", block->block_signature ().to_string ());
 						}
-						history.push_back (std::make_pair ("", entry));
+						json.write (entry);
 						--count;
 					}
 				}
-				hash = block->previous ();
+				hash = reverse ? node.store.block_successor (transaction, hash) : block->previous ();
 				block = node.store.block_get (transaction, hash);
 			}
-			response_l.add_child ("history", history);
+			json.end_array ();
 			if (!hash.is_zero ())
 			{
-				response_l.put ("previous", hash.to_string ());
+				json.put (reverse ? "next" : "previous", hash.to_string ());
 			}
+			json.end_object ();
+			response_body (std::move (result));
 		}
 		else
 		{
 			ec = btcb::error_rpc::invalid_offset;
 		}
 	}
-	response_errors ();
+	if (ec)
+	{
+		response_errors ();
+	}
 }
 
 void btcb::rpc_handler::keepalive ()
@@ -1956,11 +2265,16 @@ void btcb::rpc_handler::ledger ()
 		const bool representative = request.get<bool> ("representative", false);
 		const bool weight = request.get<bool> ("weight", false);
 		const bool pending = request.get<bool> ("pending", false);
-		boost::property_tree::ptree accounts;
+		std::string result;
+		btcb::json_stream json (result);
+		json.begin_object ();
+		json.key ("accounts");
+		json.begin_object ();
+		uint64_t written (0);
 		auto transaction (node.store.tx_begin_read ());
 		if (!ec && !sorting) // Simple
 		{
-			for (auto i (node.store.latest_begin (transaction, start)), n (node.store.latest_end ()); i != n && accounts.size () < count; ++i)
+			for (auto i (node.store.latest_begin (transaction, start)), n (node.store.latest_end ()); i != n && written < count; ++i)
 			{
 				btcb::account_info info (i->second);
 				if (info.modified >= modified_since)
@@ -1991,7 +2305,9 @@ void btcb::rpc_handler::ledger ()
 						auto account_pending (node.ledger.account_pending (transaction, account));
 						response_a.put ("pending", account_pending.convert_to<std::string> ());
 					}
-					accounts.push_back (std::make_pair (account.to_account (), response_a));
+					json.key (account.to_account ());
+					json.write (response_a);
+					++written;
 				}
 			}
 		}
@@ -2010,7 +2326,7 @@ void btcb::rpc_handler::ledger ()
 			std::sort (ledger_l.begin (), ledger_l.end ());
 			std::reverse (ledger_l.begin (), ledger_l.end ());
 			btcb::account_info info;
-			for (auto i (ledger_l.begin ()), n (ledger_l.end ()); i != n && accounts.size () < count; ++i)
+			for (auto i (ledger_l.begin ()), n (ledger_l.end ()); i != n && written < count; ++i, ++written)
 			{
 				node.store.account_get (transaction, i->second, info);
 				btcb::account account (i->second);
@@ -2039,12 +2355,21 @@ void btcb::rpc_handler::ledger ()
 					auto account_pending (node.ledger.account_pending (transaction, account));
 					response_a.put ("pending", account_pending.convert_to<std::string> ());
 				}
-				accounts.push_back (std::make_pair (account.to_account (), response_a));
+				json.key (account.to_account ());
+				json.write (response_a);
 			}
 		}
-		response_l.add_child ("accounts", accounts);
+		json.end_object ();
+		json.end_object ();
+		if (!ec)
+		{
+			response_body (std::move (result));
+		}
+	}
+	if (ec)
+	{
+		response_errors ();
 	}
-	response_errors ();
 }
 
 void btcb::rpc_handler::mrai_from_raw (btcb::uint128_t ratio)
@@ -2935,6 +3260,10 @@ void btcb::rpc_handler::stats ()
 	{
 		node.stats.log_samples (*sink);
 	}
+	else if (type == "histograms")
+	{
+		node.stats.log_histograms (*sink);
+	}
 	else
 	{
 		ec = btcb::error_rpc::invalid_missing_type;
@@ -2969,18 +3298,42 @@ void btcb::rpc_handler::unchecked ()
 	auto count (count_optional_impl ());
 	if (!ec)
 	{
-		boost::property_tree::ptree unchecked;
+		std::string result;
+		btcb::json_stream json (result);
+		json.begin_object ();
+		json.key ("blocks");
+		json.begin_object ();
+		// A block waiting on both its previous and source block is listed once
+		std::unordered_set<btcb::block_hash> written;
+		for (auto & info : node.unchecked.list (0, count))
+		{
+			if (written.insert (info.hash).second)
+			{
+				std::string contents;
+				info.block->serialize_json (contents);
+				json.put (info.hash.to_string (), contents);
+			}
+		}
 		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.unchecked_begin (transaction)), n (node.store.unchecked_end ()); i != n && unchecked.size () < count; ++i)
+		for (auto i (node.store.unchecked_begin (transaction)), n (node.store.unchecked_end ()); i != n && written.size () < count; ++i)
 		{
 			auto block (i->second);
-			std::string contents;
-			block->serialize_json (contents);
-			unchecked.put (block->hash ().to_string (), contents);
+			auto hash (block->hash ());
+			if (written.insert (hash).second)
+			{
+				std::string contents;
+				block->serialize_json (contents);
+				json.put (hash.to_string (), contents);
+			}
 		}
-		response_l.add_child ("blocks", unchecked);
+		json.end_object ();
+		json.end_object ();
+		response_body (std::move (result));
+	}
+	else
+	{
+		response_errors ();
 	}
-	response_errors ();
 }
 
 void btcb::rpc_handler::unchecked_clear ()
@@ -2989,7 +3342,7 @@ void btcb::rpc_handler::unchecked_clear ()
 	if (!ec)
 	{
 		auto transaction (node.store.tx_begin_write ());
-		node.store.unchecked_clear (transaction);
+		node.unchecked.clear (transaction);
 		response_l.put ("success", "");
 	}
 	response_errors ();
@@ -3000,18 +3353,21 @@ void btcb::rpc_handler::unchecked_get ()
 	auto hash (hash_impl ());
 	if (!ec)
 	{
+		auto block (node.unchecked.block_get (hash));
 		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.unchecked_begin (transaction)), n (node.store.unchecked_end ()); i != n; ++i)
+		for (auto i (node.store.unchecked_begin (transaction)), n (node.store.unchecked_end ()); i != n && block == nullptr; ++i)
 		{
-			std::shared_ptr<btcb::block> block (i->second);
-			if (block->hash () == hash)
+			if (i->second->hash () == hash)
 			{
-				std::string contents;
-				block->serialize_json (contents);
-				response_l.put ("contents", contents);
-				break;
+				block = i->second;
 			}
 		}
+		if (block != nullptr)
+		{
+			std::string contents;
+			block->serialize_json (contents);
+			response_l.put ("contents", contents);
+		}
 		if (response_l.empty ())
 		{
 			ec = btcb::error_blocks::not_found;
@@ -3034,16 +3390,23 @@ void btcb::rpc_handler::unchecked_keys ()
 	}
 	if (!ec)
 	{
-		boost::property_tree::ptree unchecked;
+		// Merge blocks in memory with those in the unchecked table, both ordered by key
+		auto blocks (node.unchecked.list (key, count));
 		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.unchecked_begin (transaction, btcb::unchecked_key (key, 0))), n (node.store.unchecked_end ()); i != n && unchecked.size () < count; ++i)
+		size_t stored (0);
+		for (auto i (node.store.unchecked_begin (transaction, btcb::unchecked_key (key, 0))), n (node.store.unchecked_end ()); i != n && stored < count; ++i, ++stored)
+		{
+			blocks.push_back (btcb::unchecked_info{ i->first.key (), i->second->hash (), i->second, std::chrono::steady_clock::time_point () });
+		}
+		std::sort (blocks.begin (), blocks.end (), [](btcb::unchecked_info const & a, btcb::unchecked_info const & b) { return a.key () < b.key (); });
+		boost::property_tree::ptree unchecked;
+		for (auto i (blocks.begin ()), n (blocks.end ()); i != n && unchecked.size () < count; ++i)
 		{
 			boost::property_tree::ptree entry;
-			auto block (i->second);
 			std::string contents;
-			block->serialize_json (contents);
-			entry.put ("key", btcb::block_hash (i->first.key ()).to_string ());
-			entry.put ("hash", block->hash ().to_string ());
+			i->block->serialize_json (contents);
+			entry.put ("key", i->dependency.to_string ());
+			entry.put ("hash", i->hash.to_string ());
 			entry.put ("contents", contents);
 			unchecked.push_back (std::make_pair ("", entry));
 		}
@@ -3052,6 +3415,19 @@ void btcb::rpc_handler::unchecked_keys ()
 	response_errors ();
 }
 
+void btcb::rpc_handler::unchecked_cache ()
+{
+	auto transaction (node.store.tx_begin_read ());
+	auto size (node.unchecked.size ());
+	response_l.put ("blocks", std::to_string (size));
+	response_l.put ("blocks_max", std::to_string (node.unchecked.max_size ()));
+	response_l.put ("memory", std::to_string (size * btcb::unchecked_cache::entry_size));
+	response_l.put ("stored", std::to_string (node.store.unchecked_count (transaction)));
+	response_l.put ("oldest", std::to_string (std::chrono::duration_cast<std::chrono::seconds> (std::chrono::steady_clock::now () - node.unchecked.oldest ()).count ()));
+	response_l.put ("cutoff", std::to_string (node.config.unchecked_cache_cutoff.count ()));
+	response_errors ();
+}
+
 void btcb::rpc_handler::version ()
 {
 	response_l.put ("rpc_version", "1");
@@ -3342,7 +3718,11 @@ void btcb::rpc_handler::wallet_ledger ()
 	auto wallet (wallet_impl ());
 	if (!ec)
 	{
-		boost::property_tree::ptree accounts;
+		std::string result;
+		btcb::json_stream json (result);
+		json.begin_object ();
+		json.key ("accounts");
+		json.begin_object ();
 		auto transaction (node.store.tx_begin_read ());
 		for (auto i (wallet->store.begin (transaction)), n (wallet->store.end ()); i != n; ++i)
 		{
@@ -3377,13 +3757,19 @@ void btcb::rpc_handler::wallet_ledger ()
 						auto account_pending (node.ledger.account_pending (transaction, account));
 						entry.put ("pending", account_pending.convert_to<std::string> ());
 					}
-					accounts.push_back (std::make_pair (account.to_account (), entry));
+					json.key (account.to_account ());
+					json.write (entry);
 				}
 			}
 		}
-		response_l.add_child ("accounts", accounts);
+		json.end_object ();
+		json.end_object ();
+		response_body (std::move (result));
+	}
+	else
+	{
+		response_errors ();
 	}
-	response_errors ();
 }
 
 void btcb::rpc_handler::wallet_lock ()
@@ -3561,9 +3947,41 @@ void btcb::rpc_handler::work_generate ()
 {
 	rpc_control_impl ();
 	auto hash (hash_impl ());
+	bool use_peers (request.get_optional<bool> ("use_peers") == true);
+	auto priority (btcb::work_priority::interactive);
+	boost::optional<std::string> priority_text (request.get_optional<std::string> ("priority"));
+	if (!ec && priority_text.is_initialized ())
+	{
+		if (priority_text.get () == "precache")
+		{
+			priority = btcb::work_priority::precache;
+		}
+		else if (priority_text.get () != "interactive")
+		{
+			ec = btcb::error_rpc::bad_work_priority;
+		}
+	}
+	auto deadline (std::chrono::steady_clock::time_point::max ());
+	boost::optional<std::string> timeout_text (request.get_optional<std::string> ("timeout"));
+	if (!ec && timeout_text.is_initialized ())
+	{
+		// Distributed work keeps retrying until it has a result, so only local generation can time out
+		uint64_t timeout;
+		if (!use_peers && !decode_unsigned (timeout_text.get (), timeout))
+		{
+			auto now (std::chrono::steady_clock::now ());
+			if (timeout < static_cast<uint64_t> (std::chrono::duration_cast<std::chrono::milliseconds> (deadline - now).count ()))
+			{
+				deadline = now + std::chrono::milliseconds (timeout);
+			}
+		}
+		else
+		{
+			ec = btcb::error_rpc::bad_timeout;
+		}
+	}
 	if (!ec)
 	{
-		bool use_peers (request.get_optional<bool> ("use_peers") == true);
 		auto rpc_l (shared_from_this ());
 		auto callback = [rpc_l](boost::optional<uint64_t> const & work_a) {
 			if (work_a)
@@ -3579,11 +3997,11 @@ void btcb::rpc_handler::work_generate ()
 		};
 		if (!use_peers)
 		{
-			node.work.generate (hash, callback);
+			node.work.generate (hash, callback, btcb::work_pool::publish_threshold, priority, deadline);
 		}
 		else
 		{
-			node.work_generate (hash, callback);
+			node.work_generate (hash, callback, btcb::work_pool::publish_threshold, priority);
 		}
 	}
 	// Because of callback
@@ -3710,16 +4128,37 @@ void btcb::rpc_handler::work_peers_clear ()
 	response_errors ();
 }
 
+void btcb::rpc_handler::work_queue ()
+{
+	std::array<std::pair<char const *, btcb::work_priority>, btcb::work_priority_count> priorities{ { { "interactive", btcb::work_priority::interactive }, { "precache", btcb::work_priority::precache } } };
+	for (auto & priority : priorities)
+	{
+		boost::property_tree::ptree entry;
+		entry.put ("queued", std::to_string (node.work.size (priority.second)));
+		entry.put ("generated", std::to_string (node.work.generated[static_cast<size_t> (priority.second)].load ()));
+		entry.put ("average_time", std::to_string (node.work.average_time (priority.second)));
+		response_l.add_child (priority.first, entry);
+	}
+	response_errors ();
+}
+
 btcb::rpc_connection::rpc_connection (btcb::node & node_a, btcb::rpc & rpc_a) :
 node (node_a.shared ()),
 rpc (rpc_a),
-socket (node_a.io_ctx)
+socket (node_a.io_ctx),
+requests (0),
+max_requests (rpc_a.config.max_requests_per_connection),
+idle_timeout (rpc_a.config.idle_timeout),
+keep_alive (false),
+stopped (false),
+cutoff (std::numeric_limits<uint64_t>::max ())
 {
 	responded.clear ();
 }
 
 void btcb::rpc_connection::parse_connection ()
 {
+	checkup ();
 	read ();
 }
 
@@ -3727,13 +4166,14 @@ void btcb::rpc_connection::write_result (std::string body, unsigned version)
 {
 	if (!responded.test_and_set ())
 	{
+		res = boost::beast::http::response<boost::beast::http::string_body> ();
 		res.set ("Content-Type", "application/json");
 		res.set ("Access-Control-Allow-Origin", "*");
 		res.set ("Access-Control-Allow-Headers", "Accept, Accept-Language, Content-Language, Content-Type");
-		res.set ("Connection", "close");
 		res.result (boost::beast::http::status::ok);
-		res.body () = body;
+		res.body () = std::move (body);
 		res.version (version);
+		res.keep_alive (keep_alive);
 		res.prepare_payload ();
 	}
 	else
@@ -3746,41 +4186,124 @@ void btcb::rpc_connection::write_result (std::string body, unsigned version)
 void btcb::rpc_connection::read ()
 {
 	auto this_l (shared_from_this ());
+	request = boost::beast::http::request<boost::beast::http::string_body> ();
+	idle ();
 	boost::beast::http::async_read (socket, buffer, request, [this_l](boost::system::error_code const & ec, size_t bytes_transferred) {
-		if (!ec)
+		this_l->received (ec);
+	});
+}
+
+void btcb::rpc_connection::write ()
+{
+	auto this_l (shared_from_this ());
+	boost::beast::http::async_write (socket, res, [this_l](boost::system::error_code const & ec, size_t bytes_transferred) {
+		this_l->written (ec);
+	});
+}
+
+void btcb::rpc_connection::finish ()
+{
+	boost::system::error_code ignored;
+	socket.shutdown (boost::asio::ip::tcp::socket::shutdown_send, ignored);
+}
+
+void btcb::rpc_connection::close ()
+{
+	boost::system::error_code ignored;
+	socket.close (ignored);
+}
+
+void btcb::rpc_connection::stop ()
+{
+	stopped = true;
+	if (cutoff != std::numeric_limits<uint64_t>::max ())
+	{
+		close ();
+	}
+}
+
+void btcb::rpc_connection::idle ()
+{
+	cutoff = (std::chrono::steady_clock::now () + idle_timeout).time_since_epoch ().count ();
+}
+
+void btcb::rpc_connection::checkup ()
+{
+	std::weak_ptr<btcb::rpc_connection> this_w (shared_from_this ());
+	node->alarm.add (std::chrono::steady_clock::now () + std::max (idle_timeout, std::chrono::seconds (1)), [this_w]() {
+		if (auto this_l = this_w.lock ())
 		{
-			this_l->node->background ([this_l]() {
-				auto start (std::chrono::steady_clock::now ());
-				auto version (this_l->request.version ());
-				std::string request_id (boost::str (boost::format ("%1%") % boost::io::group (std::hex, std::showbase, reinterpret_cast<uintptr_t> (this_l.get ()))));
-				auto response_handler ([this_l, version, start, request_id](boost::property_tree::ptree const & tree_a) {
-					std::stringstream ostream;
-					boost::property_tree::write_json (ostream, tree_a);
-					ostream.flush ();
-					auto body (ostream.str ());
-					this_l->write_result (body, version);
-					boost::beast::http::async_write (this_l->socket, this_l->res, [this_l](boost::system::error_code const & ec, size_t bytes_transferred) {
-					});
-
-					if (this_l->node->config.logging.log_rpc ())
-					{
-						BOOST_LOG (this_l->node->log) << boost::str (boost::format ("RPC request %2% completed in: %1% microseconds") % std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - start).count () % request_id);
-					}
-				});
-				if (this_l->request.method () == boost::beast::http::verb::post)
-				{
-					auto handler (std::make_shared<btcb::rpc_handler> (*this_l->node, this_l->rpc, this_l->request.body (), request_id, response_handler));
-					handler->process_request ();
-				}
-				else
-				{
-					error_response (response_handler, "Can only POST requests");
-				}
-			});
+			if (this_l->cutoff != std::numeric_limits<uint64_t>::max () && this_l->cutoff < std::chrono::steady_clock::now ().time_since_epoch ().count ())
+			{
+				this_l->close ();
+			}
+			else
+			{
+				this_l->checkup ();
+			}
+		}
+	});
+}
+
+void btcb::rpc_connection::received (boost::system::error_code const & ec)
+{
+	cutoff = std::numeric_limits<uint64_t>::max ();
+	if (!ec)
+	{
+		++requests;
+		keep_alive = request.keep_alive () && !stopped && (max_requests == 0 || requests < max_requests);
+		process ();
+	}
+	else if (ec != boost::beast::http::error::end_of_stream && ec != boost::asio::error::operation_aborted)
+	{
+		BOOST_LOG (node->log) << "RPC read error: " << ec.message ();
+	}
+}
+
+void btcb::rpc_connection::written (boost::system::error_code const & ec)
+{
+	if (!ec && keep_alive && !stopped)
+	{
+		// Any pipelined requests are already in the buffer and are read without waiting on the socket
+		responded.clear ();
+		read ();
+	}
+	else
+	{
+		finish ();
+	}
+}
+
+void btcb::rpc_connection::process ()
+{
+	auto this_l (shared_from_this ());
+	node->background ([this_l]() {
+		auto start (std::chrono::steady_clock::now ());
+		auto version (this_l->request.version ());
+		std::string request_id (boost::str (boost::format ("%1%:%2%") % boost::io::group (std::hex, std::showbase, reinterpret_cast<uintptr_t> (this_l.get ())) % this_l->requests));
+		auto body_handler ([this_l, version, start, request_id](std::string body_a) {
+			this_l->write_result (std::move (body_a), version);
+			this_l->write ();
+
+			if (this_l->node->config.logging.log_rpc ())
+			{
+				BOOST_LOG (this_l->node->log) << boost::str (boost::format ("RPC request %2% completed in: %1% microseconds") % std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - start).count () % request_id);
+			}
+		});
+		auto response_handler ([body_handler](boost::property_tree::ptree const & tree_a) {
+			std::stringstream ostream;
+			boost::property_tree::write_json (ostream, tree_a);
+			ostream.flush ();
+			body_handler (ostream.str ());
+		});
+		if (this_l->request.method () == boost::beast::http::verb::post)
+		{
+			auto handler (this_l->rpc.handlers->get (this_l->request.body (), request_id, response_handler, body_handler));
+			handler->process_request ();
 		}
 		else
 		{
-			BOOST_LOG (this_l->node->log) << "RPC read error: " << ec.message ();
+			error_response (response_handler, "Can only POST requests");
 		}
 	});
 }
@@ -3822,492 +4345,90 @@ std::string filter_request (boost::property_tree::ptree tree_a)
 	}
 	return result;
 }
-}
 
-void btcb::rpc_handler::process_request ()
+/** Returns true if arrays and objects in \p body_a nest deeper than \p max_a, brackets within strings don't count */
+bool json_depth_exceeded (std::string const & body_a, size_t max_a)
 {
-	try
+	auto result (false);
+	size_t depth (0);
+	auto in_string (false);
+	for (auto i (body_a.begin ()), n (body_a.end ()); i != n && !result; ++i)
 	{
-		auto max_depth_exceeded (false);
-		auto max_depth_possible (0);
-		for (auto ch : body)
+		if (in_string)
 		{
-			if (ch == '[' || ch == '{')
+			if (*i == '\\')
 			{
-				if (max_depth_possible >= rpc.config.max_json_depth)
+				if (i + 1 != n)
 				{
-					max_depth_exceeded = true;
-					break;
+					++i;
 				}
-				++max_depth_possible;
+			}
+			else if (*i == '"')
+			{
+				in_string = false;
+			}
+		}
+		else
+		{
+			switch (*i)
+			{
+				case '"':
+					in_string = true;
+					break;
+				case '[':
+				case '{':
+					++depth;
+					result = depth > max_a;
+					break;
+				case ']':
+				case '}':
+					if (depth > 0)
+					{
+						--depth;
+					}
+					break;
 			}
 		}
-		if (max_depth_exceeded)
+	}
+	return result;
+}
+}
+
+void btcb::rpc_handler::process_request ()
+{
+	try
+	{
+		if (json_depth_exceeded (body, rpc.config.max_json_depth))
 		{
 			error_response (response, "Max JSON depth exceeded");
 		}
 		else
 		{
-			std::stringstream istream (body);
+			boost::iostreams::stream<boost::iostreams::array_source> istream (body.data (), body.size ());
 			boost::property_tree::read_json (istream, request);
 			std::string action (request.get<std::string> ("action"));
 			if (node.config.logging.log_rpc ())
 			{
 				BOOST_LOG (node.log) << boost::str (boost::format ("%1% ") % request_id) << filter_request (request);
 			}
-			if (action == "account_balance")
-			{
-				account_balance ();
-			}
-			else if (action == "account_block_count")
-			{
-				account_block_count ();
-			}
-			else if (action == "account_count")
-			{
-				account_count ();
-			}
-			else if (action == "account_create")
-			{
-				account_create ();
-			}
-			else if (action == "account_get")
-			{
-				account_get ();
-			}
-			else if (action == "account_history")
-			{
-				account_history ();
-			}
-			else if (action == "account_info")
-			{
-				account_info ();
-			}
-			else if (action == "account_key")
-			{
-				account_key ();
-			}
-			else if (action == "account_list")
-			{
-				account_list ();
-			}
-			else if (action == "account_move")
-			{
-				account_move ();
-			}
-			else if (action == "account_remove")
-			{
-				account_remove ();
-			}
-			else if (action == "account_representative")
-			{
-				account_representative ();
-			}
-			else if (action == "account_representative_set")
-			{
-				account_representative_set ();
-			}
-			else if (action == "account_weight")
-			{
-				account_weight ();
-			}
-			else if (action == "accounts_balances")
-			{
-				accounts_balances ();
-			}
-			else if (action == "accounts_create")
-			{
-				accounts_create ();
-			}
-			else if (action == "accounts_frontiers")
-			{
-				accounts_frontiers ();
-			}
-			else if (action == "accounts_pending")
-			{
-				accounts_pending ();
-			}
-			else if (action == "available_supply")
-			{
-				available_supply ();
-			}
-			else if (action == "block")
-			{
-				block ();
-			}
-			else if (action == "block_confirm")
-			{
-				block_confirm ();
-			}
-			else if (action == "blocks")
-			{
-				blocks ();
-			}
-			else if (action == "blocks_info")
-			{
-				blocks_info ();
-			}
-			else if (action == "block_account")
-			{
-				block_account ();
-			}
-			else if (action == "block_count")
-			{
-				block_count ();
-			}
-			else if (action == "block_count_type")
-			{
-				block_count_type ();
-			}
-			else if (action == "block_create")
-			{
-				block_create ();
-			}
-			else if (action == "block_hash")
-			{
-				block_hash ();
-			}
-			else if (action == "successors")
-			{
-				chain (true);
-			}
-			else if (action == "bootstrap")
-			{
-				bootstrap ();
-			}
-			else if (action == "bootstrap_any")
-			{
-				bootstrap_any ();
-			}
-			else if (action == "bootstrap_lazy")
-			{
-				bootstrap_lazy ();
-			}
-			else if (action == "bootstrap_status")
-			{
-				bootstrap_status ();
-			}
-			else if (action == "chain")
-			{
-				chain ();
-			}
-			else if (action == "delegators")
-			{
-				delegators ();
-			}
-			else if (action == "delegators_count")
-			{
-				delegators_count ();
-			}
-			else if (action == "deterministic_key")
-			{
-				deterministic_key ();
-			}
-			else if (action == "confirmation_active")
-			{
-				confirmation_active ();
-			}
-			else if (action == "confirmation_history")
-			{
-				confirmation_history ();
-			}
-			else if (action == "confirmation_info")
-			{
-				confirmation_info ();
-			}
-			else if (action == "confirmation_quorum")
-			{
-				confirmation_quorum ();
-			}
-			else if (action == "frontiers")
-			{
-				frontiers ();
-			}
-			else if (action == "frontier_count")
-			{
-				account_count ();
-			}
-			else if (action == "history")
-			{
-				request.put ("head", request.get<std::string> ("hash"));
-				account_history ();
-			}
-			else if (action == "keepalive")
-			{
-				keepalive ();
-			}
-			else if (action == "key_create")
-			{
-				key_create ();
-			}
-			else if (action == "key_expand")
-			{
-				key_expand ();
-			}
-			else if (action == "krai_from_raw")
-			{
-				mrai_from_raw (btcb::kbcb_ratio);
-			}
-			else if (action == "krai_to_raw")
-			{
-				mrai_to_raw (btcb::kbcb_ratio);
-			}
-			else if (action == "ledger")
-			{
-				ledger ();
-			}
-			else if (action == "mrai_from_raw")
-			{
-				mrai_from_raw ();
-			}
-			else if (action == "mrai_to_raw")
-			{
-				mrai_to_raw ();
-			}
-			else if (action == "node_id")
-			{
-				node_id ();
-			}
-			else if (action == "node_id_delete")
-			{
-				node_id_delete ();
-			}
-			else if (action == "password_change")
-			{
-				password_change ();
-			}
-			else if (action == "password_enter")
-			{
-				password_enter ();
-			}
-			else if (action == "password_valid")
-			{
-				password_valid ();
-			}
-			else if (action == "payment_begin")
-			{
-				payment_begin ();
-			}
-			else if (action == "payment_init")
-			{
-				payment_init ();
-			}
-			else if (action == "payment_end")
-			{
-				payment_end ();
-			}
-			else if (action == "payment_wait")
-			{
-				payment_wait ();
-			}
-			else if (action == "peers")
-			{
-				peers ();
-			}
-			else if (action == "pending")
-			{
-				pending ();
-			}
-			else if (action == "pending_exists")
-			{
-				pending_exists ();
-			}
-			else if (action == "process")
-			{
-				process ();
-			}
-			else if (action == "btcb_from_raw")
-			{
-				mrai_from_raw (btcb::bcb_ratio);
-			}
-			else if (action == "btcb_to_raw")
-			{
-				mrai_to_raw (btcb::bcb_ratio);
-			}
-			else if (action == "receive")
-			{
-				receive ();
-			}
-			else if (action == "receive_minimum")
-			{
-				receive_minimum ();
-			}
-			else if (action == "receive_minimum_set")
-			{
-				receive_minimum_set ();
-			}
-			else if (action == "representatives")
-			{
-				representatives ();
-			}
-			else if (action == "representatives_online")
-			{
-				representatives_online ();
-			}
-			else if (action == "republish")
-			{
-				republish ();
-			}
-			else if (action == "search_pending")
-			{
-				search_pending ();
-			}
-			else if (action == "search_pending_all")
-			{
-				search_pending_all ();
-			}
-			else if (action == "send")
-			{
-				send ();
-			}
-			else if (action == "stats")
-			{
-				stats ();
-			}
-			else if (action == "stop")
-			{
-				stop ();
-			}
-			else if (action == "unchecked")
-			{
-				unchecked ();
-			}
-			else if (action == "unchecked_clear")
-			{
-				unchecked_clear ();
-			}
-			else if (action == "unchecked_get")
-			{
-				unchecked_get ();
-			}
-			else if (action == "unchecked_keys")
+			auto & actions (rpc_actions ());
+			auto existing (actions.find (action));
+			if (existing != actions.end ())
 			{
-				unchecked_keys ();
-			}
-			else if (action == "validate_account_number")
-			{
-				validate_account_number ();
-			}
-			else if (action == "version")
-			{
-				version ();
-			}
-			else if (action == "wallet_add")
-			{
-				wallet_add ();
-			}
-			else if (action == "wallet_add_watch")
-			{
-				wallet_add_watch ();
-			}
-			// Obsolete
-			else if (action == "wallet_balance_total")
-			{
-				wallet_info ();
-			}
-			else if (action == "wallet_balances")
-			{
-				wallet_balances ();
-			}
-			else if (action == "wallet_change_seed")
-			{
-				wallet_change_seed ();
-			}
-			else if (action == "wallet_contains")
-			{
-				wallet_contains ();
-			}
-			else if (action == "wallet_create")
-			{
-				wallet_create ();
-			}
-			else if (action == "wallet_destroy")
-			{
-				wallet_destroy ();
-			}
-			else if (action == "wallet_export")
-			{
-				wallet_export ();
-			}
-			else if (action == "wallet_frontiers")
-			{
-				wallet_frontiers ();
-			}
-			else if (action == "wallet_info")
-			{
-				wallet_info ();
-			}
-			else if (action == "wallet_key_valid")
-			{
-				wallet_key_valid ();
-			}
-			else if (action == "wallet_ledger")
-			{
-				wallet_ledger ();
-			}
-			else if (action == "wallet_lock")
-			{
-				wallet_lock ();
-			}
-			else if (action == "wallet_locked")
-			{
-				password_valid (true);
-			}
-			else if (action == "wallet_pending")
-			{
-				wallet_pending ();
-			}
-			else if (action == "wallet_representative")
-			{
-				wallet_representative ();
-			}
-			else if (action == "wallet_representative_set")
-			{
-				wallet_representative_set ();
-			}
-			else if (action == "wallet_republish")
-			{
-				wallet_republish ();
-			}
-			else if (action == "wallet_unlock")
-			{
-				password_enter ();
-			}
-			else if (action == "wallet_work_get")
-			{
-				wallet_work_get ();
-			}
-			else if (action == "work_generate")
-			{
-				work_generate ();
-			}
-			else if (action == "work_cancel")
-			{
-				work_cancel ();
-			}
-			else if (action == "work_get")
-			{
-				work_get ();
-			}
-			else if (action == "work_set")
-			{
-				work_set ();
-			}
-			else if (action == "work_validate")
-			{
-				work_validate ();
-			}
-			else if (action == "work_peer_add")
-			{
-				work_peer_add ();
-			}
-			else if (action == "work_peers")
-			{
-				work_peers ();
-			}
-			else if (action == "work_peers_clear")
-			{
-				work_peers_clear ();
+				// Latency runs until the response is sent, which for some actions happens after they return
+				auto histogram (rpc.action_latency.at (action));
+				auto start (std::chrono::steady_clock::now ());
+				auto respond (response);
+				response = [histogram, start, respond](boost::property_tree::ptree const & tree_a) {
+					histogram->add (std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - start).count ());
+					respond (tree_a);
+				};
+				auto respond_body (response_body);
+				response_body = [histogram, start, respond_body](std::string body_a) {
+					histogram->add (std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - start).count ());
+					respond_body (std::move (body_a));
+				};
+				existing->second (*this);
 			}
 			else
 			{
@@ -6,7 +6,11 @@
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <btcb/secure/utility.hpp>
+
+#include <chrono>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 namespace btcb
 {
@@ -49,6 +53,10 @@ public:
 	uint64_t chain_request_limit;
 	rpc_secure_config secure;
 	uint8_t max_json_depth;
+	/** Requests served on one persistent connection before it's closed, 0 for no limit */
+	uint64_t max_requests_per_connection;
+	/** Persistent connections are closed after waiting this long for the next request */
+	std::chrono::seconds idle_timeout;
 };
 enum class payment_status
 {
@@ -62,14 +70,21 @@ enum class payment_status
 };
 class wallet;
 class payment_observer;
+class rpc_handler;
+class rpc_handler_pool;
+class stat_histogram;
+class rpc_connection;
 class rpc
 {
 public:
 	rpc (boost::asio::io_context &, btcb::node &, btcb::rpc_config const &);
-	virtual ~rpc () = default;
+	virtual ~rpc ();
 	void start ();
 	virtual void accept ();
+	/** Stops accepting connections and closes persistent ones once their current request is answered */
 	void stop ();
+	/** Registers an accepted connection so stop () can close it */
+	void track (std::shared_ptr<btcb::rpc_connection>);
 	void observer_action (btcb::account const &);
 	boost::asio::ip::tcp::acceptor acceptor;
 	std::mutex mutex;
@@ -77,6 +92,11 @@ public:
 	btcb::rpc_config config;
 	btcb::node & node;
 	bool on;
+	std::shared_ptr<btcb::rpc_handler_pool> handlers;
+	/** Request latency of each action in microseconds, filled in by the constructor and only read afterwards */
+	std::unordered_map<std::string, std::shared_ptr<btcb::stat_histogram>> action_latency;
+	std::mutex connections_mutex;
+	std::vector<std::weak_ptr<btcb::rpc_connection>> connections;
     static uint16_t const rpc_port = btcb::btcb_network == btcb::btcb_networks::btcb_live_network ? 17076 : 15000;
 };
 class rpc_connection : public std::enable_shared_from_this<btcb::rpc_connection>
@@ -85,8 +105,17 @@ public:
 	rpc_connection (btcb::node &, btcb::rpc &);
 	virtual ~rpc_connection () = default;
 	virtual void parse_connection ();
+	/** Reads the next request, calling received () once it's complete */
 	virtual void read ();
+	/** Sends res, calling written () once it's sent */
+	virtual void write ();
+	/** Ends the connection after the last response was sent */
+	virtual void finish ();
 	virtual void write_result (std::string body, unsigned version);
+	/** Closes the socket, aborting any pending read */
+	void close ();
+	/** Closes the connection now if it's waiting for a request, otherwise once the current one is answered */
+	void stop ();
 	std::shared_ptr<btcb::node> node;
 	btcb::rpc & rpc;
 	boost::asio::ip::tcp::socket socket;
@@ -94,6 +123,26 @@ public:
 	boost::beast::http::request<boost::beast::http::string_body> request;
 	boost::beast::http::response<boost::beast::http::string_body> res;
 	std::atomic_flag responded;
+	/** Requests read on this connection */
+	uint64_t requests;
+	/** Copied from the config so a connection never reads the rpc server while it's idle */
+	uint64_t max_requests;
+	std::chrono::seconds idle_timeout;
+
+protected:
+	void received (boost::system::error_code const &);
+	/** Reads the next request on a persistent connection, pipelined requests are already buffered, otherwise finishes */
+	void written (boost::system::error_code const &);
+	void process ();
+	/** Starts the idle timeout while waiting for a request */
+	void idle ();
+	/** Periodically closes the connection once it has been idle past its cutoff */
+	void checkup ();
+	/** Whether the connection stays open after the current response */
+	bool keep_alive;
+	std::atomic<bool> stopped;
+	/** Steady clock time when an idle connection is closed, the maximum while a request is being handled */
+	std::atomic<uint64_t> cutoff;
 };
 class payment_observer : public std::enable_shared_from_this<btcb::payment_observer>
 {
@@ -115,7 +164,9 @@ public:
 class rpc_handler : public std::enable_shared_from_this<btcb::rpc_handler>
 {
 public:
-	rpc_handler (btcb::node &, btcb::rpc &, std::string const &, std::string const &, std::function<void(boost::property_tree::ptree const &)> const &);
+	rpc_handler (btcb::node &, btcb::rpc &, std::string const &, std::string const &, std::function<void(boost::property_tree::ptree const &)> const &, std::function<void(std::string)> const &);
+	/** Prepares a recycled handler for a new request */
+	void reset (std::string const &, std::string const &, std::function<void(boost::property_tree::ptree const &)> const &, std::function<void(std::string)> const &);
 	void process_request ();
 	void account_balance ();
 	void account_block_count ();
@@ -193,6 +244,7 @@ public:
 	void unchecked_clear ();
 	void unchecked_get ();
 	void unchecked_keys ();
+	void unchecked_cache ();
 	void validate_account_number ();
 	void version ();
 	void wallet_add ();
@@ -221,12 +273,15 @@ public:
 	void work_peer_add ();
 	void work_peers ();
 	void work_peers_clear ();
+	void work_queue ();
 	std::string body;
 	std::string request_id;
 	btcb::node & node;
 	btcb::rpc & rpc;
 	boost::property_tree::ptree request;
 	std::function<void(boost::property_tree::ptree const &)> response;
+	/** Sends a complete JSON document, used by actions that write large responses with json_stream instead of a property tree */
+	std::function<void(std::string)> response_body;
 	void response_errors ();
 	std::error_code ec;
 	boost::property_tree::ptree response_l;
@@ -240,6 +295,26 @@ public:
 	uint64_t count_optional_impl (uint64_t = std::numeric_limits<uint64_t>::max ());
 	bool rpc_control_impl ();
 };
+/**
+ * Recycles rpc_handler objects between requests instead of allocating one per request, keeping the capacity of the request body buffer.
+ * A handler goes back to the pool once its last reference is released, which for asynchronous actions may be well after the response was sent.
+ */
+class rpc_handler_pool : public std::enable_shared_from_this<btcb::rpc_handler_pool>
+{
+public:
+	rpc_handler_pool (btcb::node &, btcb::rpc &);
+	std::shared_ptr<btcb::rpc_handler> get (std::string const &, std::string const &, std::function<void(boost::property_tree::ptree const &)> const &, std::function<void(std::string)> const &);
+	/** Handlers waiting to be reused */
+	size_t size ();
+	static size_t constexpr max_idle = 64;
+
+private:
+	void release (btcb::rpc_handler *);
+	btcb::node & node;
+	btcb::rpc & rpc;
+	std::mutex mutex;
+	std::vector<std::unique_ptr<btcb::rpc_handler>> idle;
+};
 /** Returns the correct RPC implementation based on TLS configuration */
 std::unique_ptr<btcb::rpc> get_rpc (boost::asio::io_context & io_ctx_a, btcb::node & node_a, btcb::rpc_config const & config_a);
 }
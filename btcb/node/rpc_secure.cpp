@@ -105,6 +105,7 @@ void btcb::rpc_secure::accept ()
 		}
 		if (!ec)
 		{
+			track (connection);
 			connection->parse_connection ();
 		}
 		else
@@ -122,8 +123,10 @@ stream (socket, rpc_a.ssl_context)
 
 void btcb::rpc_connection_secure::parse_connection ()
 {
-	// Perform the SSL handshake
+	// Perform the SSL handshake, the idle timeout also covers clients that never complete it
 	auto this_l = std::static_pointer_cast<btcb::rpc_connection_secure> (shared_from_this ());
+	checkup ();
+	idle ();
 	stream.async_handshake (boost::asio::ssl::stream_base::server,
 	[this_l](auto & ec) {
 		this_l->handle_handshake (ec);
@@ -132,7 +135,7 @@ void btcb::rpc_connection_secure::parse_connection ()
 
 void btcb::rpc_connection_secure::on_shutdown (const boost::system::error_code & error)
 {
-	// No-op. We initiate the shutdown (since the RPC server kills the connection after each request)
+	// No-op. We initiate the shutdown once the connection won't take further requests
 	// and we'll thus get an expected EOF error. If the client disconnects, a short-read error will be expected.
 }
 
@@ -151,46 +154,25 @@ void btcb::rpc_connection_secure::handle_handshake (const boost::system::error_c
 void btcb::rpc_connection_secure::read ()
 {
 	auto this_l (std::static_pointer_cast<btcb::rpc_connection_secure> (shared_from_this ()));
+	request = boost::beast::http::request<boost::beast::http::string_body> ();
+	idle ();
 	boost::beast::http::async_read (stream, buffer, request, [this_l](boost::system::error_code const & ec, size_t bytes_transferred) {
-		if (!ec)
-		{
-			this_l->node->background ([this_l]() {
-				auto start (std::chrono::steady_clock::now ());
-				auto version (this_l->request.version ());
-				std::string request_id (boost::str (boost::format ("%1%") % boost::io::group (std::hex, std::showbase, reinterpret_cast<uintptr_t> (this_l.get ()))));
-				auto response_handler ([this_l, version, start, request_id](boost::property_tree::ptree const & tree_a) {
-					std::stringstream ostream;
-					boost::property_tree::write_json (ostream, tree_a);
-					ostream.flush ();
-					auto body (ostream.str ());
-					this_l->write_result (body, version);
-					boost::beast::http::async_write (this_l->stream, this_l->res, [this_l](boost::system::error_code const & ec, size_t bytes_transferred) {
-						// Perform the SSL shutdown
-						this_l->stream.async_shutdown ([this_l](auto const & ec_shutdown) {
-							this_l->on_shutdown (ec_shutdown);
-						});
-					});
-
-					if (this_l->node->config.logging.log_rpc ())
-					{
-						BOOST_LOG (this_l->node->log) << boost::str (boost::format ("TLS: RPC request %2% completed in: %1% microseconds") % std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - start).count () % request_id);
-					}
-				});
-
-				if (this_l->request.method () == boost::beast::http::verb::post)
-				{
-					auto handler (std::make_shared<btcb::rpc_handler> (*this_l->node, this_l->rpc, this_l->request.body (), request_id, response_handler));
-					handler->process_request ();
-				}
-				else
-				{
-					error_response (response_handler, "Can only POST requests");
-				}
-			});
-		}
-		else
-		{
-			BOOST_LOG (this_l->node->log) << "TLS: Read error: " << ec.message () << std::endl;
-		}
+		this_l->received (ec);
+	});
+}
+
+void btcb::rpc_connection_secure::write ()
+{
+	auto this_l (std::static_pointer_cast<btcb::rpc_connection_secure> (shared_from_this ()));
+	boost::beast::http::async_write (stream, res, [this_l](boost::system::error_code const & ec, size_t bytes_transferred) {
+		this_l->written (ec);
+	});
+}
+
+void btcb::rpc_connection_secure::finish ()
+{
+	auto this_l (std::static_pointer_cast<btcb::rpc_connection_secure> (shared_from_this ()));
+	stream.async_shutdown ([this_l](auto const & ec_shutdown) {
+		this_l->on_shutdown (ec_shutdown);
 	});
 }
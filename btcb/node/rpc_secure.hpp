@@ -39,6 +39,9 @@ public:
 	rpc_connection_secure (btcb::node &, btcb::rpc_secure &);
 	void parse_connection () override;
 	void read () override;
+	void write () override;
+	/** Sends the TLS close notify */
+	void finish () override;
 	/** The TLS handshake callback */
 	void handle_handshake (const boost::system::error_code & error);
 	/** The TLS async shutdown callback */
@@ -1,11 +1,13 @@
 #include <btcb/node/stats.hpp>
 
+#include <algorithm>
 #include <boost/asio.hpp>
 #include <boost/format.hpp>
 #include <boost/property_tree/json_parser.hpp>
 #include <ctime>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <tuple>
 
@@ -79,6 +81,25 @@ public:
 		entries.push_back (std::make_pair ("", entry));
 	}
 
+	void write_histogram (tm & tm, std::string name, btcb::stat_histogram const & histogram) override
+	{
+		boost::property_tree::ptree entry;
+		entry.put ("time", boost::format ("%02d:%02d:%02d") % tm.tm_hour % tm.tm_min % tm.tm_sec);
+		entry.put ("name", name);
+		entry.put ("count", histogram.count ());
+		entry.put ("sum", histogram.sum ());
+		boost::property_tree::ptree buckets;
+		for (auto & i : histogram.buckets ())
+		{
+			boost::property_tree::ptree bucket;
+			bucket.put ("bound", i.first == std::numeric_limits<uint64_t>::max () ? std::string ("inf") : std::to_string (i.first));
+			bucket.put ("count", i.second);
+			buckets.push_back (std::make_pair ("", bucket));
+		}
+		entry.add_child ("buckets", buckets);
+		entries.push_back (std::make_pair ("", entry));
+	}
+
 	void finalize () override
 	{
 		tree.add_child ("entries", entries);
@@ -132,6 +153,16 @@ public:
 		log << boost::format ("%02d:%02d:%02d") % tm.tm_hour % tm.tm_min % tm.tm_sec << "," << type << "," << detail << "," << dir << "," << value << std::endl;
 	}
 
+	void write_histogram (tm & tm, std::string name, btcb::stat_histogram const & histogram) override
+	{
+		log << boost::format ("%02d:%02d:%02d") % tm.tm_hour % tm.tm_min % tm.tm_sec << "," << name << "," << histogram.count () << "," << histogram.sum ();
+		for (auto & i : histogram.buckets ())
+		{
+			log << "," << i.second;
+		}
+		log << std::endl;
+	}
+
 	void rotate () override
 	{
 		log.close ();
@@ -140,8 +171,111 @@ public:
 	}
 };
 
+size_t constexpr btcb::stat_counters::type_count;
+size_t constexpr btcb::stat_counters::detail_count;
+size_t constexpr btcb::stat_counters::dir_count;
+size_t constexpr btcb::stat_counters::key_count;
+size_t constexpr btcb::stat_counters::shard_count;
+
+btcb::stat_counters::stat_counters () :
+counters (key_count * shard_count)
+{
+}
+
+size_t btcb::stat_counters::index (uint32_t key)
+{
+	size_t type (key >> 16 & 0xff);
+	size_t detail (key >> 8 & 0xff);
+	size_t dir (key & 0xff);
+	assert (type < type_count && detail < detail_count && dir < dir_count);
+	return (type * detail_count + detail) * dir_count + dir;
+}
+
+uint32_t btcb::stat_counters::key (size_t index)
+{
+	uint32_t dir (index % dir_count);
+	uint32_t detail (index / dir_count % detail_count);
+	uint32_t type (index / dir_count / detail_count);
+	return type << 16 | detail << 8 | dir;
+}
+
+size_t btcb::stat_counters::shard ()
+{
+	static std::atomic<size_t> next{ 0 };
+	thread_local size_t result (next++ % shard_count);
+	return result;
+}
+
+void btcb::stat_counters::add (uint32_t key, uint64_t value)
+{
+	counters[shard () * key_count + index (key)].fetch_add (value, std::memory_order_relaxed);
+}
+
+uint64_t btcb::stat_counters::value (uint32_t key) const
+{
+	uint64_t result (0);
+	auto index_l (index (key));
+	for (size_t i (0); i < shard_count; ++i)
+	{
+		result += counters[i * key_count + index_l].load (std::memory_order_relaxed);
+	}
+	return result;
+}
+
+void btcb::stat_counters::for_each (std::function<void(uint32_t, uint64_t)> const & action) const
+{
+	for (size_t i (0); i < key_count; ++i)
+	{
+		uint64_t value_l (0);
+		for (size_t j (0); j < shard_count; ++j)
+		{
+			value_l += counters[j * key_count + i].load (std::memory_order_relaxed);
+		}
+		if (value_l != 0)
+		{
+			action (key (i), value_l);
+		}
+	}
+}
+
+btcb::stat_histogram::stat_histogram (std::vector<uint64_t> const & bounds_a) :
+bounds (bounds_a),
+counts (bounds_a.size () + 1)
+{
+	assert (std::is_sorted (bounds.begin (), bounds.end ()));
+}
+
+void btcb::stat_histogram::add (uint64_t value_a)
+{
+	auto bucket (std::lower_bound (bounds.begin (), bounds.end (), value_a) - bounds.begin ());
+	counts[bucket].fetch_add (1, std::memory_order_relaxed);
+	values_count.fetch_add (1, std::memory_order_relaxed);
+	values_sum.fetch_add (value_a, std::memory_order_relaxed);
+}
+
+uint64_t btcb::stat_histogram::count () const
+{
+	return values_count.load (std::memory_order_relaxed);
+}
+
+uint64_t btcb::stat_histogram::sum () const
+{
+	return values_sum.load (std::memory_order_relaxed);
+}
+
+std::vector<std::pair<uint64_t, uint64_t>> btcb::stat_histogram::buckets () const
+{
+	std::vector<std::pair<uint64_t, uint64_t>> result;
+	for (size_t i (0); i < counts.size (); ++i)
+	{
+		result.push_back (std::make_pair (i < bounds.size () ? bounds[i] : std::numeric_limits<uint64_t>::max (), counts[i].load (std::memory_order_relaxed)));
+	}
+	return result;
+}
+
 btcb::stat::stat (btcb::stat_config config) :
-config (config)
+config (config),
+observed (config.sampling_enabled || config.log_interval_counters > 0)
 {
 }
 
@@ -202,17 +336,15 @@ void btcb::stat::log_counters_impl (stat_log_sink & sink)
 		sink.write_header ("counters", walltime);
 	}
 
-	for (auto & it : entries)
-	{
-		std::time_t time = std::chrono::system_clock::to_time_t (it.second->counter.timestamp);
-		tm local_tm = *localtime (&time);
-
-		auto key = it.first;
+	// Counters don't track their last update time, entries are stamped with the time they are logged
+	std::time_t time = std::chrono::system_clock::to_time_t (std::chrono::system_clock::now ());
+	tm local_tm = *localtime (&time);
+	counters.for_each ([this, &sink, &local_tm](uint32_t key, uint64_t value) {
 		std::string type = type_to_string (key);
 		std::string detail = detail_to_string (key);
 		std::string dir = dir_to_string (key);
-		sink.write_entry (local_tm, type, detail, dir, it.second->counter.value);
-	}
+		sink.write_entry (local_tm, type, detail, dir, value);
+	});
 	sink.entries ()++;
 	sink.finalize ();
 }
@@ -255,7 +387,52 @@ void btcb::stat::log_samples_impl (stat_log_sink & sink)
 	sink.finalize ();
 }
 
+std::shared_ptr<btcb::stat_histogram> btcb::stat::histogram (std::string const & name_a, std::vector<uint64_t> const & bounds_a)
+{
+	std::lock_guard<std::mutex> lock (stat_mutex);
+	auto existing (histograms.find (name_a));
+	if (existing == histograms.end ())
+	{
+		existing = histograms.insert (std::make_pair (name_a, std::make_shared<btcb::stat_histogram> (bounds_a))).first;
+	}
+	return existing->second;
+}
+
+void btcb::stat::log_histograms (stat_log_sink & sink)
+{
+	std::unique_lock<std::mutex> lock (stat_mutex);
+	sink.begin ();
+	if (sink.entries () >= config.log_rotation_count)
+	{
+		sink.rotate ();
+	}
+
+	if (config.log_headers)
+	{
+		auto walltime (std::chrono::system_clock::now ());
+		sink.write_header ("histograms", walltime);
+	}
+
+	std::time_t time = std::chrono::system_clock::to_time_t (std::chrono::system_clock::now ());
+	tm local_tm = *localtime (&time);
+	for (auto & i : histograms)
+	{
+		sink.write_histogram (local_tm, i.first, *i.second);
+	}
+	sink.entries ()++;
+	sink.finalize ();
+}
+
 void btcb::stat::update (uint32_t key_a, uint64_t value)
+{
+	counters.add (key_a, value);
+	if (observed.load (std::memory_order_relaxed))
+	{
+		update_observed (key_a, value);
+	}
+}
+
+void btcb::stat::update_observed (uint32_t key_a, uint64_t value)
 {
 	static file_writer log_count (config.log_counters_filename);
 	static file_writer log_sample (config.log_samples_filename);
@@ -266,9 +443,8 @@ void btcb::stat::update (uint32_t key_a, uint64_t value)
 	auto entry (get_entry_impl (key_a, config.interval, config.capacity));
 
 	// Counters
-	auto old (entry->counter.value);
-	entry->counter.add (value);
-	entry->count_observers.notify (old, entry->counter.value);
+	auto current (counters.value (key_a));
+	entry->count_observers.notify (current - value, current);
 
 	std::chrono::duration<double, std::milli> duration = now - log_last_count_writeout;
 	if (config.log_interval_counters > 0 && duration.count () > config.log_interval_counters)
@@ -351,6 +527,18 @@ std::string btcb::stat::type_to_string (uint32_t key)
 		case btcb::stat::type::message:
 			res = "message";
 			break;
+		case btcb::stat::type::block_processor:
+			res = "block_processor";
+			break;
+		case btcb::stat::type::vote_cache:
+			res = "vote_cache";
+			break;
+		case btcb::stat::type::unchecked:
+			res = "unchecked";
+			break;
+		case btcb::stat::type::active:
+			res = "active";
+			break;
 	}
 	return res;
 }
@@ -481,6 +669,75 @@ std::string btcb::stat::detail_to_string (uint32_t key)
 		case btcb::stat::detail::outdated_version:
 			res = "outdated_version";
 			break;
+		case btcb::stat::detail::duplicate_publish:
+			res = "duplicate_publish";
+			break;
+		case btcb::stat::detail::duplicate_confirm_ack:
+			res = "duplicate_confirm_ack";
+			break;
+		case btcb::stat::detail::verified_blocks:
+			res = "verified_blocks";
+			break;
+		case btcb::stat::detail::verification_batches:
+			res = "verification_batches";
+			break;
+		case btcb::stat::detail::verification_time:
+			res = "verification_time";
+			break;
+		case btcb::stat::detail::verified_queue_depth:
+			res = "verified_queue_depth";
+			break;
+		case btcb::stat::detail::written_blocks:
+			res = "written_blocks";
+			break;
+		case btcb::stat::detail::write_batches:
+			res = "write_batches";
+			break;
+		case btcb::stat::detail::write_time:
+			res = "write_time";
+			break;
+		case btcb::stat::detail::requests:
+			res = "requests";
+			break;
+		case btcb::stat::detail::request_time:
+			res = "request_time";
+			break;
+		case btcb::stat::detail::queue_depth:
+			res = "queue_depth";
+			break;
+		case btcb::stat::detail::hit:
+			res = "hit";
+			break;
+		case btcb::stat::detail::miss:
+			res = "miss";
+			break;
+		case btcb::stat::detail::put:
+			res = "put";
+			break;
+		case btcb::stat::detail::satisfied:
+			res = "satisfied";
+			break;
+		case btcb::stat::detail::spilled:
+			res = "spilled";
+			break;
+		case btcb::stat::detail::expired:
+			res = "expired";
+			break;
+		case btcb::stat::detail::lock_contended:
+			res = "lock_contended";
+			break;
+		case btcb::stat::detail::shard_contended:
+			res = "shard_contended";
+			break;
+		case btcb::stat::detail::backlogged:
+			res = "backlogged";
+			break;
+		case btcb::stat::detail::admitted:
+			res = "admitted";
+			break;
+		case btcb::stat::detail::backlog_dropped:
+			res = "backlog_dropped";
+			break;
 	}
 	return res;
 }
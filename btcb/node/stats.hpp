@@ -9,6 +9,7 @@
 #include <btcb/lib/utility.hpp>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace btcb
 {
@@ -94,9 +95,6 @@ public:
 	/** Value within the current sample interval */
 	stat_datapoint sample_current;
 
-	/** Counting value for this entry, including the time of last update. This is never reset and only increases. */
-	stat_datapoint counter;
-
 	/** Zero or more observers for samples. Called at the end of the sample interval. */
 	btcb::observer_set<boost::circular_buffer<stat_datapoint> &> sample_observers;
 
@@ -104,6 +102,58 @@ public:
 	btcb::observer_set<uint64_t, uint64_t> count_observers;
 };
 
+/**
+ * Lock free counters for every type/detail/direction combination, stored in a flat array indexed by key.
+ * Each thread adds to one of several shards to avoid contending on the same cache lines, reads sum all shards.
+ */
+class stat_counters
+{
+public:
+	stat_counters ();
+	void add (uint32_t key, uint64_t value);
+	uint64_t value (uint32_t key) const;
+	/** Calls \p action with the key and value of every non-zero counter, ordered by key */
+	void for_each (std::function<void(uint32_t, uint64_t)> const & action) const;
+
+	/** Upper bounds of the stat::type, stat::detail and stat::dir enums */
+	static size_t constexpr type_count = 32;
+	static size_t constexpr detail_count = 128;
+	static size_t constexpr dir_count = 2;
+	static size_t constexpr key_count = type_count * detail_count * dir_count;
+	static size_t constexpr shard_count = 8;
+
+private:
+	static size_t index (uint32_t key);
+	static uint32_t key (size_t index);
+	/** Shard used by the calling thread */
+	static size_t shard ();
+	std::vector<std::atomic<uint64_t>> counters;
+};
+
+/**
+ * Counts values into fixed buckets, each holding the values up to its upper bound plus a final bucket for anything larger.
+ * Adding a value is lock free so histograms can be updated from any thread without going through stat_mutex.
+ */
+class stat_histogram
+{
+public:
+	/** \p bounds_a are the ascending upper bounds of each bucket */
+	stat_histogram (std::vector<uint64_t> const & bounds_a);
+	void add (uint64_t value_a);
+	/** Number of values added */
+	uint64_t count () const;
+	/** Sum of all values added */
+	uint64_t sum () const;
+	/** Upper bound and count of each bucket, the final bucket has an upper bound of the maximum uint64_t */
+	std::vector<std::pair<uint64_t, uint64_t>> buckets () const;
+
+private:
+	std::vector<uint64_t> bounds;
+	std::vector<std::atomic<uint64_t>> counts;
+	std::atomic<uint64_t> values_count{ 0 };
+	std::atomic<uint64_t> values_sum{ 0 };
+};
+
 /** Log sink interface */
 class stat_log_sink
 {
@@ -133,6 +183,11 @@ public:
 	{
 	}
 
+	/** Write a histogram entry to the log */
+	virtual void write_histogram (tm & tm, std::string name, btcb::stat_histogram const & histogram)
+	{
+	}
+
 	/** Rotates the log (e.g. empty file). This is a no-op for sinks where rotation is not supported. */
 	virtual void rotate ()
 	{
@@ -172,7 +227,7 @@ protected:
 class stat
 {
 public:
-	/** Primary statistics type */
+	/** Primary statistics type. Must stay below stat_counters::type_count */
 	enum class type : uint8_t
 	{
 		traffic,
@@ -186,10 +241,14 @@ public:
 		vote,
 		http_callback,
 		peering,
-		udp
+		udp,
+		block_processor,
+		vote_cache,
+		unchecked,
+		active
 	};
 
-	/** Optional detail type */
+	/** Optional detail type. Must stay below stat_counters::detail_count */
 	enum class detail : uint8_t
 	{
 		all = 0,
@@ -245,9 +304,42 @@ public:
 		invalid_confirm_ack_message,
 		invalid_node_id_handshake_message,
 		outdated_version,
+		duplicate_publish,
+		duplicate_confirm_ack,
 
 		// peering
 		handshake,
+
+		// block processor
+		verified_blocks,
+		verification_batches,
+		verification_time,
+		verified_queue_depth,
+		written_blocks,
+		write_batches,
+		write_time,
+
+		// http callback specific
+		requests,
+		request_time,
+		queue_depth,
+
+		// vote cache
+		hit,
+		miss,
+
+		// unchecked
+		put,
+		satisfied,
+		spilled,
+		expired,
+
+		// active transactions
+		lock_contended,
+		shard_contended,
+		backlogged,
+		admitted,
+		backlog_dropped,
 	};
 
 	/** Direction of the stat. If the direction is irrelevant, use in */
@@ -258,9 +350,7 @@ public:
 	};
 
 	/** Constructor using the default config values */
-	stat ()
-	{
-	}
+	stat () = default;
 
 	/**
 	 * Initialize stats with a config.
@@ -342,6 +432,7 @@ public:
 	 */
 	inline void observe_sample (stat::type type, stat::detail detail, stat::dir dir, std::function<void(boost::circular_buffer<stat_datapoint> &)> observer)
 	{
+		observed = true;
 		get_entry (key_of (type, detail, dir))->sample_observers.add (observer);
 	}
 
@@ -357,6 +448,7 @@ public:
 	 */
 	inline void observe_count (stat::type type, stat::detail detail, stat::dir dir, std::function<void(uint64_t, uint64_t)> observer)
 	{
+		observed = true;
 		get_entry (key_of (type, detail, dir))->count_observers.add (observer);
 	}
 
@@ -375,7 +467,7 @@ public:
 	/** Returns current value for the given counter at the detail level */
 	inline uint64_t count (stat::type type, stat::detail detail, stat::dir dir = stat::dir::in)
 	{
-		return get_entry (key_of (type, detail, dir))->counter.value;
+		return counters.value (key_of (type, detail, dir));
 	}
 
 	/** Log counters to the given log link */
@@ -384,6 +476,15 @@ public:
 	/** Log samples to the given log sink */
 	void log_samples (stat_log_sink & sink);
 
+	/**
+	 * Returns the histogram called \p name_a, creating it with \p bounds_a if it doesn't exist yet.
+	 * Callers on a hot path should keep the returned pointer rather than looking the histogram up for every value.
+	 */
+	std::shared_ptr<btcb::stat_histogram> histogram (std::string const & name_a, std::vector<uint64_t> const & bounds_a);
+
+	/** Log histograms to the given log sink */
+	void log_histograms (stat_log_sink & sink);
+
 	/** Returns a new JSON log sink */
 	std::unique_ptr<stat_log_sink> log_sink_json ();
 
@@ -417,6 +518,9 @@ private:
 	 */
 	void update (uint32_t key, uint64_t value);
 
+	/** Sample, log and notify observers after the counter for \p key has been updated. Only needed when update() cannot stay lock free. */
+	void update_observed (uint32_t key, uint64_t value);
+
 	/** Unlocked implementation of log_counters() to avoid using recursive locking */
 	void log_counters_impl (stat_log_sink & sink);
 
@@ -426,8 +530,16 @@ private:
 	/** Configuration deserialized from config.json */
 	btcb::stat_config config;
 
-	/** Stat entries are sorted by key to simplify processing of log output */
+	/** Counting value for every key. These are never reset and only increase. */
+	btcb::stat_counters counters;
+
+	/** True if sampling, periodic counter logging or observers require update() to take stat_mutex */
+	std::atomic<bool> observed{ false };
+
+	/** Sampling and observer state, sorted by key to simplify processing of log output */
 	std::map<uint32_t, std::shared_ptr<btcb::stat_entry>> entries;
+	/** Histograms by name, sorted to simplify processing of log output */
+	std::map<std::string, std::shared_ptr<btcb::stat_histogram>> histograms;
 	std::chrono::steady_clock::time_point log_last_count_writeout{ std::chrono::steady_clock::now () };
 	std::chrono::steady_clock::time_point log_last_sample_writeout{ std::chrono::steady_clock::now () };
 
@@ -0,0 +1,153 @@
+#include <btcb/node/unchecked.hpp>
+
+#include <btcb/node/node.hpp>
+
+size_t constexpr btcb::unchecked_cache::entry_size;
+std::chrono::seconds constexpr btcb::unchecked_cache::cleanup_interval;
+
+std::pair<btcb::block_hash, btcb::block_hash> btcb::unchecked_info::key () const
+{
+	return std::make_pair (dependency, hash);
+}
+
+btcb::unchecked_cache::unchecked_cache (btcb::node & node_a) :
+node (node_a)
+{
+}
+
+void btcb::unchecked_cache::put (btcb::transaction const & transaction_a, btcb::block_hash const & dependency_a, std::shared_ptr<btcb::block> block_a)
+{
+	btcb::unchecked_info info{ dependency_a, block_a->hash (), block_a, std::chrono::steady_clock::now () };
+	std::lock_guard<std::mutex> lock (mutex);
+	auto max (max_size ());
+	if (max > 0)
+	{
+		if (entries.push_back (info).second)
+		{
+			node.stats.inc (btcb::stat::type::unchecked, btcb::stat::detail::put);
+			while (entries.size () > max)
+			{
+				node.store.unchecked_put (transaction_a, entries.front ().dependency, entries.front ().block);
+				entries.pop_front ();
+				node.stats.inc (btcb::stat::type::unchecked, btcb::stat::detail::spilled);
+			}
+		}
+	}
+	else
+	{
+		node.store.unchecked_put (transaction_a, dependency_a, block_a);
+	}
+}
+
+std::vector<std::shared_ptr<btcb::block>> btcb::unchecked_cache::pop (btcb::transaction const & transaction_a, btcb::block_hash const & dependency_a)
+{
+	std::vector<std::shared_ptr<btcb::block>> result;
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		auto & index (entries.get<1> ());
+		for (auto i (index.lower_bound (std::make_pair (dependency_a, btcb::block_hash (0)))); i != index.end () && i->dependency == dependency_a;)
+		{
+			result.push_back (i->block);
+			i = index.erase (i);
+		}
+	}
+	// Counting entries only reads the table's statistics, the table is searched only when something spilled or was left by a previous run
+	if (node.store.unchecked_count (transaction_a) > 0)
+	{
+		auto cached (node.store.unchecked_get (transaction_a, dependency_a));
+		for (auto i (cached.begin ()), n (cached.end ()); i != n; ++i)
+		{
+			node.store.unchecked_del (transaction_a, btcb::unchecked_key (dependency_a, (*i)->hash ()));
+			result.push_back (*i);
+		}
+	}
+	if (!result.empty ())
+	{
+		node.stats.add (btcb::stat::type::unchecked, btcb::stat::detail::satisfied, btcb::stat::dir::in, result.size ());
+	}
+	return result;
+}
+
+std::vector<btcb::unchecked_info> btcb::unchecked_cache::list (btcb::block_hash const & start_a, size_t count_a)
+{
+	std::vector<btcb::unchecked_info> result;
+	std::lock_guard<std::mutex> lock (mutex);
+	auto & index (entries.get<1> ());
+	for (auto i (index.lower_bound (std::make_pair (start_a, btcb::block_hash (0)))), n (index.end ()); i != n && result.size () < count_a; ++i)
+	{
+		result.push_back (*i);
+	}
+	return result;
+}
+
+std::shared_ptr<btcb::block> btcb::unchecked_cache::block_get (btcb::block_hash const & hash_a)
+{
+	std::shared_ptr<btcb::block> result;
+	std::lock_guard<std::mutex> lock (mutex);
+	auto & index (entries.get<2> ());
+	auto existing (index.find (hash_a));
+	if (existing != index.end ())
+	{
+		result = existing->block;
+	}
+	return result;
+}
+
+void btcb::unchecked_cache::expire (std::chrono::steady_clock::time_point const & cutoff_a)
+{
+	size_t expired (0);
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		while (!entries.empty () && entries.front ().arrival < cutoff_a)
+		{
+			entries.pop_front ();
+			++expired;
+		}
+	}
+	if (expired > 0)
+	{
+		node.stats.add (btcb::stat::type::unchecked, btcb::stat::detail::expired, btcb::stat::dir::in, expired);
+	}
+}
+
+void btcb::unchecked_cache::flush (btcb::transaction const & transaction_a)
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	for (auto & i : entries)
+	{
+		node.store.unchecked_put (transaction_a, i.dependency, i.block);
+	}
+	entries.clear ();
+}
+
+void btcb::unchecked_cache::clear (btcb::transaction const & transaction_a)
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	entries.clear ();
+	node.store.unchecked_clear (transaction_a);
+}
+
+size_t btcb::unchecked_cache::size ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	return entries.size ();
+}
+
+size_t btcb::unchecked_cache::count (btcb::transaction const & transaction_a)
+{
+	auto result (node.store.unchecked_count (transaction_a));
+	std::lock_guard<std::mutex> lock (mutex);
+	result += entries.size ();
+	return result;
+}
+
+std::chrono::steady_clock::time_point btcb::unchecked_cache::oldest ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	return entries.empty () ? std::chrono::steady_clock::now () : entries.front ().arrival;
+}
+
+size_t btcb::unchecked_cache::max_size () const
+{
+	return static_cast<size_t> (node.config.unchecked_cache_mb) * 1024 * 1024 / entry_size;
+}
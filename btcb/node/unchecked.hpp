@@ -0,0 +1,73 @@
+#pragma once
+
+#include <btcb/secure/common.hpp>
+
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/mem_fun.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index_container.hpp>
+
+#include <chrono>
+#include <mutex>
+
+namespace btcb
+{
+class node;
+class transaction;
+class unchecked_info
+{
+public:
+	/** Ordered by dependency then block hash, the same as the unchecked table */
+	std::pair<btcb::block_hash, btcb::block_hash> key () const;
+	btcb::block_hash dependency;
+	btcb::block_hash hash;
+	std::shared_ptr<btcb::block> block;
+	std::chrono::steady_clock::time_point arrival;
+};
+/**
+ * Blocks waiting on a missing dependency, kept in memory so the block processor doesn't write to the unchecked table for every gap.
+ * Entries older than the configured cutoff are dropped. Once the memory cap is reached the oldest entries spill to the unchecked table,
+ * as does everything left at shutdown. Blocks in the table are still handed back when their dependency arrives.
+ */
+class unchecked_cache
+{
+public:
+	unchecked_cache (btcb::node &);
+	void put (btcb::transaction const &, btcb::block_hash const & dependency_a, std::shared_ptr<btcb::block>);
+	/** Removes and returns every block waiting on \p dependency_a, from memory and the unchecked table */
+	std::vector<std::shared_ptr<btcb::block>> pop (btcb::transaction const &, btcb::block_hash const & dependency_a);
+	/** Up to \p count_a blocks in memory with a dependency of at least \p start_a, in key order */
+	std::vector<btcb::unchecked_info> list (btcb::block_hash const & start_a, size_t count_a);
+	/** Returns the block with hash \p hash_a if it's in memory */
+	std::shared_ptr<btcb::block> block_get (btcb::block_hash const & hash_a);
+	/** Drops blocks that arrived before \p cutoff_a */
+	void expire (std::chrono::steady_clock::time_point const & cutoff_a);
+	/** Moves every block in memory to the unchecked table */
+	void flush (btcb::transaction const &);
+	void clear (btcb::transaction const &);
+	/** Blocks in memory */
+	size_t size ();
+	/** Blocks in memory and in the unchecked table */
+	size_t count (btcb::transaction const &);
+	/** Arrival time of the oldest block in memory, or now if there are none */
+	std::chrono::steady_clock::time_point oldest ();
+	/** Blocks that fit in the configured memory cap */
+	size_t max_size () const;
+	/** Estimated memory per entry, the largest block type plus index and allocation overhead */
+	static size_t constexpr entry_size = sizeof (btcb::state_block) + sizeof (btcb::unchecked_info) + 128;
+	static std::chrono::seconds constexpr cleanup_interval = std::chrono::seconds (60);
+
+private:
+	btcb::node & node;
+	std::mutex mutex;
+	boost::multi_index_container<
+	btcb::unchecked_info,
+	boost::multi_index::indexed_by<
+	boost::multi_index::sequenced<>,
+	boost::multi_index::ordered_unique<boost::multi_index::const_mem_fun<btcb::unchecked_info, std::pair<btcb::block_hash, btcb::block_hash>, &btcb::unchecked_info::key>>,
+	boost::multi_index::hashed_non_unique<boost::multi_index::member<btcb::unchecked_info, btcb::block_hash, &btcb::unchecked_info::hash>>>>
+	entries;
+};
+}
@@ -99,3 +99,105 @@ void btcb::vote_generator::run ()
 		}
 	}
 }
+
+size_t constexpr btcb::verified_vote_cache::shard_count;
+
+btcb::verified_vote_cache::verified_vote_cache (size_t max_a) :
+shard_max (std::max<size_t> (1, max_a / shard_count))
+{
+}
+
+btcb::verified_vote_cache::shard & btcb::verified_vote_cache::shard_get (btcb::uint256_union const & hash_a)
+{
+	return shards[hash_a.qwords[0] % shard_count];
+}
+
+bool btcb::verified_vote_cache::exists (btcb::uint256_union const & hash_a)
+{
+	auto & shard_l (shard_get (hash_a));
+	std::lock_guard<std::mutex> lock (shard_l.mutex);
+	return shard_l.hashes.get<1> ().find (hash_a) != shard_l.hashes.get<1> ().end ();
+}
+
+void btcb::verified_vote_cache::insert (btcb::uint256_union const & hash_a)
+{
+	auto & shard_l (shard_get (hash_a));
+	std::lock_guard<std::mutex> lock (shard_l.mutex);
+	if (shard_l.hashes.push_back (hash_a).second && shard_l.hashes.size () > shard_max)
+	{
+		shard_l.hashes.pop_front ();
+	}
+}
+
+size_t btcb::verified_vote_cache::size ()
+{
+	size_t result (0);
+	for (auto & shard_l : shards)
+	{
+		std::lock_guard<std::mutex> lock (shard_l.mutex);
+		result += shard_l.hashes.size ();
+	}
+	return result;
+}
+
+std::chrono::seconds constexpr btcb::local_vote_cache::validity;
+size_t constexpr btcb::local_vote_cache::max_size;
+
+btcb::local_vote_cache::local_vote_cache (btcb::node & node_a) :
+node (node_a)
+{
+}
+
+std::pair<std::shared_ptr<btcb::vote>, std::shared_ptr<std::vector<uint8_t>>> btcb::local_vote_cache::vote (btcb::transaction const & transaction_a, btcb::account const & account_a, btcb::raw_key const & prv_a, btcb::block_hash const & hash_a)
+{
+	std::pair<std::shared_ptr<btcb::vote>, std::shared_ptr<std::vector<uint8_t>>> result;
+	btcb::local_vote_cache::key key_l (account_a, hash_a);
+	std::unique_lock<std::mutex> lock (mutex);
+	while (generating.find (key_l) != generating.end ())
+	{
+		condition.wait (lock);
+	}
+	auto now (std::chrono::steady_clock::now ());
+	purge (now);
+	auto existing (entries.get<1> ().find (key_l));
+	if (existing != entries.get<1> ().end ())
+	{
+		result = std::make_pair (existing->vote, existing->bytes);
+		lock.unlock ();
+		node.stats.inc (btcb::stat::type::vote_cache, btcb::stat::detail::hit, btcb::stat::dir::out);
+	}
+	else
+	{
+		generating.insert (key_l);
+		lock.unlock ();
+		auto vote_l (node.store.vote_generate (transaction_a, account_a, prv_a, std::vector<btcb::block_hash> (1, hash_a)));
+		btcb::confirm_ack confirm (vote_l);
+		result = std::make_pair (vote_l, confirm.to_bytes ());
+		lock.lock ();
+		generating.erase (key_l);
+		entries.push_back (btcb::local_vote_cache::entry{ now, key_l, result.first, result.second });
+		if (entries.size () > max_size)
+		{
+			entries.pop_front ();
+		}
+		lock.unlock ();
+		condition.notify_all ();
+		node.stats.inc (btcb::stat::type::vote_cache, btcb::stat::detail::miss, btcb::stat::dir::out);
+	}
+	return result;
+}
+
+void btcb::local_vote_cache::purge (std::chrono::steady_clock::time_point const & now_a)
+{
+	assert (!mutex.try_lock ());
+	while (!entries.empty () && entries.front ().time + validity < now_a)
+	{
+		entries.pop_front ();
+	}
+}
+
+size_t btcb::local_vote_cache::size ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	return entries.size ();
+}
@@ -1,16 +1,26 @@
 #pragma once
 
 #include <btcb/lib/numbers.hpp>
+#include <btcb/secure/common.hpp>
 
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/identity.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index_container.hpp>
 #include <boost/thread.hpp>
 
+#include <array>
 #include <condition_variable>
 #include <deque>
 #include <mutex>
+#include <set>
 
 namespace btcb
 {
 class node;
+class transaction;
 class vote_generator
 {
 public:
@@ -30,4 +40,71 @@ private:
 	bool started;
 	boost::thread thread;
 };
+/**
+ * Full hashes of votes whose signatures were verified recently.
+ * Split in to shards with their own locks so network threads can check votes concurrently, each shard evicts its oldest entry once full.
+ */
+class verified_vote_cache
+{
+public:
+	verified_vote_cache (size_t = 64 * 1024);
+	bool exists (btcb::uint256_union const &);
+	void insert (btcb::uint256_union const &);
+	size_t size ();
+	static size_t constexpr shard_count = 16;
+
+private:
+	class shard
+	{
+	public:
+		std::mutex mutex;
+		boost::multi_index_container<
+		btcb::uint256_union,
+		boost::multi_index::indexed_by<
+		boost::multi_index::sequenced<>,
+		boost::multi_index::hashed_unique<boost::multi_index::identity<btcb::uint256_union>>>>
+		hashes;
+	};
+	btcb::verified_vote_cache::shard & shard_get (btcb::uint256_union const &);
+	size_t const shard_max;
+	std::array<btcb::verified_vote_cache::shard, shard_count> shards;
+};
+/**
+ * Votes signed by local representatives in reply to confirm_req, along with their serialized confirm_ack.
+ * Requests for a block voted on within the validity window get the same vote back instead of a new signature and sequence number,
+ * and concurrent requests for the same representative and block wait for a single signature.
+ */
+class local_vote_cache
+{
+public:
+	local_vote_cache (btcb::node &);
+	/** Returns a vote by \p account_a for \p hash_a and the confirm_ack bytes carrying it */
+	std::pair<std::shared_ptr<btcb::vote>, std::shared_ptr<std::vector<uint8_t>>> vote (btcb::transaction const &, btcb::account const & account_a, btcb::raw_key const &, btcb::block_hash const & hash_a);
+	size_t size ();
+	static std::chrono::seconds constexpr validity = std::chrono::seconds (10);
+	static size_t constexpr max_size = 16 * 1024;
+
+private:
+	using key = std::pair<btcb::account, btcb::block_hash>;
+	class entry
+	{
+	public:
+		std::chrono::steady_clock::time_point time;
+		btcb::local_vote_cache::key key;
+		std::shared_ptr<btcb::vote> vote;
+		std::shared_ptr<std::vector<uint8_t>> bytes;
+	};
+	void purge (std::chrono::steady_clock::time_point const &);
+	btcb::node & node;
+	std::mutex mutex;
+	std::condition_variable condition;
+	boost::multi_index_container<
+	btcb::local_vote_cache::entry,
+	boost::multi_index::indexed_by<
+	boost::multi_index::sequenced<>,
+	boost::multi_index::ordered_unique<boost::multi_index::member<btcb::local_vote_cache::entry, btcb::local_vote_cache::key, &btcb::local_vote_cache::entry::key>>>>
+	entries;
+	/** Keys whose vote is being signed outside the lock */
+	std::set<btcb::local_vote_cache::key> generating;
+};
 }
@@ -1227,15 +1227,11 @@ bool btcb::wallet::live ()
 void btcb::wallet::work_cache_blocking (btcb::account const & account_a, btcb::block_hash const & root_a)
 {
 	auto begin (std::chrono::steady_clock::now ());
-	auto work (wallets.node.work_generate_blocking (root_a));
+	auto difficulty (btcb::work_pool::publish_threshold);
+	// Cached work is only needed for a later block, requests for blocks being created go first
+	auto work (wallets.node.work_generate_blocking (root_a, difficulty, btcb::work_priority::precache));
 	if (wallets.node.config.logging.work_generation_time ())
 	{
-		/*
-		 * The difficulty parameter is the second parameter for `work_generate_blocking()`,
-		 * currently we don't supply one so we must fetch the default value.
-		 */
-		auto difficulty (btcb::work_pool::publish_threshold);
-
 		BOOST_LOG (wallets.node.log) << "Work generation for " << root_a.to_string () << ", with a difficulty of " << difficulty << " complete: " << (std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - begin).count ()) << " us";
 	}
 	auto transaction (wallets.tx_begin_write ());
@@ -874,7 +874,7 @@ std::string btcb_qt::status::text ()
 	{
 		auto transaction (wallet.wallet_m->wallets.node.store.tx_begin_read ());
 		auto size (wallet.wallet_m->wallets.node.store.block_count (transaction));
-		unchecked = wallet.wallet_m->wallets.node.store.unchecked_count (transaction);
+		unchecked = wallet.wallet_m->wallets.node.unchecked.count (transaction);
 		count_string = std::to_string (size.sum ());
 	}
 
@@ -163,9 +163,19 @@ btcb::uint128_t btcb::summation_visitor::compute_internal (btcb::summation_visit
 				}
 				else
 				{
-					auto block (store.block_get (transaction, current->balance_hash));
-					assert (block != nullptr);
-					block->visit (*this);
+					btcb::block_sideband sideband;
+					if (!store.block_sideband_get (transaction, current->balance_hash, sideband))
+					{
+						// The balance as of this block is stored with it, no need to walk further back
+						sum_add (sideband.balance.number ());
+						current->balance_hash = 0;
+					}
+					else
+					{
+						auto block (store.block_get (transaction, current->balance_hash));
+						assert (block != nullptr);
+						block->visit (*this);
+					}
 				}
 			}
 
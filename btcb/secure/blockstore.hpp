@@ -194,6 +194,12 @@ public:
 	virtual ~block_store () = default;
 	virtual void initialize (btcb::transaction const &, btcb::genesis const &) = 0;
 	virtual void block_put (btcb::transaction const &, btcb::block_hash const &, btcb::block const &, btcb::block_hash const & = btcb::block_hash (0), btcb::epoch version = btcb::epoch::epoch_0) = 0;
+	/** Stores the block with its sideband, the sideband's successor is written the same as above */
+	virtual void block_put (btcb::transaction const &, btcb::block_hash const &, btcb::block const &, btcb::block_sideband const &, btcb::epoch version = btcb::epoch::epoch_0) = 0;
+	/** Returns true if the block doesn't exist or was stored without a sideband */
+	virtual bool block_sideband_get (btcb::transaction const &, btcb::block_hash const &, btcb::block_sideband &) = 0;
+	/** Adds sidebands to blocks stored before the sideband existed, visiting at most count_a blocks per call including those which already have one. Returns true once every block has one */
+	virtual bool sideband_upgrade (btcb::transaction const &, size_t count_a) = 0;
 	virtual btcb::block_hash block_successor (btcb::transaction const &, btcb::block_hash const &) = 0;
 	virtual void block_successor_clear (btcb::transaction const &, btcb::block_hash const &) = 0;
 	virtual std::shared_ptr<btcb::block> block_get (btcb::transaction const &, btcb::block_hash const &) = 0;
@@ -254,6 +260,17 @@ public:
 	virtual btcb::store_iterator<btcb::account, btcb::uint128_union> representation_begin (btcb::transaction const &) = 0;
 	virtual btcb::store_iterator<btcb::account, btcb::uint128_union> representation_end () = 0;
 
+	virtual void delegator_put (btcb::transaction const &, btcb::account const &, btcb::account const &) = 0;
+	virtual void delegator_del (btcb::transaction const &, btcb::account const &, btcb::account const &) = 0;
+	/** Up to count_a accounts delegating to representative_a, in account order starting at start_a */
+	virtual std::vector<btcb::account> delegators_get (btcb::transaction const &, btcb::account const & representative_a, btcb::account const & start_a, size_t count_a) = 0;
+	virtual uint64_t delegators_count (btcb::transaction const &, btcb::account const &) = 0;
+
+	virtual void account_height_put (btcb::transaction const &, btcb::account const &, uint64_t, btcb::block_hash const &) = 0;
+	virtual void account_height_del (btcb::transaction const &, btcb::account const &, uint64_t) = 0;
+	/** Hash of the block at height_a in account_a's chain, the open block is at height 1. Returns true if there's no such block */
+	virtual bool account_height_get (btcb::transaction const &, btcb::account const & account_a, uint64_t height_a, btcb::block_hash &) = 0;
+
 	virtual void unchecked_clear (btcb::transaction const &) = 0;
 	virtual void unchecked_put (btcb::transaction const &, btcb::unchecked_key const &, std::shared_ptr<btcb::block> const &) = 0;
 	virtual void unchecked_put (btcb::transaction const &, btcb::block_hash const &, std::shared_ptr<btcb::block> const &) = 0;
@@ -324,6 +324,63 @@ bool btcb::block_info::operator== (btcb::block_info const & other_a) const
 	return account == other_a.account && balance == other_a.balance;
 }
 
+size_t constexpr btcb::block_sideband::size;
+
+btcb::block_sideband::block_sideband () :
+successor (0),
+account (0),
+height (0),
+balance (0),
+timestamp (0)
+{
+}
+
+btcb::block_sideband::block_sideband (btcb::block_hash const & successor_a, btcb::account const & account_a, uint64_t height_a, btcb::amount const & balance_a, uint64_t timestamp_a) :
+successor (successor_a),
+account (account_a),
+height (height_a),
+balance (balance_a),
+timestamp (timestamp_a)
+{
+}
+
+void btcb::block_sideband::serialize (btcb::stream & stream_a) const
+{
+	// The successor comes first so it's at the same offset as in entries without a sideband
+	btcb::write (stream_a, successor.bytes);
+	btcb::write (stream_a, account.bytes);
+	btcb::write (stream_a, height);
+	btcb::write (stream_a, balance.bytes);
+	btcb::write (stream_a, timestamp);
+}
+
+bool btcb::block_sideband::deserialize (btcb::stream & stream_a)
+{
+	auto error (btcb::read (stream_a, successor.bytes));
+	if (!error)
+	{
+		error = btcb::read (stream_a, account.bytes);
+		if (!error)
+		{
+			error = btcb::read (stream_a, height);
+			if (!error)
+			{
+				error = btcb::read (stream_a, balance.bytes);
+				if (!error)
+				{
+					error = btcb::read (stream_a, timestamp);
+				}
+			}
+		}
+	}
+	return error;
+}
+
+bool btcb::block_sideband::operator== (btcb::block_sideband const & other_a) const
+{
+	return successor == other_a.successor && account == other_a.account && height == other_a.height && balance == other_a.balance && timestamp == other_a.timestamp;
+}
+
 bool btcb::vote::operator== (btcb::vote const & other_a) const
 {
 	auto blocks_equal (true);
@@ -510,8 +567,8 @@ btcb::uint256_union btcb::vote::full_hash () const
 	blake2b_state state;
 	blake2b_init (&state, sizeof (result.bytes));
 	blake2b_update (&state, hash ().bytes.data (), sizeof (hash ().bytes));
-	blake2b_update (&state, account.bytes.data (), sizeof (account.bytes.data ()));
-	blake2b_update (&state, signature.bytes.data (), sizeof (signature.bytes.data ()));
+	blake2b_update (&state, account.bytes.data (), sizeof (account.bytes));
+	blake2b_update (&state, signature.bytes.data (), sizeof (signature.bytes));
 	blake2b_final (&state, result.bytes.data (), sizeof (result.bytes));
 	return result;
 }
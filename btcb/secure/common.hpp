@@ -115,6 +115,10 @@ public:
 };
 // Internally unchecked_key is equal to pending_key (2x uint256_union)
 using unchecked_key = pending_key;
+// Internally delegator_key is equal to pending_key, (representative, delegator)
+using delegator_key = pending_key;
+// Internally account_height_key is equal to pending_key, (account, height as a big endian btcb::uint256_union)
+using account_height_key = pending_key;
 
 class block_info
 {
@@ -127,6 +131,25 @@ public:
 	btcb::account account;
 	btcb::amount balance;
 };
+/**
+ * Fixed size metadata stored after each block: its successor, the account it belongs to, its height in that chain,
+ * the account balance as of the block and the local time it was stored, 0 if unknown
+ */
+class block_sideband
+{
+public:
+	block_sideband ();
+	block_sideband (btcb::block_hash const &, btcb::account const &, uint64_t, btcb::amount const &, uint64_t);
+	void serialize (btcb::stream &) const;
+	bool deserialize (btcb::stream &);
+	bool operator== (btcb::block_sideband const &) const;
+	static size_t constexpr size = sizeof (btcb::block_hash) + sizeof (btcb::account) + sizeof (uint64_t) + sizeof (btcb::amount) + sizeof (uint64_t);
+	btcb::block_hash successor;
+	btcb::account account;
+	uint64_t height;
+	btcb::amount balance;
+	uint64_t timestamp;
+};
 class block_counts
 {
 public:
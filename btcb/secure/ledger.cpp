@@ -89,8 +89,8 @@ public:
 		auto balance (ledger.balance (transaction, block_a.hashables.previous));
 		ledger.store.representation_add (transaction, representative, balance);
 		ledger.store.representation_add (transaction, hash, 0 - balance);
-		ledger.store.block_del (transaction, hash);
 		ledger.change_latest (transaction, account, block_a.hashables.previous, representative, info.balance, info.block_count - 1);
+		ledger.store.block_del (transaction, hash);
 		ledger.store.frontier_del (transaction, hash);
 		ledger.store.frontier_put (transaction, block_a.hashables.previous, account);
 		ledger.store.block_successor_clear (transaction, block_a.hashables.previous);
@@ -291,7 +291,7 @@ void ledger_processor::state_block_impl (btcb::state_block const & block_a)
 				{
 					ledger.stats.inc (btcb::stat::type::ledger, btcb::stat::detail::state_block);
 					result.state_is_send = is_send;
-					ledger.store.block_put (transaction, hash, block_a, 0, epoch);
+					ledger.store.block_put (transaction, hash, block_a, btcb::block_sideband (0, block_a.hashables.account, info.block_count + 1, block_a.hashables.balance, btcb::seconds_since_epoch ()), epoch);
 
 					if (!info.rep_block.is_zero ())
 					{
@@ -374,7 +374,7 @@ void ledger_processor::epoch_block_impl (btcb::state_block const & block_a)
 							ledger.stats.inc (btcb::stat::type::ledger, btcb::stat::detail::epoch_block);
 							result.account = block_a.hashables.account;
 							result.amount = 0;
-							ledger.store.block_put (transaction, hash, block_a, 0, btcb::epoch::epoch_1);
+							ledger.store.block_put (transaction, hash, block_a, btcb::block_sideband (0, block_a.hashables.account, info.block_count + 1, info.balance, btcb::seconds_since_epoch ()), btcb::epoch::epoch_1);
 							ledger.change_latest (transaction, block_a.hashables.account, hash, hash, info.balance, info.block_count + 1, true, btcb::epoch::epoch_1);
 							if (!ledger.store.frontier_get (transaction, info.head).is_zero ())
 							{
@@ -413,7 +413,7 @@ void ledger_processor::change_block (btcb::change_block const & block_a)
 					result.code = validate_message (account, hash, block_a.signature) ? btcb::process_result::bad_signature : btcb::process_result::progress; // Is this block signed correctly (Malformed)
 					if (result.code == btcb::process_result::progress)
 					{
-						ledger.store.block_put (transaction, hash, block_a);
+						ledger.store.block_put (transaction, hash, block_a, btcb::block_sideband (0, account, info.block_count + 1, info.balance, btcb::seconds_since_epoch ()));
 						auto balance (ledger.balance (transaction, block_a.hashables.previous));
 						ledger.store.representation_add (transaction, hash, balance);
 						ledger.store.representation_add (transaction, info.rep_block, 0 - balance);
@@ -460,7 +460,7 @@ void ledger_processor::send_block (btcb::send_block const & block_a)
 						{
 							auto amount (info.balance.number () - block_a.hashables.balance.number ());
 							ledger.store.representation_add (transaction, info.rep_block, 0 - amount);
-							ledger.store.block_put (transaction, hash, block_a);
+							ledger.store.block_put (transaction, hash, block_a, btcb::block_sideband (0, account, info.block_count + 1, block_a.hashables.balance, btcb::seconds_since_epoch ()));
 							ledger.change_latest (transaction, account, hash, info.rep_block, block_a.hashables.balance, info.block_count + 1);
 							ledger.store.pending_put (transaction, btcb::pending_key (block_a.hashables.destination, hash), { account, amount, btcb::epoch::epoch_0 });
 							ledger.store.frontier_del (transaction, block_a.hashables.previous);
@@ -519,7 +519,7 @@ void ledger_processor::receive_block (btcb::receive_block const & block_a)
 										auto error (ledger.store.account_get (transaction, pending.source, source_info));
 										assert (!error);
 										ledger.store.pending_del (transaction, key);
-										ledger.store.block_put (transaction, hash, block_a);
+										ledger.store.block_put (transaction, hash, block_a, btcb::block_sideband (0, account, info.block_count + 1, new_balance, btcb::seconds_since_epoch ()));
 										ledger.change_latest (transaction, account, hash, info.rep_block, new_balance, info.block_count + 1);
 										ledger.store.representation_add (transaction, info.rep_block, pending.amount.number ());
 										ledger.store.frontier_del (transaction, block_a.hashables.previous);
@@ -575,7 +575,7 @@ void ledger_processor::open_block (btcb::open_block const & block_a)
 								auto error (ledger.store.account_get (transaction, pending.source, source_info));
 								assert (!error);
 								ledger.store.pending_del (transaction, key);
-								ledger.store.block_put (transaction, hash, block_a);
+								ledger.store.block_put (transaction, hash, block_a, btcb::block_sideband (0, block_a.hashables.account, info.block_count + 1, pending.amount, btcb::seconds_since_epoch ()));
 								ledger.change_latest (transaction, block_a.hashables.account, hash, hash, pending.amount.number (), info.block_count + 1);
 								ledger.store.representation_add (transaction, hash, pending.amount.number ());
 								ledger.store.frontier_put (transaction, hash, block_a.hashables.account);
@@ -614,7 +614,9 @@ bool btcb::shared_ptr_block_hash::operator() (std::shared_ptr<btcb::block> const
 btcb::ledger::ledger (btcb::block_store & store_a, btcb::stat & stat_a, btcb::uint256_union const & epoch_link_a, btcb::account const & epoch_signer_a) :
 store (store_a),
 stats (stat_a),
+bootstrap_weight_max_blocks (0),
 check_bootstrap_weights (true),
+bootstrap_weight_remaining (0),
 epoch_link (epoch_link_a),
 epoch_signer (epoch_signer_a)
 {
@@ -661,6 +663,27 @@ btcb::process_return btcb::ledger::process (btcb::transaction const & transactio
 {
 	ledger_processor processor (*this, transaction_a, valid_signature);
 	block_a.visit (processor);
+	if (processor.result.code == btcb::process_result::progress && check_bootstrap_weights.load ())
+	{
+		// Counting blocks here instead of in weight () keeps vote tallies from hitting the store. Rollbacks only take the ledger further from the limit
+		// so the count is repeated just once enough blocks were added to reach it
+		if (bootstrap_weight_remaining > 0)
+		{
+			--bootstrap_weight_remaining;
+		}
+		if (bootstrap_weight_remaining == 0)
+		{
+			auto count (store.block_count (transaction_a).sum ());
+			if (count >= bootstrap_weight_max_blocks)
+			{
+				check_bootstrap_weights = false;
+			}
+			else
+			{
+				bootstrap_weight_remaining = bootstrap_weight_max_blocks - count;
+			}
+		}
+	}
 	return processor.result;
 }
 
@@ -764,18 +787,10 @@ btcb::uint128_t btcb::ledger::weight (btcb::transaction const & transaction_a, b
 {
 	if (check_bootstrap_weights.load ())
 	{
-		auto blocks = store.block_count (transaction_a);
-		if (blocks.sum () < bootstrap_weight_max_blocks)
+		auto weight = bootstrap_weights.find (account_a);
+		if (weight != bootstrap_weights.end ())
 		{
-			auto weight = bootstrap_weights.find (account_a);
-			if (weight != bootstrap_weights.end ())
-			{
-				return weight->second;
-			}
-		}
-		else
-		{
-			check_bootstrap_weights = false;
+			return weight->second;
 		}
 	}
 	return store.representation_get (transaction_a, account_a);
@@ -801,32 +816,41 @@ void btcb::ledger::rollback (btcb::transaction const & transaction_a, btcb::bloc
 btcb::account btcb::ledger::account (btcb::transaction const & transaction_a, btcb::block_hash const & hash_a)
 {
 	btcb::account result;
-	auto hash (hash_a);
-	btcb::block_hash successor (1);
-	btcb::block_info block_info;
-	auto block (store.block_get (transaction_a, hash));
-	assert (block);
-	while (!successor.is_zero () && block->type () != btcb::block_type::state && store.block_info_get (transaction_a, successor, block_info))
-	{
-		successor = store.block_successor (transaction_a, hash);
-		if (!successor.is_zero ())
-		{
-			hash = successor;
-			block = store.block_get (transaction_a, hash);
-		}
-	}
-	if (block->type () == btcb::block_type::state)
+	btcb::block_sideband sideband;
+	if (!store.block_sideband_get (transaction_a, hash_a, sideband))
 	{
-		auto state_block (dynamic_cast<btcb::state_block *> (block.get ()));
-		result = state_block->hashables.account;
-	}
-	else if (successor.is_zero ())
-	{
-		result = store.frontier_get (transaction_a, hash);
+		result = sideband.account;
 	}
 	else
 	{
-		result = block_info.account;
+		// Stored before sidebands and not upgraded yet, walk forward to a block that identifies the account
+		auto hash (hash_a);
+		btcb::block_hash successor (1);
+		btcb::block_info block_info;
+		auto block (store.block_get (transaction_a, hash));
+		assert (block);
+		while (!successor.is_zero () && block->type () != btcb::block_type::state && store.block_info_get (transaction_a, successor, block_info))
+		{
+			successor = store.block_successor (transaction_a, hash);
+			if (!successor.is_zero ())
+			{
+				hash = successor;
+				block = store.block_get (transaction_a, hash);
+			}
+		}
+		if (block->type () == btcb::block_type::state)
+		{
+			auto state_block (dynamic_cast<btcb::state_block *> (block.get ()));
+			result = state_block->hashables.account;
+		}
+		else if (successor.is_zero ())
+		{
+			result = store.frontier_get (transaction_a, hash);
+		}
+		else
+		{
+			result = block_info.account;
+		}
 	}
 	assert (!result.is_zero ());
 	return result;
@@ -949,6 +973,8 @@ void btcb::ledger::change_latest (btcb::transaction const & transaction_a, btcb:
 {
 	btcb::account_info info;
 	auto exists (!store.account_get (transaction_a, account_a, info));
+	uint64_t old_count (exists ? info.block_count : 0);
+	btcb::block_hash old_rep_block (exists ? info.rep_block : btcb::block_hash (0));
 	if (exists)
 	{
 		checksum_update (transaction_a, info.head);
@@ -980,10 +1006,42 @@ void btcb::ledger::change_latest (btcb::transaction const & transaction_a, btcb:
 			store.block_info_put (transaction_a, hash_a, block_info);
 		}
 		checksum_update (transaction_a, hash_a);
+		// Representatives are only looked up when the rep block changed, most blocks keep it
+		if (!exists || old_rep_block != rep_block_a)
+		{
+			auto representative_l (store.block_get (transaction_a, rep_block_a)->representative ());
+			if (exists)
+			{
+				auto old_representative (store.block_get (transaction_a, old_rep_block)->representative ());
+				if (representative_l != old_representative)
+				{
+					store.delegator_del (transaction_a, old_representative, account_a);
+					store.delegator_put (transaction_a, representative_l, account_a);
+				}
+			}
+			else
+			{
+				store.delegator_put (transaction_a, representative_l, account_a);
+			}
+		}
+		// Blocks are appended or rolled back one at a time, only the height of the head changes
+		if (block_count_a > old_count)
+		{
+			store.account_height_put (transaction_a, account_a, block_count_a, hash_a);
+		}
+		else if (block_count_a < old_count)
+		{
+			store.account_height_del (transaction_a, account_a, old_count);
+		}
 	}
 	else
 	{
 		store.account_del (transaction_a, account_a);
+		if (exists)
+		{
+			store.delegator_del (transaction_a, store.block_get (transaction_a, old_rep_block)->representative (), account_a);
+			store.account_height_del (transaction_a, account_a, old_count);
+		}
 	}
 }
 
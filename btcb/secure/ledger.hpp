@@ -50,7 +50,10 @@ public:
 	btcb::stat & stats;
 	std::unordered_map<btcb::account, btcb::uint128_t> bootstrap_weights;
 	uint64_t bootstrap_weight_max_blocks;
+	// Cleared by process () once the ledger holds bootstrap_weight_max_blocks blocks
 	std::atomic<bool> check_bootstrap_weights;
+	// Blocks process () has to add before the ledger could hold bootstrap_weight_max_blocks, blocks are only counted when this reaches zero
+	uint64_t bootstrap_weight_remaining;
 	btcb::uint256_union epoch_link;
 	btcb::account epoch_signer;
 };
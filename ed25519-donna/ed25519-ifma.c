@@ -0,0 +1,617 @@
+/*
+	Ed25519 signature checks for x86-64 CPUs with AVX-512 IFMA, eight signatures at a time.
+
+	Each 64 bit lane of a 512 bit register holds a limb of a different signature, so the field arithmetic is donna's
+	5 x 51 bit representation with the 52 bit multiply-accumulate instructions doing the products. Every signature is
+	checked exactly like ed25519_sign_open: [S]B - [H(R,A,m)]A is computed and its encoding compared with R.
+	Points are added with the same complete formulas as ed25519-donna-impl-base.h.
+
+	Only built with GCC compatible compilers targeting x86-64, callers check that the CPU has AVX-512 IFMA.
+*/
+
+#if defined(__GNUC__) && defined(__x86_64__)
+
+#include "ed25519-donna.h"
+#include "ed25519.h"
+#include "ed25519-hash.h"
+
+#include <immintrin.h>
+
+#if !defined(ED25519_64BIT)
+#error "ed25519-ifma.c shares donna's 64 bit field element layout"
+#endif
+
+#define IFMA_FN static inline __attribute__ ((target ("avx512f,avx512ifma")))
+#define IFMA_LANES 8
+
+/* [1]B .. [8]B for the fixed window over S, {ysubx, xaddy, t2d} */
+static const ge25519_niels ge25519_niels_base_multiples_1_8[8] = {
+	{{0x00003905d740913e,0x0000ba2817d673a2,0x00023e2827f4e67c,0x000133d2e0c21a34,0x00044fd2f9298f81},{0x000493c6f58c3b85,0x0000df7181c325f7,0x0000f50b0b3e4cb7,0x0005329385a44c32,0x00007cf9d3a33d4b},{0x00011205877aaa68,0x000479955893d579,0x00050d66309b67a0,0x0002d42d0dbee5ee,0x0006f117b689f0c6}},
+	{{0x0001a56042b4d5a8,0x000189cc159ed153,0x0005b8deaa3cae04,0x0002aaf04f11b5d8,0x0006bb595a669c92},{0x0004e7fc933c71d7,0x0002cf41feb6b244,0x0007581c0a7d1a76,0x0007172d534d32f0,0x000590c063fa87d2},{0x0002a8b3a59b7a5f,0x0003abb359ef087f,0x0004f5a8c4db05af,0x0005b9a807d04205,0x000701af5b13ea50}},
+	{{0x00011fe8a4fcd265,0x0007bcb8374faacc,0x00052f5af4ef4d4f,0x0005314098f98d10,0x0002ab91587555bd},{0x0005b0a84cee9730,0x00061d10c97155e4,0x0004059cc8096a10,0x00047a608da8014f,0x0007a164e1b9a80f},{0x0006933f0dd0d889,0x00044386bb4c4295,0x0003cb6d3162508c,0x00026368b872a2c6,0x0005a2826af12b9b}},
+	{{0x0006050a056818bf,0x00062acc1f5532bf,0x00028141ccc9fa25,0x00024d61f471e683,0x00027933f4c7445a},{0x000351b98efc099f,0x00068fbfa4a7050e,0x00042a49959d971b,0x000393e51a469efd,0x000680e910321e58},{0x0003fbe9c476ff09,0x0000af6b982e4b42,0x0000ad1251ba78e5,0x000715aeedee7c88,0x0007f9d0cbf63553}},
+	{{0x000182c3a447d6ba,0x00022964e536eff2,0x000192821f540053,0x0002f9f19e788e5c,0x000154a7e73eb1b5},{0x0002bc4408a5bb33,0x000078ebdda05442,0x0002ffb112354123,0x000375ee8df5862d,0x0002945ccf146e20},{0x0003dbf1812a8285,0x0000fa17ba3f9797,0x0006f69cb49c3820,0x00034d5a0db3858d,0x00043aabe696b3bb}},
+	{{0x000006b67b7d8ca4,0x000084fa44e72933,0x0001154ee55d6f8a,0x0004425d842e7390,0x00038b64c41ae417},{0x0004eeeb77157131,0x0001201915f10741,0x0001669cda6c9c56,0x00045ec032db346d,0x00051e57bb6a2cc3},{0x0004326702ea4b71,0x00006834376030b5,0x0000ef0512f9c380,0x0000f1a9f2512584,0x00010b8e91a9f0d6}},
+	{{0x00072c9aaa3221b1,0x000267774474f74d,0x000064b0e9b28085,0x0003f04ef53b27c9,0x0001d6edd5d2e531},{0x00025cd0944ea3bf,0x00075673b81a4d63,0x000150b925d1c0d4,0x00013f38d9294114,0x000461bea69283c9},{0x00036dc801b8b3a2,0x0000e0a7d4935e30,0x0001deb7cecc0d7d,0x000053a94e20dd2c,0x0007a9fbb1c6a0f9}},
+	{{0x00075dedf39234d9,0x00001c36ab1f3c54,0x0000f08fee58f5da,0x0000e19613a0d637,0x0003a9024a1320e0},{0x0007596604dd3e8f,0x0006fc510e058b36,0x0003670c8db2cc0d,0x000297d899ce332f,0x0000915e76061bce},{0x0001f5d9c9a2911a,0x0007117994fafcf8,0x0002d8a8cae28dc5,0x00074ab1b2090c87,0x00026907c5c2ecc4}}
+};
+
+/*
+	Field elements, one per lane. Limbs are kept below 2^52 so they're valid multiplier inputs, every operation ends with
+	a carry round that brings them back under 2^51 + 2^17.
+*/
+
+typedef struct fe8_t {
+	__m512i v[5];
+} fe8;
+
+IFMA_FN __m512i
+fe8_mul19(__m512i x) {
+	return _mm512_add_epi64(_mm512_add_epi64(_mm512_slli_epi64(x, 4), _mm512_slli_epi64(x, 1)), x);
+}
+
+/* r = t with one parallel carry round, limbs of t below 2^62 */
+IFMA_FN void
+fe8_carry(fe8 *r, __m512i t0, __m512i t1, __m512i t2, __m512i t3, __m512i t4) {
+	const __m512i mask = _mm512_set1_epi64(0x7ffffffffffff);
+	__m512i c0 = _mm512_srli_epi64(t0, 51);
+	__m512i c1 = _mm512_srli_epi64(t1, 51);
+	__m512i c2 = _mm512_srli_epi64(t2, 51);
+	__m512i c3 = _mm512_srli_epi64(t3, 51);
+	__m512i c4 = _mm512_srli_epi64(t4, 51);
+	r->v[0] = _mm512_add_epi64(_mm512_and_si512(t0, mask), fe8_mul19(c4));
+	r->v[1] = _mm512_add_epi64(_mm512_and_si512(t1, mask), c0);
+	r->v[2] = _mm512_add_epi64(_mm512_and_si512(t2, mask), c1);
+	r->v[3] = _mm512_add_epi64(_mm512_and_si512(t3, mask), c2);
+	r->v[4] = _mm512_add_epi64(_mm512_and_si512(t4, mask), c3);
+}
+
+IFMA_FN void
+fe8_copy(fe8 *r, const fe8 *a) {
+	*r = *a;
+}
+
+IFMA_FN void
+fe8_add(fe8 *r, const fe8 *a, const fe8 *b) {
+	fe8_carry(r,
+		_mm512_add_epi64(a->v[0], b->v[0]),
+		_mm512_add_epi64(a->v[1], b->v[1]),
+		_mm512_add_epi64(a->v[2], b->v[2]),
+		_mm512_add_epi64(a->v[3], b->v[3]),
+		_mm512_add_epi64(a->v[4], b->v[4]));
+}
+
+/* r = a - b + 4p, the multiple of p is larger than any limb of b */
+IFMA_FN void
+fe8_sub(fe8 *r, const fe8 *a, const fe8 *b) {
+	const __m512i fourp0 = _mm512_set1_epi64(0x1fffffffffffb4);
+	const __m512i fourp1234 = _mm512_set1_epi64(0x1ffffffffffffc);
+	fe8_carry(r,
+		_mm512_sub_epi64(_mm512_add_epi64(a->v[0], fourp0), b->v[0]),
+		_mm512_sub_epi64(_mm512_add_epi64(a->v[1], fourp1234), b->v[1]),
+		_mm512_sub_epi64(_mm512_add_epi64(a->v[2], fourp1234), b->v[2]),
+		_mm512_sub_epi64(_mm512_add_epi64(a->v[3], fourp1234), b->v[3]),
+		_mm512_sub_epi64(_mm512_add_epi64(a->v[4], fourp1234), b->v[4]));
+}
+
+/*
+	Products of limbs below 2^52 are split in to their low and high 52 bits. The high halves are 2^52 = 2 * 2^51 up so
+	they're doubled in to the next limb, then limbs 5 to 9 are folded back with 2^255 = 19.
+*/
+IFMA_FN void
+fe8_reduce_product(fe8 *r, __m512i *l, __m512i *h) {
+	__m512i t[10];
+	int i;
+	t[0] = l[0];
+	for (i = 1; i < 10; i++)
+		t[i] = _mm512_add_epi64(l[i], _mm512_slli_epi64(h[i - 1], 1));
+	fe8_carry(r,
+		_mm512_add_epi64(t[0], fe8_mul19(t[5])),
+		_mm512_add_epi64(t[1], fe8_mul19(t[6])),
+		_mm512_add_epi64(t[2], fe8_mul19(t[7])),
+		_mm512_add_epi64(t[3], fe8_mul19(t[8])),
+		_mm512_add_epi64(t[4], fe8_mul19(t[9])));
+}
+
+IFMA_FN void
+fe8_mul(fe8 *r, const fe8 *a, const fe8 *b) {
+	__m512i l[10], h[10];
+	int i;
+	for (i = 0; i < 10; i++) {
+		l[i] = _mm512_setzero_si512();
+		h[i] = _mm512_setzero_si512();
+	}
+	#define fe8_mul_row(i) \
+		l[i + 0] = _mm512_madd52lo_epu64(l[i + 0], a->v[i], b->v[0]); h[i + 0] = _mm512_madd52hi_epu64(h[i + 0], a->v[i], b->v[0]); \
+		l[i + 1] = _mm512_madd52lo_epu64(l[i + 1], a->v[i], b->v[1]); h[i + 1] = _mm512_madd52hi_epu64(h[i + 1], a->v[i], b->v[1]); \
+		l[i + 2] = _mm512_madd52lo_epu64(l[i + 2], a->v[i], b->v[2]); h[i + 2] = _mm512_madd52hi_epu64(h[i + 2], a->v[i], b->v[2]); \
+		l[i + 3] = _mm512_madd52lo_epu64(l[i + 3], a->v[i], b->v[3]); h[i + 3] = _mm512_madd52hi_epu64(h[i + 3], a->v[i], b->v[3]); \
+		l[i + 4] = _mm512_madd52lo_epu64(l[i + 4], a->v[i], b->v[4]); h[i + 4] = _mm512_madd52hi_epu64(h[i + 4], a->v[i], b->v[4]);
+	fe8_mul_row(0)
+	fe8_mul_row(1)
+	fe8_mul_row(2)
+	fe8_mul_row(3)
+	fe8_mul_row(4)
+	#undef fe8_mul_row
+	fe8_reduce_product(r, l, h);
+}
+
+/* The cross products are summed once and doubled before the squares are added */
+IFMA_FN void
+fe8_square(fe8 *r, const fe8 *a) {
+	__m512i l[10], h[10];
+	int i;
+	for (i = 0; i < 10; i++) {
+		l[i] = _mm512_setzero_si512();
+		h[i] = _mm512_setzero_si512();
+	}
+	#define fe8_square_cross(i, j) \
+		l[i + j] = _mm512_madd52lo_epu64(l[i + j], a->v[i], a->v[j]); h[i + j] = _mm512_madd52hi_epu64(h[i + j], a->v[i], a->v[j]);
+	fe8_square_cross(0, 1) fe8_square_cross(0, 2) fe8_square_cross(0, 3) fe8_square_cross(0, 4)
+	fe8_square_cross(1, 2) fe8_square_cross(1, 3) fe8_square_cross(1, 4)
+	fe8_square_cross(2, 3) fe8_square_cross(2, 4)
+	fe8_square_cross(3, 4)
+	for (i = 1; i < 8; i++) {
+		l[i] = _mm512_slli_epi64(l[i], 1);
+		h[i] = _mm512_slli_epi64(h[i], 1);
+	}
+	fe8_square_cross(0, 0) fe8_square_cross(1, 1) fe8_square_cross(2, 2) fe8_square_cross(3, 3) fe8_square_cross(4, 4)
+	#undef fe8_square_cross
+	fe8_reduce_product(r, l, h);
+}
+
+IFMA_FN void
+fe8_square_times(fe8 *r, const fe8 *a, int count) {
+	fe8_square(r, a);
+	while (--count)
+		fe8_square(r, r);
+}
+
+/* Every lane set to a */
+IFMA_FN void
+fe8_broadcast(fe8 *r, const bignum25519 a) {
+	int i;
+	for (i = 0; i < 5; i++)
+		r->v[i] = _mm512_set1_epi64((long long)a[i]);
+}
+
+/* Lane j set to a[j] */
+IFMA_FN void
+fe8_load(fe8 *r, bignum25519 a[IFMA_LANES]) {
+	uint64_t ALIGN(64) limbs[IFMA_LANES];
+	int i, j;
+	for (i = 0; i < 5; i++) {
+		for (j = 0; j < IFMA_LANES; j++)
+			limbs[j] = a[j][i];
+		r->v[i] = _mm512_load_si512(limbs);
+	}
+}
+
+/* a[j] set to lane j, the limbs are valid donna input */
+IFMA_FN void
+fe8_store(bignum25519 a[IFMA_LANES], const fe8 *r) {
+	uint64_t ALIGN(64) limbs[IFMA_LANES];
+	int i, j;
+	for (i = 0; i < 5; i++) {
+		_mm512_store_si512(limbs, r->v[i]);
+		for (j = 0; j < IFMA_LANES; j++)
+			a[j][i] = limbs[j];
+	}
+}
+
+/* Lanes in mask take b, the others a */
+IFMA_FN void
+fe8_blend(fe8 *r, __mmask8 mask, const fe8 *a, const fe8 *b) {
+	int i;
+	for (i = 0; i < 5; i++)
+		r->v[i] = _mm512_mask_blend_epi64(mask, a->v[i], b->v[i]);
+}
+
+/* Same chains as curve25519_pow_two5mtwo0_two250mtwo0, curve25519_recip and curve25519_pow_two252m3 */
+IFMA_FN void
+fe8_pow_two5mtwo0_two250mtwo0(fe8 *b) {
+	fe8 t0, c;
+	fe8_square_times(&t0, b, 5);
+	fe8_mul(b, &t0, b);
+	fe8_square_times(&t0, b, 10);
+	fe8_mul(&c, &t0, b);
+	fe8_square_times(&t0, &c, 20);
+	fe8_mul(&t0, &t0, &c);
+	fe8_square_times(&t0, &t0, 10);
+	fe8_mul(b, &t0, b);
+	fe8_square_times(&t0, b, 50);
+	fe8_mul(&c, &t0, b);
+	fe8_square_times(&t0, &c, 100);
+	fe8_mul(&t0, &t0, &c);
+	fe8_square_times(&t0, &t0, 50);
+	fe8_mul(b, &t0, b);
+}
+
+IFMA_FN void
+fe8_recip(fe8 *out, const fe8 *z) {
+	fe8 a, t0, b;
+	fe8_square_times(&a, z, 1);
+	fe8_square_times(&t0, &a, 2);
+	fe8_mul(&b, &t0, z);
+	fe8_mul(&a, &b, &a);
+	fe8_square_times(&t0, &a, 1);
+	fe8_mul(&b, &t0, &b);
+	fe8_pow_two5mtwo0_two250mtwo0(&b);
+	fe8_square_times(&b, &b, 5);
+	fe8_mul(out, &b, &a);
+}
+
+IFMA_FN void
+fe8_pow_two252m3(fe8 *out, const fe8 *z) {
+	fe8 b, c, t0;
+	fe8_square_times(&c, z, 1);
+	fe8_square_times(&t0, &c, 2);
+	fe8_mul(&b, &t0, z);
+	fe8_mul(&c, &b, &c);
+	fe8_square_times(&t0, &c, 1);
+	fe8_mul(&b, &t0, &b);
+	fe8_pow_two5mtwo0_two250mtwo0(&b);
+	fe8_square_times(&b, &b, 2);
+	fe8_mul(out, &b, z);
+}
+
+/*
+	Points, one per lane, with the formulas of ed25519-donna-impl-base.h. Adds take a per lane sign instead of signbit.
+*/
+
+typedef struct ge8_t {
+	fe8 x, y, z, t;
+} ge8;
+
+typedef ge8 ge8_p1p1;
+
+typedef struct ge8_pniels_t {
+	fe8 ysubx, xaddy, z, t2d;
+} ge8_pniels;
+
+typedef struct ge8_niels_t {
+	fe8 ysubx, xaddy, t2d;
+} ge8_niels;
+
+IFMA_FN void
+ge8_p1p1_to_partial(ge8 *r, const ge8 *p) {
+	fe8_mul(&r->x, &p->x, &p->t);
+	fe8_mul(&r->y, &p->y, &p->z);
+	fe8_mul(&r->z, &p->z, &p->t);
+}
+
+IFMA_FN void
+ge8_p1p1_to_full(ge8 *r, const ge8 *p) {
+	fe8_mul(&r->x, &p->x, &p->t);
+	fe8_mul(&r->y, &p->y, &p->z);
+	fe8_mul(&r->z, &p->z, &p->t);
+	fe8_mul(&r->t, &p->x, &p->y);
+}
+
+IFMA_FN void
+ge8_full_to_pniels(ge8_pniels *p, const ge8 *r, const fe8 *ec2d) {
+	fe8_sub(&p->ysubx, &r->y, &r->x);
+	fe8_add(&p->xaddy, &r->y, &r->x);
+	fe8_copy(&p->z, &r->z);
+	fe8_mul(&p->t2d, &r->t, ec2d);
+}
+
+IFMA_FN void
+ge8_add_p1p1(ge8 *r, const ge8 *p, const ge8 *q, const fe8 *ec2d) {
+	fe8 a, b, c, d, t, u;
+	fe8_sub(&a, &p->y, &p->x);
+	fe8_add(&b, &p->y, &p->x);
+	fe8_sub(&t, &q->y, &q->x);
+	fe8_add(&u, &q->y, &q->x);
+	fe8_mul(&a, &a, &t);
+	fe8_mul(&b, &b, &u);
+	fe8_mul(&c, &p->t, &q->t);
+	fe8_mul(&c, &c, ec2d);
+	fe8_mul(&d, &p->z, &q->z);
+	fe8_add(&d, &d, &d);
+	fe8_sub(&r->x, &b, &a);
+	fe8_add(&r->y, &b, &a);
+	fe8_add(&r->z, &d, &c);
+	fe8_sub(&r->t, &d, &c);
+}
+
+IFMA_FN void
+ge8_double_p1p1(ge8 *r, const ge8 *p) {
+	fe8 a, b, c;
+	fe8_square(&a, &p->x);
+	fe8_square(&b, &p->y);
+	fe8_square(&c, &p->z);
+	fe8_add(&c, &c, &c);
+	fe8_add(&r->x, &p->x, &p->y);
+	fe8_square(&r->x, &r->x);
+	fe8_add(&r->y, &b, &a);
+	fe8_sub(&r->z, &b, &a);
+	fe8_sub(&r->x, &r->x, &r->y);
+	fe8_sub(&r->t, &c, &r->z);
+}
+
+/* Lanes in sign add -q */
+IFMA_FN void
+ge8_pnielsadd_p1p1(ge8 *r, const ge8 *p, const ge8_pniels *q, __mmask8 sign) {
+	fe8 a, b, c, qa, qb, plus, minus;
+	fe8_sub(&a, &p->y, &p->x);
+	fe8_add(&b, &p->y, &p->x);
+	fe8_blend(&qa, sign, &q->ysubx, &q->xaddy);
+	fe8_blend(&qb, sign, &q->xaddy, &q->ysubx);
+	fe8_mul(&a, &a, &qa);
+	fe8_mul(&r->x, &b, &qb);
+	fe8_add(&r->y, &r->x, &a);
+	fe8_sub(&r->x, &r->x, &a);
+	fe8_mul(&c, &p->t, &q->t2d);
+	fe8_mul(&r->t, &p->z, &q->z);
+	fe8_add(&r->t, &r->t, &r->t);
+	fe8_add(&plus, &r->t, &c);
+	fe8_sub(&minus, &r->t, &c);
+	fe8_blend(&r->z, sign, &plus, &minus);
+	fe8_blend(&r->t, sign, &minus, &plus);
+}
+
+IFMA_FN void
+ge8_nielsadd2_p1p1(ge8 *r, const ge8 *p, const ge8_niels *q, __mmask8 sign) {
+	fe8 a, b, c, qa, qb, plus, minus;
+	fe8_sub(&a, &p->y, &p->x);
+	fe8_add(&b, &p->y, &p->x);
+	fe8_blend(&qa, sign, &q->ysubx, &q->xaddy);
+	fe8_blend(&qb, sign, &q->xaddy, &q->ysubx);
+	fe8_mul(&a, &a, &qa);
+	fe8_mul(&r->x, &b, &qb);
+	fe8_add(&r->y, &r->x, &a);
+	fe8_sub(&r->x, &r->x, &a);
+	fe8_mul(&c, &p->t, &q->t2d);
+	fe8_add(&r->t, &p->z, &p->z);
+	fe8_add(&plus, &r->t, &c);
+	fe8_sub(&minus, &r->t, &c);
+	fe8_blend(&r->z, sign, &plus, &minus);
+	fe8_blend(&r->t, sign, &minus, &plus);
+}
+
+/* Digits of the fixed window, 8 lanes per window */
+typedef struct ifma_digits_t {
+	int64_t ALIGN(64) d[64][IFMA_LANES];
+} ifma_digits;
+
+/* Splits lane digits in to their sign, zero lanes and the index of their table entry, |digit| - 1 */
+IFMA_FN __m512i
+ifma_digit_index(const ifma_digits *digits, int window, __mmask8 *sign, __mmask8 *zero) {
+	__m512i d = _mm512_load_si512(digits->d[window]);
+	__m512i absd = _mm512_abs_epi64(d);
+	*sign = _mm512_cmplt_epi64_mask(d, _mm512_setzero_si512());
+	*zero = _mm512_cmpeq_epi64_mask(absd, _mm512_setzero_si512());
+	return _mm512_sub_epi64(absd, _mm512_set1_epi64(1));
+}
+
+/* Each lane's own [index + 1]A, the identity for zero lanes */
+IFMA_FN void
+ifma_select_pniels(ge8_pniels *r, const ge8_pniels pre[8], __m512i index, __mmask8 zero, const ge8_pniels *identity) {
+	fe8 *rb = (fe8 *)r;
+	const fe8 *ib = (const fe8 *)identity;
+	int i, k;
+	__mmask8 masks[8];
+	for (k = 1; k < 8; k++)
+		masks[k] = _mm512_cmpeq_epi64_mask(index, _mm512_set1_epi64(k));
+	for (i = 0; i < 4; i++) {
+		for (k = 0; k < 5; k++) {
+			__m512i v = ((const fe8 *)&pre[0])[i].v[k];
+			int e;
+			for (e = 1; e < 8; e++)
+				v = _mm512_mask_blend_epi64(masks[e], v, ((const fe8 *)&pre[e])[i].v[k]);
+			rb[i].v[k] = _mm512_mask_blend_epi64(zero, v, ib[i].v[k]);
+		}
+	}
+}
+
+/* [index + 1]B in every lane, the identity for zero lanes. table holds limb k of entry e in lane e */
+IFMA_FN void
+ifma_select_niels(ge8_niels *r, const ge8_niels *table, __m512i index, __mmask8 zero, const ge8_niels *identity) {
+	fe8 *rb = (fe8 *)r;
+	const fe8 *tb = (const fe8 *)table;
+	const fe8 *ib = (const fe8 *)identity;
+	int i, k;
+	for (i = 0; i < 3; i++)
+		for (k = 0; k < 5; k++)
+			rb[i].v[k] = _mm512_mask_blend_epi64(zero, _mm512_permutexvar_epi64(index, tb[i].v[k]), ib[i].v[k]);
+}
+
+/* ed25519_hram from ed25519.c */
+static void
+ifma_hram(hash_512bits hram, const unsigned char *RS, const unsigned char *pk, const unsigned char *m, size_t mlen) {
+	ed25519_hash_context ctx;
+	ed25519_hash_init(&ctx);
+	ed25519_hash_update(&ctx, RS, 32);
+	ed25519_hash_update(&ctx, pk, 32);
+	ed25519_hash_update(&ctx, m, mlen);
+	ed25519_hash_final(&ctx, hram);
+}
+
+/*
+	Checks IFMA_LANES signatures, setting valid[j] the same as ed25519_sign_open would. Lanes past count repeat lane 0.
+*/
+__attribute__ ((target ("avx512f,avx512ifma"))) static void
+ifma_sign_open_lanes(const unsigned char **m, size_t *mlen, const unsigned char **pk, const unsigned char **RS, size_t count, int *valid) {
+	static const bignum25519 one = {1};
+	static const bignum25519 zero25519 = {0};
+	static const unsigned char zero[32] = {0};
+	bignum25519 ALIGN(16) lanes[4][IFMA_LANES];
+	ifma_digits ALIGN(64) hdigits, sdigits;
+	hash_512bits hash;
+	signed char window[64];
+	bignum256modm scalar;
+	int ok[IFMA_LANES];
+	fe8 ecd, ec2d, fone, num, den, t, d3, x, y;
+	ge8 a, r, sum;
+	ge8_p1p1 p;
+	ge8_pniels pre[8], pselected, pidentity;
+	ge8_niels btable, bselected, bidentity;
+	__mmask8 sign, zeros;
+	__m512i index;
+	size_t j;
+	int i, k;
+
+	fe8_broadcast(&ecd, ge25519_ecd);
+	fe8_broadcast(&ec2d, ge25519_ec2d);
+	fe8_broadcast(&fone, one);
+
+	/* S and H(R,A,m) in signed radix 16, A's y coordinate */
+	for (j = 0; j < IFMA_LANES; j++) {
+		size_t l = (j < count) ? j : 0;
+		ok[j] = !(RS[l][63] & 224);
+		ifma_hram(hash, RS[l], pk[l], m[l], mlen[l]);
+		expand256_modm(scalar, hash, 64);
+		contract256_window4_modm(window, scalar);
+		for (i = 0; i < 64; i++)
+			hdigits.d[i][j] = window[i];
+		expand256_modm(scalar, RS[l] + 32, 32);
+		contract256_window4_modm(window, scalar);
+		for (i = 0; i < 64; i++)
+			sdigits.d[i][j] = window[i];
+		curve25519_expand(lanes[0][j], pk[l]);
+	}
+
+	/* -A, as in ge25519_unpack_negative_vartime. The exponentiation is shared, the checks are done per lane */
+	fe8_load(&y, lanes[0]);
+	fe8_square(&num, &y);
+	fe8_mul(&den, &num, &ecd);
+	fe8_sub(&num, &num, &fone);
+	fe8_add(&den, &den, &fone);
+	fe8_square(&t, &den);
+	fe8_mul(&d3, &t, &den);
+	fe8_square(&x, &d3);
+	fe8_mul(&x, &x, &den);
+	fe8_mul(&x, &x, &num);
+	fe8_pow_two252m3(&x, &x);
+	fe8_mul(&x, &x, &d3);
+	fe8_mul(&x, &x, &num);
+	fe8_square(&t, &x);
+	fe8_mul(&t, &t, &den);
+	fe8_store(lanes[1], &x);
+	fe8_store(lanes[2], &t);
+	fe8_store(lanes[3], &num);
+	for (j = 0; j < IFMA_LANES; j++) {
+		size_t l = (j < count) ? j : 0;
+		unsigned char check[32];
+		bignum25519 root;
+		curve25519_sub_reduce(root, lanes[2][j], lanes[3][j]);
+		curve25519_contract(check, root);
+		if (!ed25519_verify(check, zero, 32)) {
+			curve25519_add_reduce(root, lanes[2][j], lanes[3][j]);
+			curve25519_contract(check, root);
+			if (!ed25519_verify(check, zero, 32))
+				ok[j] = 0;
+			curve25519_mul(lanes[1][j], lanes[1][j], ge25519_sqrtneg1);
+		}
+		curve25519_contract(check, lanes[1][j]);
+		if ((check[0] & 1) == (pk[l][31] >> 7)) {
+			curve25519_copy(root, lanes[1][j]);
+			curve25519_neg(lanes[1][j], root);
+		}
+		if (!ok[j]) {
+			/* Any point keeps the lane's arithmetic defined, its result is ignored */
+			curve25519_copy(lanes[0][j], ge25519_basepoint.y);
+			curve25519_copy(lanes[1][j], ge25519_basepoint.x);
+		}
+	}
+	fe8_load(&a.x, lanes[1]);
+	fe8_load(&a.y, lanes[0]);
+	fe8_copy(&a.z, &fone);
+	fe8_mul(&a.t, &a.x, &a.y);
+
+	/* [1]-A .. [8]-A */
+	ge8_full_to_pniels(&pre[0], &a, &ec2d);
+	sum = a;
+	for (k = 1; k < 8; k++) {
+		ge8_add_p1p1(&p, &sum, &a, &ec2d);
+		ge8_p1p1_to_full(&sum, &p);
+		ge8_full_to_pniels(&pre[k], &sum, &ec2d);
+	}
+	for (i = 0; i < 5; i++) {
+		uint64_t ALIGN(64) limbs[3][IFMA_LANES];
+		for (k = 0; k < 8; k++) {
+			limbs[0][k] = ge25519_niels_base_multiples_1_8[k].ysubx[i];
+			limbs[1][k] = ge25519_niels_base_multiples_1_8[k].xaddy[i];
+			limbs[2][k] = ge25519_niels_base_multiples_1_8[k].t2d[i];
+		}
+		btable.ysubx.v[i] = _mm512_load_si512(limbs[0]);
+		btable.xaddy.v[i] = _mm512_load_si512(limbs[1]);
+		btable.t2d.v[i] = _mm512_load_si512(limbs[2]);
+	}
+	fe8_copy(&pidentity.ysubx, &fone);
+	fe8_copy(&pidentity.xaddy, &fone);
+	fe8_copy(&pidentity.z, &fone);
+	fe8_broadcast(&pidentity.t2d, zero25519);
+	fe8_copy(&bidentity.ysubx, &fone);
+	fe8_copy(&bidentity.xaddy, &fone);
+	fe8_broadcast(&bidentity.t2d, zero25519);
+
+	/* [S]B - [H(R,A,m)]A, 4 bits at a time from the top */
+	fe8_broadcast(&r.x, zero25519);
+	fe8_copy(&r.y, &fone);
+	fe8_copy(&r.z, &fone);
+	fe8_broadcast(&r.t, zero25519);
+	for (i = 63; i >= 0; i--) {
+		if (i != 63) {
+			for (k = 0; k < 3; k++) {
+				ge8_double_p1p1(&p, &r);
+				ge8_p1p1_to_partial(&r, &p);
+			}
+			ge8_double_p1p1(&p, &r);
+			ge8_p1p1_to_full(&r, &p);
+		}
+		index = ifma_digit_index(&hdigits, i, &sign, &zeros);
+		ifma_select_pniels(&pselected, pre, index, zeros, &pidentity);
+		ge8_pnielsadd_p1p1(&p, &r, &pselected, sign);
+		ge8_p1p1_to_full(&r, &p);
+		index = ifma_digit_index(&sdigits, i, &sign, &zeros);
+		ifma_select_niels(&bselected, &btable, index, zeros, &bidentity);
+		ge8_nielsadd2_p1p1(&p, &r, &bselected, sign);
+		ge8_p1p1_to_partial(&r, &p);
+	}
+
+	/* Encode and compare with R, as in ge25519_pack */
+	fe8_recip(&t, &r.z);
+	fe8_mul(&x, &r.x, &t);
+	fe8_mul(&y, &r.y, &t);
+	fe8_store(lanes[0], &x);
+	fe8_store(lanes[1], &y);
+	for (j = 0; j < count; j++) {
+		unsigned char checkR[32], parity[32];
+		curve25519_contract(checkR, lanes[1][j]);
+		curve25519_contract(parity, lanes[0][j]);
+		checkR[31] ^= ((parity[0] & 1) << 7);
+		valid[j] = ok[j] && ed25519_verify(RS[j], checkR, 32);
+	}
+}
+
+/*
+	Same result as ed25519_sign_open_batch. A group of eight costs about two ed25519_sign_open calls, so one or two
+	leftover signatures are checked on their own.
+*/
+int
+ed25519_sign_open_batch_ifma(const unsigned char **m, size_t *mlen, const unsigned char **pk, const unsigned char **RS, size_t num, int *valid) {
+	int ret = 0;
+	size_t i;
+	while (num > 0) {
+		size_t count = (num > IFMA_LANES) ? IFMA_LANES : num;
+		if (count > 2) {
+			ifma_sign_open_lanes(m, mlen, pk, RS, count, valid);
+		} else {
+			for (i = 0; i < count; i++)
+				valid[i] = (ed25519_sign_open(m[i], mlen[i], pk[i], RS[i]) == 0) ? 1 : 0;
+		}
+		for (i = 0; i < count; i++)
+			ret |= (valid[i] ^ 1);
+		m += count;
+		mlen += count;
+		pk += count;
+		RS += count;
+		valid += count;
+		num -= count;
+	}
+	return ret;
+}
+
+#endif